@@ -0,0 +1,262 @@
+/**
+ *	Headless renderer benchmark.
+ *	Renders each scripted scene for a number of frames and prints frame time statistics as JSON.
+ *
+ *	Usage: Benchmark [--frames N] [--warmup N] [--width W] [--height H] [--scene name|all] [--res dir] [--out file|-]
+ *	The JSON goes to benchmark.json by default, or to stdout with --out -
+ *
+ *	On Linux CI without a GPU, run it on Mesa's llvmpipe, e.g. LIBGL_ALWAYS_SOFTWARE=1 ./Benchmark --res OpenGL/res
+ *	Linux build: cmake -S . -B build && cmake --build build, from the root of the repository. This needs
+ *	GLEW and EGL, or OSMesa with -DBENCHMARK_OSMESA=ON.
+ *
+ *	The BenchmarkNull target is built with GL_NULL_BACKEND and runs on the recording NullGL backend
+ *	instead, so frame times measure only the renderer's CPU overhead and the JSON adds GL call counts.
+ */
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+#include "GLState.h"
+#include "GLNamePool.h"
+#include "HeadlessContext.h"
+#include "BenchmarkScenes.h"
+
+#ifdef GL_NULL_BACKEND
+	#include "NullGL.h"
+#endif
+
+/**
+ *	Command line options
+ */
+struct BenchmarkOptions
+{
+	unsigned int Frames = 500;
+	unsigned int WarmupFrames = 20;
+	int Width = 1280;
+	int Height = 720;
+	std::string Scene = "all";
+	std::string ResourceDir = "res";
+	std::string OutputPath = "benchmark.json";
+};
+
+/**
+ *	Results of one scene
+ */
+struct BenchmarkResult
+{
+	std::string Scene;
+	unsigned int Frames;
+	double MeanMs;
+	double P50Ms;
+	double P99Ms;
+	unsigned int DrawCallsPerFrame;
+	unsigned long long TrianglesPerFrame;
+	double TrianglesPerSecond;
+	double GLBindsPerFrame;
+	// Only measured on the null backend
+	double GLCallsPerFrame = 0.0;
+	double StateChangesPerFrame = 0.0;
+	double BytesUploadedPerFrame = 0.0;
+};
+
+static bool ParseOptions(int argc, char** argv, BenchmarkOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Missing value for " << arg << std::endl;
+			return false;
+		}
+		std::string value = argv[++i];
+
+		if (arg == "--frames") options.Frames = (unsigned int)std::atoi(value.c_str());
+		else if (arg == "--warmup") options.WarmupFrames = (unsigned int)std::atoi(value.c_str());
+		else if (arg == "--width") options.Width = std::atoi(value.c_str());
+		else if (arg == "--height") options.Height = std::atoi(value.c_str());
+		else if (arg == "--scene") options.Scene = value;
+		else if (arg == "--res") options.ResourceDir = value;
+		else if (arg == "--out") options.OutputPath = value;
+		else
+		{
+			std::cerr << "Unknown option " << arg << std::endl;
+			return false;
+		}
+	}
+	return options.Frames > 0;
+}
+
+/**
+ *	@return the value below which the given fraction of the sorted samples fall
+ */
+static double Percentile(const std::vector<double>& sorted, double fraction)
+{
+	size_t index = (size_t)(fraction * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+static BenchmarkResult RunScene(BenchmarkScene& scene, Renderer& renderer, const HeadlessContext& context, const BenchmarkOptions& options)
+{
+	for (unsigned int i = 0; i < options.WarmupFrames; i++)
+	{
+		context.BindFramebuffer();
+		renderer.Clear();
+		scene.Render(renderer);
+		GLCall(glFinish());
+	}
+
+	std::vector<double> frameMs(options.Frames);
+	GLState::ResetStats();
+#ifdef GL_NULL_BACKEND
+	NullGL::ResetStats();
+#endif
+	for (unsigned int i = 0; i < options.Frames; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		context.BindFramebuffer();
+		renderer.Clear();
+		scene.Render(renderer);
+		// Wait for the GPU so the frame time covers the work, not just its submission
+		GLCall(glFinish());
+		GLCheckFrameErrors();
+
+		auto end = std::chrono::steady_clock::now();
+		frameMs[i] = std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	BenchmarkResult result;
+	result.Scene = scene.GetName();
+	result.Frames = options.Frames;
+
+	double total = 0.0;
+	for (double ms : frameMs)
+	{
+		total += ms;
+	}
+	result.MeanMs = total / frameMs.size();
+
+	std::sort(frameMs.begin(), frameMs.end());
+	result.P50Ms = Percentile(frameMs, 0.50);
+	result.P99Ms = Percentile(frameMs, 0.99);
+
+	result.DrawCallsPerFrame = scene.GetDrawCalls();
+	result.TrianglesPerFrame = scene.GetTriangles();
+	result.TrianglesPerSecond = (double)result.TrianglesPerFrame * options.Frames / (total / 1000.0);
+	result.GLBindsPerFrame = (double)GLState::GetStats().Misses / options.Frames;
+#ifdef GL_NULL_BACKEND
+	const NullGL::Stats& stats = NullGL::GetStats();
+	result.GLCallsPerFrame = (double)stats.Calls / options.Frames;
+	result.StateChangesPerFrame = (double)stats.StateChanges / options.Frames;
+	result.BytesUploadedPerFrame = (double)stats.BytesUploaded / options.Frames;
+#endif
+	return result;
+}
+
+static std::string ToJson(const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options)
+{
+	std::ostringstream json;
+	json << "{\n";
+	json << "  \"renderer\": \"" << (const char*)glGetString(GL_RENDERER) << "\",\n";
+	json << "  \"version\": \"" << (const char*)glGetString(GL_VERSION) << "\",\n";
+#ifdef GL_NULL_BACKEND
+	json << "  \"backend\": \"null\",\n";
+#else
+	json << "  \"backend\": \"gl\",\n";
+#endif
+	json << "  \"width\": " << options.Width << ",\n";
+	json << "  \"height\": " << options.Height << ",\n";
+	json << "  \"scenes\": [\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& result = results[i];
+		json << "    {\n";
+		json << "      \"scene\": \"" << result.Scene << "\",\n";
+		json << "      \"frames\": " << result.Frames << ",\n";
+		json << "      \"frame_ms_mean\": " << result.MeanMs << ",\n";
+		json << "      \"frame_ms_p50\": " << result.P50Ms << ",\n";
+		json << "      \"frame_ms_p99\": " << result.P99Ms << ",\n";
+		json << "      \"draw_calls_per_frame\": " << result.DrawCallsPerFrame << ",\n";
+		json << "      \"triangles_per_frame\": " << result.TrianglesPerFrame << ",\n";
+		json << "      \"triangles_per_second\": " << result.TrianglesPerSecond << ",\n";
+#ifdef GL_NULL_BACKEND
+		json << "      \"gl_calls_per_frame\": " << result.GLCallsPerFrame << ",\n";
+		json << "      \"state_changes_per_frame\": " << result.StateChangesPerFrame << ",\n";
+		json << "      \"bytes_uploaded_per_frame\": " << result.BytesUploadedPerFrame << ",\n";
+#endif
+		json << "      \"gl_binds_per_frame\": " << result.GLBindsPerFrame << "\n";
+		json << "    }" << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	json << "  ]\n";
+	json << "}\n";
+	return json.str();
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::cerr << "Usage: Benchmark [--frames N] [--warmup N] [--width W] [--height H] [--scene name|all] [--res dir] [--out file|-]" << std::endl;
+		return 1;
+	}
+
+	HeadlessContext context(options.Width, options.Height);
+	if (!context.IsValid())
+	{
+		std::cerr << "Could not create a headless context: " << context.GetError() << std::endl;
+		return 1;
+	}
+	GLInitErrorChecking();
+
+	GLCall(glEnable(GL_BLEND));
+	GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+
+	std::vector<std::string> sceneNames;
+	if (options.Scene == "all")
+	{
+		sceneNames = GetSceneNames();
+	}
+	else
+	{
+		sceneNames.push_back(options.Scene);
+	}
+
+	std::vector<BenchmarkResult> results;
+	{
+		Renderer renderer;
+		for (const std::string& name : sceneNames)
+		{
+			std::unique_ptr<BenchmarkScene> scene = CreateScene(name, options.ResourceDir);
+			if (!scene)
+			{
+				std::cerr << "Unknown scene " << name << std::endl;
+				return 1;
+			}
+			results.push_back(RunScene(*scene, renderer, context, options));
+		}
+	}
+	GLNamePool::Clear();
+
+	std::string json = ToJson(results, options);
+	// The renderer logs to stdout, so JSON only goes there when asked for
+	if (options.OutputPath == "-")
+	{
+		std::cout << json;
+	}
+	else
+	{
+		std::ofstream(options.OutputPath) << json;
+	}
+
+	return 0;
+}
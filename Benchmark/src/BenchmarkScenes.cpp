@@ -0,0 +1,1006 @@
+#include "BenchmarkScenes.h"
+
+#include <GL/glew.h>
+#include <cmath>
+#include <cstdio>
+
+#include "Renderer.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "VertexArray.h"
+#include "VertexBufferLayout.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "BatchRenderer.h"
+#include "BufferArena.h"
+#include "VertexArrayCache.h"
+#include "VertexStreams.h"
+#include "MeshSimplifier.h"
+#include "ObjLoader.h"
+#include "MeshFile.h"
+#include "GltfLoader.h"
+#include "GltfModel.h"
+#include "TextureLoader.h"
+#include "ThreadPool.h"
+
+// The same textured quad as Application.cpp, each line is vertexX, vertexY, textureX, textureY
+static const float s_QuadVertices[] =
+{
+	-0.01f, -0.01f, 0.0f, 0.0f,
+	 0.01f, -0.01f, 1.0f, 0.0f,
+	 0.01f,  0.01f, 1.0f, 1.0f,
+	-0.01f,  0.01f, 0.0f, 1.0f
+};
+
+static const unsigned int s_QuadIndices[] = { 0, 1, 2, 2, 3, 0 };
+
+/**
+ *	One Renderer::Draw and one uniform upload per quad, the cost the other scenes are compared to
+ */
+class DrawScene : public BenchmarkScene
+{
+public:
+	static const unsigned int QuadCount = 1000;
+
+	DrawScene(const std::string& resourceDir)
+		: m_VB(s_QuadVertices, sizeof(s_QuadVertices)), m_IB(s_QuadIndices, 6),
+		m_Shader(resourceDir + "/shaders/Basic.shader"), m_Texture(resourceDir + "/textures/test.png")
+	{
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VA.AddBuffer(m_VB, layout);
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+	}
+
+	const char* GetName() const override { return "draw"; }
+
+	void Render(Renderer& renderer) override
+	{
+		m_Texture.Bind(0);
+		for (unsigned int i = 0; i < QuadCount; i++)
+		{
+			m_Shader.Bind();
+			m_Shader.SetUniform4f("u_Color", (float)i / QuadCount, 0.0f, 1.0f, 1.0f);
+			renderer.Draw(m_VA, m_IB, m_Shader);
+		}
+	}
+
+	unsigned int GetDrawCalls() const override { return QuadCount; }
+
+	unsigned long long GetTriangles() const override { return QuadCount * 2; }
+
+private:
+	VertexArray m_VA;
+	VertexBuffer m_VB;
+	IndexBuffer m_IB;
+	Shader m_Shader;
+	Texture m_Texture;
+};
+
+/**
+ *	The quads of DrawScene as separate meshes placed in two BufferArenas, so the draws differ only
+ *	in their base vertex and index offset and need no buffer or vertex array binds
+ */
+class ArenaScene : public BenchmarkScene
+{
+public:
+	static const unsigned int QuadCount = 1000;
+
+	ArenaScene(const std::string& resourceDir)
+		: m_VertexArena(GL_ARRAY_BUFFER, QuadCount * 2 * sizeof(s_QuadVertices)),
+		m_IndexArena(GL_ELEMENT_ARRAY_BUFFER, QuadCount * 2 * sizeof(s_QuadIndices)),
+		m_Shader(resourceDir + "/shaders/Basic.shader"), m_Texture(resourceDir + "/textures/test.png")
+	{
+		const unsigned int stride = 4 * sizeof(float);
+
+		// Twice as many meshes as drawn, every other one is deleted again to leave the arenas
+		// fragmented, then they are compacted
+		std::vector<VertexBuffer> vertexBuffers;
+		std::vector<IndexBuffer> indexBuffers;
+		for (unsigned int i = 0; i < QuadCount * 2; i++)
+		{
+			vertexBuffers.emplace_back(m_VertexArena, s_QuadVertices, (unsigned int)sizeof(s_QuadVertices), stride);
+			indexBuffers.emplace_back(m_IndexArena, s_QuadIndices, 6);
+		}
+		for (unsigned int i = 0; i < QuadCount * 2; i += 2)
+		{
+			m_VertexBuffers.push_back(std::move(vertexBuffers[i]));
+			m_IndexBuffers.push_back(std::move(indexBuffers[i]));
+		}
+		vertexBuffers.clear();
+		indexBuffers.clear();
+		m_VertexArena.Defragment();
+		m_IndexArena.Defragment();
+
+		// The attributes start at the beginning of the arena, each mesh is reached by its base vertex
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VA.AddBuffer(m_VertexBuffers[0], layout);
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+	}
+
+	const char* GetName() const override { return "arena"; }
+
+	void Render(Renderer& renderer) override
+	{
+		m_Texture.Bind(0);
+		for (unsigned int i = 0; i < QuadCount; i++)
+		{
+			m_Shader.SetUniform4f("u_Color", (float)i / QuadCount, 0.0f, 1.0f, 1.0f);
+			renderer.Draw(m_VA, m_VertexBuffers[i], m_IndexBuffers[i], m_Shader);
+		}
+	}
+
+	unsigned int GetDrawCalls() const override { return QuadCount; }
+
+	unsigned long long GetTriangles() const override { return QuadCount * 2; }
+
+private:
+	BufferArena m_VertexArena;
+	BufferArena m_IndexArena;
+	// Stored by value, each is only a view into an arena
+	std::vector<VertexBuffer> m_VertexBuffers;
+	std::vector<IndexBuffer> m_IndexBuffers;
+	VertexArray m_VA;
+	Shader m_Shader;
+	Texture m_Texture;
+};
+
+/**
+ *	A grid of quads in one Dynamic VertexBuffer, where every frame one row moves. The row is written quad
+ *	by quad with SetSubData and uploaded by a single Flush.
+ */
+class DynamicScene : public BenchmarkScene
+{
+public:
+	static const unsigned int GridSize = 100;
+
+	DynamicScene(const std::string& resourceDir)
+		: m_Shader(resourceDir + "/shaders/Basic.shader"), m_Texture(resourceDir + "/textures/test.png"), m_Frame(0)
+	{
+		std::vector<float> vertices(GridSize * GridSize * 16);
+		std::vector<unsigned int> indices(GridSize * GridSize * 6);
+		for (unsigned int i = 0; i < GridSize * GridSize; i++)
+		{
+			WriteQuad(i, 0.0f, &vertices[i * 16]);
+			for (unsigned int j = 0; j < 6; j++)
+			{
+				indices[i * 6 + j] = i * 4 + s_QuadIndices[j];
+			}
+		}
+		m_VB = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(float)), BufferUsage::Dynamic);
+		m_IB = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VA.AddBuffer(*m_VB, layout);
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+		m_Shader.SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+	}
+
+	const char* GetName() const override { return "dynamic"; }
+
+	void Render(Renderer& renderer) override
+	{
+		unsigned int row = m_Frame % GridSize;
+		float lift = (float)(m_Frame / GridSize % 2) * 0.005f;
+		for (unsigned int x = 0; x < GridSize; x++)
+		{
+			float quad[16];
+			unsigned int index = row * GridSize + x;
+			WriteQuad(index, lift, quad);
+			m_VB->SetSubData(quad, sizeof(quad), index * sizeof(quad));
+		}
+		m_VB->Flush();
+		m_Frame++;
+
+		m_Texture.Bind(0);
+		renderer.Draw(m_VA, *m_VB, *m_IB, m_Shader);
+	}
+
+	unsigned int GetDrawCalls() const override { return 1; }
+
+	unsigned long long GetTriangles() const override { return GridSize * GridSize * 2; }
+
+private:
+	VertexArray m_VA;
+	std::unique_ptr<VertexBuffer> m_VB;
+	std::unique_ptr<IndexBuffer> m_IB;
+	Shader m_Shader;
+	Texture m_Texture;
+	unsigned int m_Frame;
+
+	/**
+	 *	Writes the four vertices of one grid cell, moved up by lift
+	 */
+	static void WriteQuad(unsigned int index, float lift, float* vertices)
+	{
+		const float size = 2.0f / GridSize;
+		float x = -1.0f + (index % GridSize) * size;
+		float y = -1.0f + (index / GridSize) * size + lift;
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			vertices[i * 4 + 0] = x + (s_QuadVertices[i * 4 + 0] > 0.0f ? size : 0.0f);
+			vertices[i * 4 + 1] = y + (s_QuadVertices[i * 4 + 1] > 0.0f ? size : 0.0f);
+			vertices[i * 4 + 2] = s_QuadVertices[i * 4 + 2];
+			vertices[i * 4 + 3] = s_QuadVertices[i * 4 + 3];
+		}
+	}
+};
+
+/**
+ *	100k textured quads through the BatchRenderer, alternating between two textures
+ */
+class BatchScene : public BenchmarkScene
+{
+public:
+	static const unsigned int GridSize = 320;
+
+	BatchScene(const std::string& resourceDir)
+		: m_Shader(resourceDir + "/shaders/Batch.shader"),
+		m_TextureA(resourceDir + "/textures/test.png"), m_TextureB(resourceDir + "/textures/ciaran.png")
+	{
+	}
+
+	const char* GetName() const override { return "batch"; }
+
+	void Render(Renderer& renderer) override
+	{
+		const float size = 2.0f / GridSize;
+
+		m_Batch.ResetStats();
+		m_Batch.Begin(m_Shader);
+		for (unsigned int y = 0; y < GridSize; y++)
+		{
+			for (unsigned int x = 0; x < GridSize; x++)
+			{
+				const Texture& texture = (x + y) % 2 ? m_TextureA : m_TextureB;
+				m_Batch.DrawQuad(-1.0f + x * size, -1.0f + y * size, size, size, texture);
+			}
+		}
+		m_Batch.End();
+	}
+
+	unsigned int GetDrawCalls() const override { return m_Batch.GetStats().DrawCount; }
+
+	unsigned long long GetTriangles() const override { return (unsigned long long)m_Batch.GetStats().QuadCount * 2; }
+
+private:
+	BatchRenderer m_Batch;
+	Shader m_Shader;
+	Texture m_TextureA;
+	Texture m_TextureB;
+};
+
+/**
+ *	100k quads from one Renderer::DrawInstanced with a per-instance offset and colour
+ */
+class InstancedScene : public BenchmarkScene
+{
+public:
+	static const unsigned int GridSize = 320;
+
+	/**
+	 *	Per instance data, matching the instance attributes of Instanced.shader
+	 */
+	struct Instance
+	{
+		float Offset[2];
+		float Color[4];
+	};
+
+	InstancedScene(const std::string& resourceDir)
+		: m_VB(s_QuadVertices, sizeof(s_QuadVertices)), m_IB(s_QuadIndices, 6),
+		m_Shader(resourceDir + "/shaders/Instanced.shader"), m_Texture(resourceDir + "/textures/test.png")
+	{
+		std::vector<Instance> instances(GridSize * GridSize);
+		const float size = 2.0f / GridSize;
+		for (unsigned int i = 0; i < instances.size(); i++)
+		{
+			instances[i].Offset[0] = -1.0f + (i % GridSize) * size;
+			instances[i].Offset[1] = -1.0f + (i / GridSize) * size;
+			instances[i].Color[0] = 1.0f;
+			instances[i].Color[1] = (float)(i % GridSize) / GridSize;
+			instances[i].Color[2] = (float)(i / GridSize) / GridSize;
+			instances[i].Color[3] = 1.0f;
+		}
+		m_InstanceVB = std::make_unique<VertexBuffer>(instances.data(), (unsigned int)(instances.size() * sizeof(Instance)));
+
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VA.AddBuffer(m_VB, layout);
+
+		VertexBufferLayout instanceLayout;
+		instanceLayout.Push<float>(2);
+		instanceLayout.Push<float>(4);
+		instanceLayout.SetDivisor(1);
+		m_VA.AddBuffer(*m_InstanceVB, instanceLayout);
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+	}
+
+	const char* GetName() const override { return "instanced"; }
+
+	void Render(Renderer& renderer) override
+	{
+		m_Texture.Bind(0);
+		renderer.DrawInstanced(m_VA, m_IB, m_Shader, GridSize * GridSize);
+	}
+
+	unsigned int GetDrawCalls() const override { return 1; }
+
+	unsigned long long GetTriangles() const override { return (unsigned long long)GridSize * GridSize * 2; }
+
+private:
+	VertexArray m_VA;
+	VertexBuffer m_VB;
+	std::unique_ptr<VertexBuffer> m_InstanceVB;
+	IndexBuffer m_IB;
+	Shader m_Shader;
+	Texture m_Texture;
+};
+
+/**
+ *	The quads of DrawScene as separate meshes, each with buffers of its own as if streamed in one by one.
+ *	They are drawn through a VertexArrayCache, which shares one vertex array between all of them when
+ *	the context has separate attribute formats, instead of one VertexArray per mesh.
+ */
+class VertexArrayCacheScene : public BenchmarkScene
+{
+public:
+	static const unsigned int QuadCount = 1000;
+
+	VertexArrayCacheScene(const std::string& resourceDir)
+		: m_Shader(resourceDir + "/shaders/Basic.shader"), m_Texture(resourceDir + "/textures/test.png")
+	{
+		m_Layout.Push<float>(2);
+		m_Layout.Push<float>(2);
+
+		m_VertexBuffers.reserve(QuadCount);
+		m_IndexBuffers.reserve(QuadCount);
+		for (unsigned int i = 0; i < QuadCount; i++)
+		{
+			m_VertexBuffers.emplace_back(s_QuadVertices, (unsigned int)sizeof(s_QuadVertices));
+			m_IndexBuffers.emplace_back(s_QuadIndices, 6);
+		}
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+	}
+
+	const char* GetName() const override { return "vaocache"; }
+
+	void Render(Renderer& renderer) override
+	{
+		m_Texture.Bind(0);
+		for (unsigned int i = 0; i < QuadCount; i++)
+		{
+			const VertexArray& va = m_Cache.Bind(m_VertexBuffers[i], m_Layout, &m_IndexBuffers[i]);
+			m_Shader.SetUniform4f("u_Color", (float)i / QuadCount, 0.0f, 1.0f, 1.0f);
+			renderer.Draw(va, m_IndexBuffers[i], m_Shader);
+		}
+	}
+
+	unsigned int GetDrawCalls() const override { return QuadCount; }
+
+	unsigned long long GetTriangles() const override { return QuadCount * 2; }
+
+private:
+	VertexBufferLayout m_Layout;
+	std::vector<VertexBuffer> m_VertexBuffers;
+	std::vector<IndexBuffer> m_IndexBuffers;
+	VertexArrayCache m_Cache;
+	Shader m_Shader;
+	Texture m_Texture;
+};
+
+/**
+ *	A row of quads with positions and texture coordinates in separate buffers. Each frame draws them
+ *	once from the positions alone, as a depth pre-pass would, and once from both streams.
+ */
+class StreamsScene : public BenchmarkScene
+{
+public:
+	static const unsigned int QuadCount = 1000;
+
+	StreamsScene(const std::string& resourceDir)
+		: m_Shader(resourceDir + "/shaders/Basic.shader"), m_Texture(resourceDir + "/textures/test.png")
+	{
+		std::vector<float> vertices(QuadCount * 16);
+		std::vector<unsigned int> indices(QuadCount * 6);
+		for (unsigned int i = 0; i < QuadCount; i++)
+		{
+			for (unsigned int j = 0; j < 16; j++)
+			{
+				vertices[i * 16 + j] = s_QuadVertices[j];
+			}
+			for (unsigned int corner = 0; corner < 4; corner++)
+			{
+				vertices[i * 16 + corner * 4] += (float)(i % 90) * 0.02f - 0.9f;
+				vertices[i * 16 + corner * 4 + 1] += (float)(i / 90) * 0.02f - 0.9f;
+			}
+			for (unsigned int j = 0; j < 6; j++)
+			{
+				indices[i * 6 + j] = i * 4 + s_QuadIndices[j];
+			}
+		}
+
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		std::vector<VertexStreamData> streams = VertexStreams::Deinterleave(vertices.data(), QuadCount * 4, layout);
+
+		m_Positions = std::make_unique<VertexBuffer>(streams[0].Data.data(), (unsigned int)streams[0].Data.size());
+		m_TexCoords = std::make_unique<VertexBuffer>(streams[1].Data.data(), (unsigned int)streams[1].Data.size());
+		m_IB = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+
+		m_DepthVA.AddBuffer(*m_Positions, streams[0].Layout);
+
+		m_VA.AddBuffer(*m_Positions, streams[0].Layout);
+		m_VA.SetNextAttribute(1);
+		m_VA.AddBuffer(*m_TexCoords, streams[1].Layout);
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+		m_Shader.SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+	}
+
+	const char* GetName() const override { return "streams"; }
+
+	void Render(Renderer& renderer) override
+	{
+		m_Texture.Bind(0);
+		renderer.Draw(m_DepthVA, *m_IB, m_Shader);
+		renderer.Draw(m_VA, *m_IB, m_Shader);
+	}
+
+	unsigned int GetDrawCalls() const override { return 2; }
+
+	unsigned long long GetTriangles() const override { return QuadCount * 4; }
+
+private:
+	std::unique_ptr<VertexBuffer> m_Positions;
+	std::unique_ptr<VertexBuffer> m_TexCoords;
+	std::unique_ptr<IndexBuffer> m_IB;
+	VertexArray m_DepthVA;
+	VertexArray m_VA;
+	Shader m_Shader;
+	Texture m_Texture;
+};
+
+/**
+ *	A wavy grid drawn as many objects at increasing distances, each at the level of detail Renderer::SelectLod
+ *	picks for a 720 pixel high view with a 60 degree field of view
+ */
+class LodScene : public BenchmarkScene
+{
+public:
+	static const unsigned int GridSize = 256;
+	static const unsigned int ObjectCount = 64;
+
+	LodScene(const std::string& resourceDir)
+		: m_Shader(resourceDir + "/shaders/Basic.shader"), m_Texture(resourceDir + "/textures/test.png"), m_Triangles(0)
+	{
+		// x, y, z, u, v
+		std::vector<float> vertices;
+		for (unsigned int y = 0; y <= GridSize; y++)
+		{
+			for (unsigned int x = 0; x <= GridSize; x++)
+			{
+				float u = (float)x / GridSize;
+				float v = (float)y / GridSize;
+				vertices.insert(vertices.end(), { u - 0.5f, v - 0.5f, 0.05f * std::sin(u * 12.0f) * std::cos(v * 9.0f), u, v });
+			}
+		}
+		std::vector<unsigned int> indices;
+		for (unsigned int y = 0; y < GridSize; y++)
+		{
+			for (unsigned int x = 0; x < GridSize; x++)
+			{
+				unsigned int corner = y * (GridSize + 1) + x;
+				indices.insert(indices.end(), { corner, corner + 1, corner + GridSize + 2, corner + GridSize + 2, corner + GridSize + 1, corner });
+			}
+		}
+
+		SimplifyAttributes uvs;
+		uvs.Data = &vertices[3];
+		uvs.Stride = 5 * sizeof(float);
+		uvs.Count = 2;
+		std::vector<unsigned int> lodIndices;
+		unsigned int vertexCount = (unsigned int)vertices.size() / 5;
+		m_Lods = MeshSimplifier::BuildLods(lodIndices, indices.data(), (unsigned int)indices.size(), vertices.data(), vertexCount,
+			5 * sizeof(float), 8, 0.5f, 0.05f, uvs);
+
+		m_VB = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(float)));
+		m_IB = std::make_unique<IndexBuffer>(lodIndices.data(), (unsigned int)lodIndices.size());
+
+		VertexBufferLayout layout;
+		layout.Push<float>(3);
+		layout.Push<float>(2);
+		m_VA.AddBuffer(*m_VB, layout);
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+		m_Shader.SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+	}
+
+	const char* GetName() const override { return "lod"; }
+
+	void Render(Renderer& renderer) override
+	{
+		const float projectionScale = 720.0f / (2.0f * std::tan(30.0f * 3.14159265f / 180.0f));
+
+		m_Texture.Bind(0);
+		m_Triangles = 0;
+		for (unsigned int i = 0; i < ObjectCount; i++)
+		{
+			float distance = 1.0f + i * 0.5f;
+			const MeshLod& lod = m_Lods[Renderer::SelectLod(m_Lods, 1.0f, distance, projectionScale)];
+			renderer.DrawLod(m_VA, *m_IB, lod, m_Shader);
+			m_Triangles += lod.IndexCount / 3;
+		}
+	}
+
+	unsigned int GetDrawCalls() const override { return ObjectCount; }
+
+	unsigned long long GetTriangles() const override { return m_Triangles; }
+
+private:
+	std::unique_ptr<VertexBuffer> m_VB;
+	std::unique_ptr<IndexBuffer> m_IB;
+	std::vector<MeshLod> m_Lods;
+	VertexArray m_VA;
+	Shader m_Shader;
+	Texture m_Texture;
+	unsigned long long m_Triangles;
+};
+
+/**
+ *	Loads a million triangle OBJ file with ObjLoader every frame, uploads it and draws it, so the frame time
+ *	is the time to get a mesh from disk onto the GPU. The file is written once, by the constructor.
+ *	Not part of "all", run it alone with a few frames, e.g. --scene objload --frames 10 --warmup 1
+ */
+class ObjLoadScene : public BenchmarkScene
+{
+public:
+	// Quads per side, 708 x 708 x 2 is just over a million triangles
+	static const unsigned int GridSize = 708;
+
+	ObjLoadScene(const std::string& resourceDir)
+		: m_Path("benchmark_objload.obj"), m_Shader(resourceDir + "/shaders/Basic.shader"),
+		m_Texture(resourceDir + "/textures/test.png"), m_Triangles(0)
+	{
+		FILE* file = std::fopen(m_Path.c_str(), "wb");
+		if (file)
+		{
+			for (unsigned int y = 0; y <= GridSize; y++)
+			{
+				for (unsigned int x = 0; x <= GridSize; x++)
+				{
+					float u = (float)x / GridSize;
+					float v = (float)y / GridSize;
+					std::fprintf(file, "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn 0 0 1\n", u * 1.8f - 0.9f, v * 1.8f - 0.9f,
+						0.05f * std::sin(u * 12.0f), u, v);
+				}
+			}
+			for (unsigned int y = 0; y < GridSize; y++)
+			{
+				for (unsigned int x = 0; x < GridSize; x++)
+				{
+					unsigned int corner = y * (GridSize + 1) + x + 1;
+					unsigned int corners[4] = { corner, corner + 1, corner + GridSize + 2, corner + GridSize + 1 };
+					std::fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n", corners[0], corners[0], corners[0],
+						corners[1], corners[1], corners[1], corners[2], corners[2], corners[2], corners[3], corners[3], corners[3]);
+				}
+			}
+			std::fclose(file);
+		}
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+		m_Shader.SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+	}
+
+	~ObjLoadScene()
+	{
+		std::remove(m_Path.c_str());
+	}
+
+	const char* GetName() const override { return "objload"; }
+
+	void Render(Renderer& renderer) override
+	{
+		ObjMesh mesh;
+		if (!ObjLoader::Load(m_Path, mesh, &m_Pool))
+		{
+			m_Triangles = 0;
+			return;
+		}
+
+		m_VA = std::make_unique<VertexArray>();
+		m_VB = std::make_unique<VertexBuffer>(mesh.Vertices.data(), (unsigned int)(mesh.Vertices.size() * sizeof(float)));
+		m_IB = std::make_unique<IndexBuffer>(mesh.Indices.data(), (unsigned int)mesh.Indices.size());
+		m_VA->AddBuffer(*m_VB, mesh.Layout);
+
+		m_Texture.Bind(0);
+		renderer.Draw(*m_VA, *m_IB, m_Shader);
+		m_Triangles = mesh.Indices.size() / 3;
+	}
+
+	unsigned int GetDrawCalls() const override { return 1; }
+
+	unsigned long long GetTriangles() const override { return m_Triangles; }
+
+private:
+	std::string m_Path;
+	ThreadPool m_Pool;
+	std::unique_ptr<VertexArray> m_VA;
+	std::unique_ptr<VertexBuffer> m_VB;
+	std::unique_ptr<IndexBuffer> m_IB;
+	Shader m_Shader;
+	Texture m_Texture;
+	unsigned long long m_Triangles;
+};
+
+/**
+ *	The mesh of ObjLoadScene as a .mesh file, mapped and uploaded every frame. Compared with objload this is
+ *	the time saved by converting meshes ahead of time, what is left is mostly the upload.
+ *	Not part of "all", run it alone with a few frames, e.g. --scene meshload --frames 10 --warmup 1
+ */
+class MeshLoadScene : public BenchmarkScene
+{
+public:
+	static const unsigned int GridSize = ObjLoadScene::GridSize;
+
+	MeshLoadScene(const std::string& resourceDir)
+		: m_Path("benchmark_meshload.mesh"), m_Shader(resourceDir + "/shaders/Basic.shader"),
+		m_Texture(resourceDir + "/textures/test.png"), m_Triangles(0)
+	{
+		// x, y, z, u, v, normal x, y, z
+		std::vector<float> vertices;
+		for (unsigned int y = 0; y <= GridSize; y++)
+		{
+			for (unsigned int x = 0; x <= GridSize; x++)
+			{
+				float u = (float)x / GridSize;
+				float v = (float)y / GridSize;
+				vertices.insert(vertices.end(), { u * 1.8f - 0.9f, v * 1.8f - 0.9f, 0.05f * std::sin(u * 12.0f), u, v, 0.0f, 0.0f, 1.0f });
+			}
+		}
+		std::vector<unsigned int> indices;
+		for (unsigned int y = 0; y < GridSize; y++)
+		{
+			for (unsigned int x = 0; x < GridSize; x++)
+			{
+				unsigned int corner = y * (GridSize + 1) + x;
+				indices.insert(indices.end(), { corner, corner + 1, corner + GridSize + 2, corner, corner + GridSize + 2, corner + GridSize + 1 });
+			}
+		}
+
+		VertexBufferLayout layout;
+		layout.Push<float>(3);
+		layout.Push<float>(2);
+		layout.Push<float>(3);
+		MeshFile::Write(m_Path, vertices.data(), (unsigned int)vertices.size() / 8, layout, indices.data(), (unsigned int)indices.size());
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+		m_Shader.SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+	}
+
+	~MeshLoadScene()
+	{
+		std::remove(m_Path.c_str());
+	}
+
+	const char* GetName() const override { return "meshload"; }
+
+	void Render(Renderer& renderer) override
+	{
+		MeshFile file(m_Path);
+		if (!file.IsOpen())
+		{
+			m_Triangles = 0;
+			return;
+		}
+
+		m_VA = std::make_unique<VertexArray>();
+		m_VB = std::make_unique<VertexBuffer>(file.CreateVertexBuffer());
+		m_IB = std::make_unique<IndexBuffer>(file.CreateIndexBuffer());
+		m_VA->AddBuffer(*m_VB, file.GetLayout());
+
+		m_Texture.Bind(0);
+		renderer.Draw(*m_VA, *m_IB, m_Shader);
+		m_Triangles = file.GetIndexCount() / 3;
+	}
+
+	unsigned int GetDrawCalls() const override { return 1; }
+
+	unsigned long long GetTriangles() const override { return m_Triangles; }
+
+private:
+	std::string m_Path;
+	std::unique_ptr<VertexArray> m_VA;
+	std::unique_ptr<VertexBuffer> m_VB;
+	std::unique_ptr<IndexBuffer> m_IB;
+	Shader m_Shader;
+	Texture m_Texture;
+	unsigned long long m_Triangles;
+};
+
+/**
+ *	The mesh of ObjLoadScene as a binary glTF file, with interleaved positions and texture coordinates and
+ *	both test textures embedded as PNGs. Every frame loads it with GltfLoader, decoding the images on a
+ *	ThreadPool, uploads it with GltfModel and draws every node with a mesh.
+ *	Not part of "all", run it alone with a few frames, e.g. --scene gltfload --frames 10 --warmup 1
+ */
+class GltfLoadScene : public BenchmarkScene
+{
+public:
+	static const unsigned int GridSize = ObjLoadScene::GridSize;
+
+	GltfLoadScene(const std::string& resourceDir)
+		: m_Path("benchmark_gltfload.glb"), m_Shader(resourceDir + "/shaders/Basic.shader"), m_DrawCalls(0), m_Triangles(0)
+	{
+		// x, y, z, u, v
+		std::vector<float> vertices;
+		for (unsigned int y = 0; y <= GridSize; y++)
+		{
+			for (unsigned int x = 0; x <= GridSize; x++)
+			{
+				float u = (float)x / GridSize;
+				float v = (float)y / GridSize;
+				vertices.insert(vertices.end(), { u * 1.8f - 0.9f, v * 1.8f - 0.9f, 0.05f * std::sin(u * 12.0f), u, v });
+			}
+		}
+		std::vector<unsigned int> indices;
+		for (unsigned int y = 0; y < GridSize; y++)
+		{
+			for (unsigned int x = 0; x < GridSize; x++)
+			{
+				unsigned int corner = y * (GridSize + 1) + x;
+				indices.insert(indices.end(), { corner, corner + 1, corner + GridSize + 2, corner, corner + GridSize + 2, corner + GridSize + 1 });
+			}
+		}
+
+		// The binary chunk holds the vertices, the indices and the two images, each 4 byte aligned
+		std::vector<unsigned char> binary;
+		auto append = [&binary](const void* data, size_t size)
+		{
+			size_t offset = binary.size();
+			binary.insert(binary.end(), (const unsigned char*)data, (const unsigned char*)data + size);
+			binary.resize((binary.size() + 3) & ~(size_t)3);
+			return offset;
+		};
+		size_t vertexSize = vertices.size() * sizeof(float);
+		size_t indexSize = indices.size() * sizeof(unsigned int);
+		size_t vertexOffset = append(vertices.data(), vertexSize);
+		size_t indexOffset = append(indices.data(), indexSize);
+
+		std::string views = "{\"buffer\":0,\"byteOffset\":" + std::to_string(vertexOffset) + ",\"byteLength\":" + std::to_string(vertexSize) +
+			",\"byteStride\":20},{\"buffer\":0,\"byteOffset\":" + std::to_string(indexOffset) + ",\"byteLength\":" + std::to_string(indexSize) + "}";
+		const char* images[] = { "/textures/test.png", "/textures/ciaran.png" };
+		for (const char* image : images)
+		{
+			std::vector<unsigned char> png;
+			FILE* file = std::fopen((resourceDir + image).c_str(), "rb");
+			if (file)
+			{
+				unsigned char block[4096];
+				size_t read;
+				while ((read = std::fread(block, 1, sizeof(block), file)) > 0)
+				{
+					png.insert(png.end(), block, block + read);
+				}
+				std::fclose(file);
+			}
+			size_t offset = append(png.data(), png.size());
+			views += ",{\"buffer\":0,\"byteOffset\":" + std::to_string(offset) + ",\"byteLength\":" + std::to_string(png.size()) + "}";
+		}
+
+		std::string json = "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+			"\"nodes\":[{\"children\":[1,2]},{\"mesh\":0,\"translation\":[-0.5,0,0]},{\"mesh\":1,\"translation\":[0.5,0,0]}],"
+			"\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"TEXCOORD_0\":1},\"indices\":2,\"material\":0}]},"
+			"{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"TEXCOORD_0\":1},\"indices\":2,\"material\":1}]}],"
+			"\"materials\":[{\"pbrMetallicRoughness\":{\"baseColorTexture\":{\"index\":0}}},{\"pbrMetallicRoughness\":{\"baseColorTexture\":{\"index\":1}}}],"
+			"\"textures\":[{\"source\":0},{\"source\":1}],"
+			"\"images\":[{\"bufferView\":2,\"mimeType\":\"image/png\"},{\"bufferView\":3,\"mimeType\":\"image/png\"}],"
+			"\"accessors\":[{\"bufferView\":0,\"componentType\":5126,\"count\":" + std::to_string(vertices.size() / 5) + ",\"type\":\"VEC3\"},"
+			"{\"bufferView\":0,\"byteOffset\":12,\"componentType\":5126,\"count\":" + std::to_string(vertices.size() / 5) + ",\"type\":\"VEC2\"},"
+			"{\"bufferView\":1,\"componentType\":5125,\"count\":" + std::to_string(indices.size()) + ",\"type\":\"SCALAR\"}],"
+			"\"bufferViews\":[" + views + "],\"buffers\":[{\"byteLength\":" + std::to_string(binary.size()) + "}]}";
+		json.resize((json.size() + 3) & ~(size_t)3, ' ');
+
+		unsigned int header[5] = { 0x46546C67, 2, (unsigned int)(12 + 8 + json.size() + 8 + binary.size()), (unsigned int)json.size(), 0x4E4F534A };
+		unsigned int binaryHeader[2] = { (unsigned int)binary.size(), 0x004E4942 };
+		FILE* file = std::fopen(m_Path.c_str(), "wb");
+		if (file)
+		{
+			std::fwrite(header, sizeof(header), 1, file);
+			std::fwrite(json.data(), 1, json.size(), file);
+			std::fwrite(binaryHeader, sizeof(binaryHeader), 1, file);
+			std::fwrite(binary.data(), 1, binary.size(), file);
+			std::fclose(file);
+		}
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+		m_Shader.SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+	}
+
+	~GltfLoadScene()
+	{
+		std::remove(m_Path.c_str());
+	}
+
+	const char* GetName() const override { return "gltfload"; }
+
+	void Render(Renderer& renderer) override
+	{
+		m_DrawCalls = 0;
+		m_Triangles = 0;
+
+		GltfAsset asset;
+		if (!GltfLoader::Load(m_Path, asset, &m_Pool))
+		{
+			return;
+		}
+		m_Model = std::make_unique<GltfModel>(asset);
+
+		for (const GltfNode& node : asset.Nodes)
+		{
+			if (node.Mesh < 0)
+			{
+				continue;
+			}
+			// Basic.shader has no transform, so the node's World matrix is not used
+			m_Model->DrawMesh(renderer, node.Mesh, m_Shader);
+			for (const GltfPrimitive& primitive : asset.Meshes[node.Mesh].Primitives)
+			{
+				m_DrawCalls++;
+				m_Triangles += asset.Accessors[primitive.Indices].Count / 3;
+			}
+		}
+	}
+
+	unsigned int GetDrawCalls() const override { return m_DrawCalls; }
+
+	unsigned long long GetTriangles() const override { return m_Triangles; }
+
+private:
+	std::string m_Path;
+	ThreadPool m_Pool;
+	std::unique_ptr<GltfModel> m_Model;
+	Shader m_Shader;
+	unsigned int m_DrawCalls;
+	unsigned long long m_Triangles;
+};
+
+/**
+ *	Streams TextureCount textures in with a TextureLoader while drawing a quad with each of them, loading
+ *	the whole set again once it is resident, so every frame has decodes and uploads in flight. The frame
+ *	time should stay flat, the uploads are capped by the loader's budget and decoding is on the pool.
+ *	Not part of "all", as its frame times depend on the disk and the number of cores.
+ */
+class TextureLoadScene : public BenchmarkScene
+{
+public:
+	static const unsigned int TextureCount = 256;
+
+	TextureLoadScene(const std::string& resourceDir)
+		: m_ResourceDir(resourceDir), m_VB(s_QuadVertices, sizeof(s_QuadVertices)), m_IB(s_QuadIndices, 6),
+		m_Shader(resourceDir + "/shaders/Basic.shader")
+	{
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VA.AddBuffer(m_VB, layout);
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+		m_Shader.SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+	}
+
+	const char* GetName() const override { return "textureload"; }
+
+	void Render(Renderer& renderer) override
+	{
+		if (!m_Loader || m_Loader->GetPendingCount() == 0)
+		{
+			m_Loader = std::make_unique<TextureLoader>(m_Pool);
+			for (unsigned int i = 0; i < TextureCount; i++)
+			{
+				m_Loader->Load(m_ResourceDir + (i % 2 ? "/textures/ciaran.png" : "/textures/test.png"));
+			}
+		}
+		m_Loader->Update();
+
+		for (unsigned int i = 0; i < TextureCount; i++)
+		{
+			m_Loader->Bind(i, 0);
+			renderer.Draw(m_VA, m_IB, m_Shader);
+		}
+	}
+
+	unsigned int GetDrawCalls() const override { return TextureCount; }
+
+	unsigned long long GetTriangles() const override { return TextureCount * 2; }
+
+private:
+	std::string m_ResourceDir;
+	ThreadPool m_Pool;
+	std::unique_ptr<TextureLoader> m_Loader;
+	VertexArray m_VA;
+	VertexBuffer m_VB;
+	IndexBuffer m_IB;
+	Shader m_Shader;
+};
+
+std::vector<std::string> GetSceneNames()
+{
+	return { "draw", "arena", "dynamic", "batch", "instanced", "vaocache", "streams", "lod" };
+}
+
+std::unique_ptr<BenchmarkScene> CreateScene(const std::string & name, const std::string & resourceDir)
+{
+	if (name == "draw")
+	{
+		return std::make_unique<DrawScene>(resourceDir);
+	}
+	if (name == "arena")
+	{
+		return std::make_unique<ArenaScene>(resourceDir);
+	}
+	if (name == "dynamic")
+	{
+		return std::make_unique<DynamicScene>(resourceDir);
+	}
+	if (name == "batch")
+	{
+		return std::make_unique<BatchScene>(resourceDir);
+	}
+	if (name == "instanced")
+	{
+		return std::make_unique<InstancedScene>(resourceDir);
+	}
+	if (name == "vaocache")
+	{
+		return std::make_unique<VertexArrayCacheScene>(resourceDir);
+	}
+	if (name == "streams")
+	{
+		return std::make_unique<StreamsScene>(resourceDir);
+	}
+	if (name == "lod")
+	{
+		return std::make_unique<LodScene>(resourceDir);
+	}
+	if (name == "objload")
+	{
+		return std::make_unique<ObjLoadScene>(resourceDir);
+	}
+	if (name == "meshload")
+	{
+		return std::make_unique<MeshLoadScene>(resourceDir);
+	}
+	if (name == "gltfload")
+	{
+		return std::make_unique<GltfLoadScene>(resourceDir);
+	}
+	if (name == "textureload")
+	{
+		return std::make_unique<TextureLoadScene>(resourceDir);
+	}
+	return nullptr;
+}
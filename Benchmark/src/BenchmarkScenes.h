@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class Renderer;
+
+/**
+ *	A scripted scene drawn once per benchmark frame
+ */
+class BenchmarkScene
+{
+public:
+	virtual ~BenchmarkScene() {}
+
+	virtual const char* GetName() const = 0;
+
+	/**
+	 *	Draws one frame
+	 */
+	virtual void Render(Renderer& renderer) = 0;
+
+	/**
+	 *	@return draw calls issued by the last Render
+	 */
+	virtual unsigned int GetDrawCalls() const = 0;
+
+	/**
+	 *	@return triangles drawn by the last Render
+	 */
+	virtual unsigned long long GetTriangles() const = 0;
+};
+
+/**
+ *	@return the scenes run by "all". CreateScene also takes "objload", "meshload" and "gltfload",
+ *	which load a large file every frame, and "textureload", which streams textures in.
+ */
+std::vector<std::string> GetSceneNames();
+
+/**
+ *	Builds a scene from its VertexArrays, IndexBuffers, Shaders and Textures
+ *	@param name One of GetSceneNames, "objload", "meshload", "gltfload" or "textureload"
+ *	@param resourceDir Directory holding shaders/ and textures/, e.g. OpenGL/res
+ *	@return the scene, or null for an unknown name
+ */
+std::unique_ptr<BenchmarkScene> CreateScene(const std::string& name, const std::string& resourceDir);
@@ -0,0 +1,253 @@
+#include "HeadlessContext.h"
+
+#include <GL/glew.h>
+#include "Renderer.h"
+
+#if defined(GL_NULL_BACKEND)
+	#include "NullGL.h"
+#elif defined(_WIN32)
+	#include <GLFW/glfw3.h>
+#elif defined(BENCHMARK_OSMESA)
+	#include <GL/osmesa.h>
+	#include <vector>
+#else
+	#include <EGL/egl.h>
+	#include <EGL/eglext.h>
+#endif
+
+#if !defined(_WIN32) && !defined(GL_NULL_BACKEND)
+// glewInit also loads the GLX extensions, which needs an X display. Without a display only the
+// GL entry points are wanted, which is what glewContextInit does; it is exported but not declared.
+extern "C" GLenum GLEWAPIENTRY glewContextInit(void);
+#endif
+
+HeadlessContext::HeadlessContext(int width, int height)
+	: m_Width(width), m_Height(height), m_Valid(false), m_Display(nullptr), m_Context(nullptr), m_Pixels(nullptr),
+	m_Framebuffer(0), m_ColorBuffer(0)
+{
+	if (!CreatePlatformContext())
+	{
+		return;
+	}
+
+	glewExperimental = GL_TRUE;
+#if defined(GL_NULL_BACKEND) || defined(_WIN32)
+	GLenum glewResult = glewInit();
+#else
+	GLenum glewResult = glewContextInit();
+#endif
+	if (glewResult != GLEW_OK)
+	{
+		m_Error = "Glew Not OK";
+		return;
+	}
+	// GLEW may query functions that do not exist in a core context, which leaves an error behind
+	GLClearError();
+
+	// There is no window to draw to, so everything is drawn into this framebuffer
+	GLCall(glGenRenderbuffers(1, &m_ColorBuffer));
+	GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorBuffer));
+	GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height));
+	GLCall(glGenFramebuffers(1, &m_Framebuffer));
+	GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer));
+	GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorBuffer));
+
+	GLCall(GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		m_Error = "Offscreen framebuffer is incomplete";
+		return;
+	}
+
+	BindFramebuffer();
+	m_Valid = true;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+	if (m_Framebuffer)
+	{
+		GLCall(glDeleteFramebuffers(1, &m_Framebuffer));
+		GLCall(glDeleteRenderbuffers(1, &m_ColorBuffer));
+	}
+	DestroyPlatformContext();
+}
+
+void HeadlessContext::BindFramebuffer() const
+{
+	GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer));
+	GLCall(glViewport(0, 0, m_Width, m_Height));
+}
+
+#if defined(GL_NULL_BACKEND)
+
+bool HeadlessContext::CreatePlatformContext()
+{
+	// Nothing to create, the null backend only needs its state reset
+	NullGL::Install();
+	return true;
+}
+
+void HeadlessContext::DestroyPlatformContext()
+{
+}
+
+#elif defined(_WIN32)
+
+bool HeadlessContext::CreatePlatformContext()
+{
+	if (!glfwInit())
+	{
+		m_Error = "Could not initialise GLFW";
+		return false;
+	}
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+	GLFWwindow* window = glfwCreateWindow(m_Width, m_Height, "Benchmark", NULL, NULL);
+	if (!window)
+	{
+		m_Error = "Could not create a hidden window";
+		glfwTerminate();
+		return false;
+	}
+	glfwMakeContextCurrent(window);
+	// Never wait for vsync, the benchmark wants the raw frame time
+	glfwSwapInterval(0);
+
+	m_Context = window;
+	return true;
+}
+
+void HeadlessContext::DestroyPlatformContext()
+{
+	if (m_Context)
+	{
+		glfwDestroyWindow((GLFWwindow*)m_Context);
+		glfwTerminate();
+	}
+}
+
+#elif defined(BENCHMARK_OSMESA)
+
+bool HeadlessContext::CreatePlatformContext()
+{
+	const int attributes[] = {
+		OSMESA_FORMAT, OSMESA_RGBA,
+		OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+		OSMESA_CONTEXT_MAJOR_VERSION, 3,
+		OSMESA_CONTEXT_MINOR_VERSION, 3,
+		0
+	};
+	OSMesaContext context = OSMesaCreateContextAttribs(attributes, NULL);
+	if (!context)
+	{
+		m_Error = "Could not create an OSMesa 3.3 core context";
+		return false;
+	}
+
+	// OSMesa needs a buffer to make the context current, even though drawing goes to our framebuffer
+	std::vector<unsigned char>* pixels = new std::vector<unsigned char>(m_Width * m_Height * 4);
+	if (!OSMesaMakeCurrent(context, pixels->data(), GL_UNSIGNED_BYTE, m_Width, m_Height))
+	{
+		m_Error = "Could not make the OSMesa context current";
+		delete pixels;
+		OSMesaDestroyContext(context);
+		return false;
+	}
+
+	m_Context = context;
+	m_Pixels = pixels;
+	return true;
+}
+
+void HeadlessContext::DestroyPlatformContext()
+{
+	if (m_Context)
+	{
+		OSMesaDestroyContext((OSMesaContext)m_Context);
+	}
+	delete (std::vector<unsigned char>*)m_Pixels;
+}
+
+#else
+
+bool HeadlessContext::CreatePlatformContext()
+{
+	// Prefer the surfaceless platform, it needs neither a display server nor a GPU device
+	EGLDisplay display = EGL_NO_DISPLAY;
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay)
+	{
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	}
+	if (display == EGL_NO_DISPLAY)
+	{
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL))
+	{
+		m_Error = "Could not initialise an EGL display";
+		return false;
+	}
+	m_Display = display;
+
+	if (!eglBindAPI(EGL_OPENGL_API))
+	{
+		m_Error = "EGL does not support desktop OpenGL";
+		return false;
+	}
+
+	const EGLint configAttributes[] = {
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLConfig config = NULL;
+	EGLint configCount = 0;
+	eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+	// Surfaceless displays may not offer any configs, which is fine with EGL_KHR_no_config_context
+	if (configCount == 0)
+	{
+		config = NULL;
+	}
+
+	const EGLint contextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+	if (context == EGL_NO_CONTEXT)
+	{
+		m_Error = "Could not create an EGL 3.3 core context";
+		return false;
+	}
+	m_Context = context;
+
+	// No surface at all, drawing goes to our framebuffer (EGL_KHR_surfaceless_context)
+	if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+	{
+		m_Error = "Could not make the EGL context current without a surface";
+		return false;
+	}
+	return true;
+}
+
+void HeadlessContext::DestroyPlatformContext()
+{
+	if (m_Display)
+	{
+		eglMakeCurrent((EGLDisplay)m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (m_Context)
+		{
+			eglDestroyContext((EGLDisplay)m_Display, (EGLContext)m_Context);
+		}
+		eglTerminate((EGLDisplay)m_Display);
+	}
+}
+
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+
+/**
+ *	An OpenGL 3.3 core context with no window, rendering into an offscreen framebuffer.
+ *
+ *	On Linux the context comes from EGL with EGL_MESA_platform_surfaceless (or OSMesa when built with
+ *	BENCHMARK_OSMESA), so it runs on machines with no display or GPU using Mesa's llvmpipe.
+ *	On Windows a hidden GLFW window is used.
+ *	Builds with GL_NULL_BACKEND create no context at all and install the recording NullGL backend.
+ */
+class HeadlessContext
+{
+public:
+	/**
+	 *	Creates the context, makes it current and initialises GLEW
+	 *	@param width, height Size of the offscreen framebuffer
+	 */
+	HeadlessContext(int width, int height);
+
+	~HeadlessContext();
+
+	/**
+	 *	@return false if creating the context failed, GetError says why
+	 */
+	inline bool IsValid() const
+	{
+		return m_Valid;
+	}
+
+	inline const std::string& GetError() const
+	{
+		return m_Error;
+	}
+
+	/**
+	 *	Binds the offscreen framebuffer and sets the viewport to cover it
+	 */
+	void BindFramebuffer() const;
+
+private:
+	int m_Width, m_Height;
+	bool m_Valid;
+	std::string m_Error;
+
+	// Platform handles, kept opaque so this header does not drag in EGL, OSMesa or GLFW
+	void* m_Display;
+	void* m_Context;
+	void* m_Pixels;
+
+	unsigned int m_Framebuffer;
+	unsigned int m_ColorBuffer;
+
+	/**
+	 *	Creates the platform context
+	 *	@return false on failure, with m_Error set
+	 */
+	bool CreatePlatformContext();
+
+	void DestroyPlatformContext();
+};
@@ -0,0 +1,151 @@
+/**
+ *	Offline converter from Wavefront OBJ to the binary .mesh format MeshFile loads.
+ *	The mesh is reordered for the vertex cache, overdraw and vertex fetch, and a chain of levels of detail
+ *	is built, so none of that work is left for launch.
+ *
+ *	Usage: MeshConverter input.obj output.mesh [--lods N] [--no-optimize]
+ *	    --lods N        Levels of detail to build including the full mesh, 1 for none (default 4)
+ *	    --no-optimize   Keep the triangle and vertex order of the file
+ *
+ *	Linux build: the MeshConverter target of the CMakeLists.txt at the root of the repository
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ObjLoader.h"
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ThreadPool.h"
+
+/**
+ *	Command line options
+ */
+struct ConverterOptions
+{
+	std::string InputPath;
+	std::string OutputPath;
+	unsigned int Lods = 4;
+	bool Optimize = true;
+};
+
+static bool ParseOptions(int argc, char** argv, ConverterOptions& options)
+{
+	std::vector<std::string> paths;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--no-optimize")
+		{
+			options.Optimize = false;
+		}
+		else if (arg == "--lods")
+		{
+			if (i + 1 >= argc)
+			{
+				std::cerr << "Missing value for " << arg << std::endl;
+				return false;
+			}
+			options.Lods = (unsigned int)std::atoi(argv[++i]);
+		}
+		else if (arg.compare(0, 2, "--") == 0)
+		{
+			std::cerr << "Unknown option " << arg << std::endl;
+			return false;
+		}
+		else
+		{
+			paths.push_back(arg);
+		}
+	}
+
+	if (paths.size() != 2 || options.Lods == 0)
+	{
+		return false;
+	}
+	options.InputPath = paths[0];
+	options.OutputPath = paths[1];
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	ConverterOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::cerr << "Usage: MeshConverter input.obj output.mesh [--lods N] [--no-optimize]" << std::endl;
+		return 1;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	ObjMesh mesh;
+	{
+		ThreadPool pool;
+		if (!ObjLoader::Load(options.InputPath, mesh, &pool))
+		{
+			return 1;
+		}
+	}
+	if (mesh.Indices.empty())
+	{
+		std::cerr << "'" << options.InputPath << "' has no faces" << std::endl;
+		return 1;
+	}
+
+	unsigned int indexCount = (unsigned int)mesh.Indices.size();
+	unsigned int stride = mesh.Layout.GetStride();
+	MeshOptimizer::VertexCacheStats before, after;
+	if (options.Optimize)
+	{
+		before = MeshOptimizer::AnalyzeVertexCache(mesh.Indices.data(), indexCount, mesh.VertexCount);
+		mesh.VertexCount = MeshOptimizer::Optimize(mesh.Vertices.data(), mesh.Indices.data(), indexCount, mesh.VertexCount,
+			stride, mesh.Vertices.data());
+		mesh.Vertices.resize((size_t)mesh.VertexCount * stride / sizeof(float));
+		after = MeshOptimizer::AnalyzeVertexCache(mesh.Indices.data(), indexCount, mesh.VertexCount);
+	}
+
+	std::vector<unsigned int> lodIndices;
+	std::vector<MeshLod> lods;
+	if (options.Lods > 1)
+	{
+		// Keep texture coordinates from sliding across the surface, they follow the position
+		SimplifyAttributes attributes;
+		if (mesh.HasTexCoords)
+		{
+			attributes.Data = mesh.Vertices.data() + 3;
+			attributes.Stride = stride;
+			attributes.Count = 2;
+		}
+		lods = MeshSimplifier::BuildLods(lodIndices, mesh.Indices.data(), indexCount, mesh.Vertices.data(), mesh.VertexCount,
+			stride, options.Lods, 0.5f, 0.05f, attributes);
+	}
+	else
+	{
+		lodIndices.swap(mesh.Indices);
+		lods.push_back({ 0, indexCount, 0.0f });
+	}
+
+	if (!MeshFile::Write(options.OutputPath, mesh.Vertices.data(), mesh.VertexCount, mesh.Layout, lodIndices.data(),
+		(unsigned int)lodIndices.size(), lods.data(), (unsigned int)lods.size()))
+	{
+		return 1;
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	std::cout << options.OutputPath << ": " << mesh.VertexCount << " vertices, " << indexCount / 3 << " triangles, "
+		<< lods.size() << " levels of detail in " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+	if (options.Optimize)
+	{
+		std::cout << "  vertex cache: ACMR " << before.ACMR << " -> " << after.ACMR << ", ATVR " << before.ATVR << " -> "
+			<< after.ATVR << std::endl;
+	}
+	for (unsigned int i = 0; i < lods.size(); i++)
+	{
+		std::cout << "  level " << i << ": " << lods[i].IndexCount / 3 << " triangles, error " << lods[i].Error << std::endl;
+	}
+	return 0;
+}
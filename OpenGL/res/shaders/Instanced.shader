@@ -0,0 +1,33 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+// Per instance
+layout(location = 2) in vec2 offset;
+layout(location = 3) in vec4 color;
+
+out vec2 v_TexCoord;
+out vec4 v_Color;
+
+void main()
+{
+	gl_Position = vec4(position.xy + offset, position.zw);
+	v_TexCoord = texCoord;
+	v_Color = color;
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+	color = texture(u_Texture, v_TexCoord) * v_Color;
+}
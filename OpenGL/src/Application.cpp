@@ -12,6 +12,9 @@
 #include "VertexBufferLayout.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "GLState.h"
+#include "GLNamePool.h"
+#include "Profiler.h"
 
 int main(void)
 {
@@ -28,6 +31,10 @@ int main(void)
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#if GL_ERROR_CHECK == GL_ERROR_CHECK_CALLBACK
+	// Debug contexts report errors through the debug message callback
+	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+#endif
 
 	/* Create a windowed mode window and its OpenGL context */
 	window = glfwCreateWindow(500, 500, "Hello World", NULL, NULL);
@@ -49,6 +56,8 @@ int main(void)
 	}
 
 	std::cout << "OpenGL has found: " << glGetString(GL_VERSION) << std::endl;
+
+	GLInitErrorChecking();
 	
 	{
 		// Triangle Vertex locations
@@ -100,14 +109,17 @@ int main(void)
 		ib.UnBind();
 		shader.UnBind();
 
-		GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
-		GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+		GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+		GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
 		Renderer renderer;
 
 		/* Loop until the user closes the window */
 		while (!glfwWindowShouldClose(window))
 		{
+#ifdef GL_PROFILE
+			Profiler::Get().BeginFrame();
+#endif
 			/* Render here */
 			renderer.Clear();
 
@@ -119,11 +131,24 @@ int main(void)
 			/* Swap front and back buffers */
 			glfwSwapBuffers(window);
 
+			GLCheckFrameErrors();
+
+#ifdef GL_PROFILE
+			Profiler::Get().EndFrame();
+#endif
+
 			/* Poll for and process events */
 			glfwPollEvents();
 		}
 	}
 
+	// The scope above released its buffers and textures into the pool, delete them while the context exists
+	GLNamePool::Clear();
+
+#ifdef GL_PROFILE
+	Profiler::Get().WriteChromeTrace("profile.json");
+#endif
+
 	glfwTerminate();
 
 	return 0;
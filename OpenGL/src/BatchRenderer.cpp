@@ -0,0 +1,185 @@
+#include "BatchRenderer.h"
+
+#include "Renderer.h"
+#include "StaticVertexLayout.h"
+#include "Shader.h"
+#include "Texture.h"
+#include <GL/glew.h>
+#include <cstring>
+
+static const float s_White[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+using BatchVertexLayout = StaticVertexLayout<BatchVertex,
+	VERTEX_ATTRIBUTE(BatchVertex, Position),
+	VERTEX_ATTRIBUTE(BatchVertex, TexCoord),
+	VERTEX_ATTRIBUTE(BatchVertex, Color),
+	VERTEX_ATTRIBUTE(BatchVertex, TexIndex)>;
+
+BatchRenderer::BatchRenderer(unsigned int maxQuads, unsigned int maxQuadsPerFrame)
+	: m_MaxQuads(maxQuads), m_Vertices(maxQuads * 4), m_QuadCount(0), m_TextureSlotCount(0), m_Shader(nullptr)
+{
+	// Each region of the ring holds every batch of one frame, so the ring only moves on at End
+	unsigned int regionQuads = maxQuadsPerFrame > maxQuads ? maxQuadsPerFrame : maxQuads;
+	m_VertexBuffer = std::make_unique<StreamingBuffer>(GL_ARRAY_BUFFER, regionQuads * 4 * (unsigned int)sizeof(BatchVertex));
+
+	m_VertexArray.AddBuffer<BatchVertexLayout>(*m_VertexBuffer);
+
+	// Every quad is made of the same two triangles, so the indices never change and are generated once
+	std::vector<unsigned int> indices(maxQuads * 6);
+	for (unsigned int i = 0; i < maxQuads; i++)
+	{
+		unsigned int vertex = i * 4;
+		indices[i * 6 + 0] = vertex + 0;
+		indices[i * 6 + 1] = vertex + 1;
+		indices[i * 6 + 2] = vertex + 2;
+		indices[i * 6 + 3] = vertex + 2;
+		indices[i * 6 + 4] = vertex + 3;
+		indices[i * 6 + 5] = vertex + 0;
+	}
+	m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+
+	m_VertexArray.UnBind();
+}
+
+BatchRenderer::~BatchRenderer()
+{
+}
+
+void BatchRenderer::Begin(Shader & shader)
+{
+	m_Shader = &shader;
+	m_QuadCount = 0;
+	m_TextureSlotCount = 0;
+}
+
+void BatchRenderer::End()
+{
+	Flush();
+	m_VertexBuffer->EndFrame();
+}
+
+void BatchRenderer::SetShader(Shader & shader)
+{
+	if (m_Shader != &shader)
+	{
+		Flush();
+		m_Shader = &shader;
+	}
+}
+
+void BatchRenderer::DrawQuad(float x, float y, float width, float height, const float color[4])
+{
+	PushQuad(x, y, width, height, color, -1.0f);
+}
+
+void BatchRenderer::DrawQuad(float x, float y, float width, float height, const Texture & texture)
+{
+	DrawQuad(x, y, width, height, texture, s_White);
+}
+
+void BatchRenderer::DrawQuad(float x, float y, float width, float height, const Texture & texture, const float tint[4])
+{
+	float texIndex = GetTextureIndex(texture);
+	PushQuad(x, y, width, height, tint, texIndex);
+}
+
+void BatchRenderer::Flush()
+{
+	if (m_QuadCount == 0 || !m_Shader)
+	{
+		return;
+	}
+
+	// Aligned to whole vertices, so the offset can be given as a base vertex
+	unsigned int size = m_QuadCount * 4 * (unsigned int)sizeof(BatchVertex);
+	unsigned int offset;
+	void* vertices = m_VertexBuffer->Allocate(size, (unsigned int)sizeof(BatchVertex), offset);
+	std::memcpy(vertices, m_Vertices.data(), size);
+	m_VertexBuffer->Commit(size);
+	unsigned int baseVertex = offset / (unsigned int)sizeof(BatchVertex);
+
+	m_Shader->Bind();
+
+	int slots[MaxTextureSlots];
+	for (unsigned int i = 0; i < MaxTextureSlots; i++)
+	{
+		slots[i] = (int)i;
+	}
+	m_Shader->SetUniform1iv("u_Textures", MaxTextureSlots, slots);
+
+	for (unsigned int i = 0; i < m_TextureSlotCount; i++)
+	{
+		m_TextureSlots[i]->Bind(i);
+	}
+
+	m_VertexArray.Bind();
+	m_IndexBuffer->Bind();
+	// The attributes point at the start of the streaming buffer, the base vertex skips to this batch
+	GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, m_QuadCount * 6, m_IndexBuffer->GetType(), nullptr, baseVertex));
+
+	m_Stats.DrawCount++;
+
+	m_QuadCount = 0;
+	m_TextureSlotCount = 0;
+}
+
+float BatchRenderer::GetTextureIndex(const Texture & texture)
+{
+	// Without Begin there is no shader, so Flush could not free the slots
+	ASSERT(m_Shader);
+
+	for (unsigned int i = 0; i < m_TextureSlotCount; i++)
+	{
+		if (m_TextureSlots[i]->GetRendererID() == texture.GetRendererID())
+		{
+			return (float)i;
+		}
+	}
+
+	// Every slot is taken, so this texture has to go into a new batch
+	if (m_TextureSlotCount == MaxTextureSlots)
+	{
+		Flush();
+	}
+
+	m_TextureSlots[m_TextureSlotCount] = &texture;
+	return (float)m_TextureSlotCount++;
+}
+
+void BatchRenderer::PushQuad(float x, float y, float width, float height, const float color[4], float texIndex)
+{
+	// Without Begin there is no shader, so Flush could not make room
+	ASSERT(m_Shader);
+
+	if (m_QuadCount == m_MaxQuads)
+	{
+		// Flushing releases the texture slots, so the texture of this quad needs a slot again
+		const Texture* texture = texIndex >= 0.0f ? m_TextureSlots[(unsigned int)texIndex] : nullptr;
+		Flush();
+		if (texture)
+		{
+			texIndex = GetTextureIndex(*texture);
+		}
+	}
+
+	// bottom left, bottom right, top right, top left, the same winding as the shared index buffer expects
+	const float positions[4][2] = { { x, y }, { x + width, y }, { x + width, y + height }, { x, y + height } };
+	const float texCoords[4][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+
+	BatchVertex* vertex = &m_Vertices[m_QuadCount * 4];
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		vertex[i].Position[0] = positions[i][0];
+		vertex[i].Position[1] = positions[i][1];
+		vertex[i].TexCoord[0] = texCoords[i][0];
+		vertex[i].TexCoord[1] = texCoords[i][1];
+		vertex[i].Color[0] = color[0];
+		vertex[i].Color[1] = color[1];
+		vertex[i].Color[2] = color[2];
+		vertex[i].Color[3] = color[3];
+		vertex[i].TexIndex = texIndex;
+	}
+
+	m_QuadCount++;
+	m_Stats.QuadCount++;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "VertexArray.h"
+#include "StreamingBuffer.h"
+#include "IndexBuffer.h"
+
+class Shader;
+class Texture;
+
+/**
+ *	A single vertex of a batched quad, interleaved in the order expected by Batch.shader
+ */
+struct BatchVertex
+{
+	float Position[2];
+	float TexCoord[2];
+	float Color[4];
+	float TexIndex; // -1 for untextured quads
+};
+
+/**
+ *	Collects quads and draws them with as few draw calls as possible.
+ *	A batch is only flushed when it is full, when every texture slot is used or when the shader changes.
+ *	Quads are collected in a CPU array and copied into a StreamingBuffer when the batch is flushed, taking
+ *	only the space the batch needs, so all batches of a frame share one region of the ring.
+ *	Each Begin/End pair should cover one frame, and quads may only be drawn after Begin.
+ */
+class BatchRenderer
+{
+public:
+	/**
+	 *	Number of texture slots a batch can use, must match the size of u_Textures in Batch.shader
+	 */
+	static const unsigned int MaxTextureSlots = 16;
+
+	/**
+	 *	Counters for the quads and draw calls issued since the last ResetStats
+	 */
+	struct Stats
+	{
+		unsigned int DrawCount = 0;
+		unsigned int QuadCount = 0;
+	};
+
+	/**
+	 *	Creates the streaming vertex buffer and the shared index buffer
+	 *	@param maxQuads The number of quads that fit into one draw call.
+	 *	The default keeps every index below 65536.
+	 *	@param maxQuadsPerFrame The number of quads of all batches of one frame that fit into a region of the
+	 *	streaming buffer. Frames drawing more move on to the next region early, which may wait for the GPU.
+	 */
+	BatchRenderer(unsigned int maxQuads = 16384, unsigned int maxQuadsPerFrame = 131072);
+
+	~BatchRenderer();
+
+	/**
+	 *	Starts a new batch which will be drawn with the given shader
+	 */
+	void Begin(Shader& shader);
+
+	/**
+	 *	Draws everything that is still queued and ends the frame of the streaming buffer
+	 */
+	void End();
+
+	/**
+	 *	Changes the shader used by following quads, flushing the current batch if it differs
+	 */
+	void SetShader(Shader& shader);
+
+	/**
+	 *	Queues a solid coloured quad
+	 *	@param x, y Bottom left corner of the quad
+	 *	@param width, height Size of the quad
+	 *	@param color RGBA colour of the quad
+	 */
+	void DrawQuad(float x, float y, float width, float height, const float color[4]);
+
+	/**
+	 *	Queues a textured quad
+	 *	@param x, y Bottom left corner of the quad
+	 *	@param width, height Size of the quad
+	 *	@param texture The texture to draw over the whole quad
+	 */
+	void DrawQuad(float x, float y, float width, float height, const Texture& texture);
+
+	/**
+	 *	Queues a textured quad multiplied by a colour
+	 */
+	void DrawQuad(float x, float y, float width, float height, const Texture& texture, const float tint[4]);
+
+	/**
+	 *	Uploads and draws the current batch, then starts an empty one
+	 */
+	void Flush();
+
+	inline const Stats& GetStats() const
+	{
+		return m_Stats;
+	}
+
+	inline void ResetStats()
+	{
+		m_Stats = Stats();
+	}
+
+private:
+	unsigned int m_MaxQuads;
+
+	VertexArray m_VertexArray;
+	std::unique_ptr<StreamingBuffer> m_VertexBuffer;
+	std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+	// The quads of the current batch, copied to the streaming buffer by Flush
+	std::vector<BatchVertex> m_Vertices;
+	unsigned int m_QuadCount;
+
+	// Textures used by the current batch, their position is the slot they are bound to
+	const Texture* m_TextureSlots[MaxTextureSlots];
+	unsigned int m_TextureSlotCount;
+
+	Shader* m_Shader;
+
+	Stats m_Stats;
+
+	/**
+	 *	@return the slot of the texture in the current batch, flushing first if there is no free slot
+	 */
+	float GetTextureIndex(const Texture& texture);
+
+	/**
+	 *	Appends the four vertices of a quad to the batch
+	 */
+	void PushQuad(float x, float y, float width, float height, const float color[4], float texIndex);
+};
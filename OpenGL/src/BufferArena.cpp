@@ -0,0 +1,220 @@
+#include "BufferArena.h"
+
+#include <algorithm>
+
+#include "Renderer.h"
+#include "GLState.h"
+
+static unsigned int AlignUp(unsigned int offset, unsigned int alignment)
+{
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+BufferArena::BufferArena(GLenum target, unsigned int capacity)
+	: m_Target(target), m_Capacity(capacity), m_FreeBytes(0)
+{
+	GLCall(glGenBuffers(1, &m_RendererID));
+	// Uploads go through GL_COPY_WRITE_BUFFER, binding GL_ELEMENT_ARRAY_BUFFER would change the bound vertex array
+	GLState::BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+	GLCall(glBufferData(GL_COPY_WRITE_BUFFER, capacity, nullptr, GL_STATIC_DRAW));
+
+	AddFreeBlock(0, capacity);
+}
+
+BufferArena::~BufferArena()
+{
+	GLState::OnDeleteBuffer(m_RendererID);
+	GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+unsigned int BufferArena::Allocate(unsigned int size, unsigned int alignment, const void * data)
+{
+	unsigned int offset = TakeSpace(size, alignment);
+	if (offset == InvalidAllocation && size + alignment - 1 <= m_FreeBytes)
+	{
+		// The space is there, just not in one piece
+		Defragment();
+		offset = TakeSpace(size, alignment);
+	}
+	if (offset == InvalidAllocation)
+	{
+		return InvalidAllocation;
+	}
+
+	unsigned int id;
+	if (!m_FreeIds.empty())
+	{
+		id = m_FreeIds.back();
+		m_FreeIds.pop_back();
+	}
+	else
+	{
+		id = (unsigned int)m_Allocations.size();
+		m_Allocations.push_back(Allocation());
+	}
+	m_Allocations[id] = { offset, size, alignment, true };
+
+	if (data)
+	{
+		SetData(id, data, size);
+	}
+	return id;
+}
+
+void BufferArena::Free(unsigned int allocation)
+{
+	Allocation& info = m_Allocations[allocation];
+	ASSERT(info.Used);
+
+	AddFreeBlock(info.Offset, info.Size);
+	info.Used = false;
+	m_FreeIds.push_back(allocation);
+}
+
+void BufferArena::SetData(unsigned int allocation, const void * data, unsigned int size, unsigned int offset)
+{
+	const Allocation& info = m_Allocations[allocation];
+	ASSERT(offset + size <= info.Size);
+
+	GLState::BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+	GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, info.Offset + offset, size, data));
+}
+
+void BufferArena::Defragment()
+{
+	// Live allocations in the order they sit in the buffer, each one only ever moves towards the start
+	std::vector<unsigned int> order;
+	for (unsigned int i = 0; i < m_Allocations.size(); i++)
+	{
+		if (m_Allocations[i].Used)
+		{
+			order.push_back(i);
+		}
+	}
+	std::sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b)
+	{
+		return m_Allocations[a].Offset < m_Allocations[b].Offset;
+	});
+
+	// Allocations before the first gap are already in place
+	unsigned int end = 0;
+	unsigned int first = 0;
+	while (first < order.size() && AlignUp(end, m_Allocations[order[first]].Alignment) == m_Allocations[order[first]].Offset)
+	{
+		const Allocation& info = m_Allocations[order[first]];
+		end = info.Offset + info.Size;
+		first++;
+	}
+
+	if (first < order.size())
+	{
+		// A buffer cannot be copied onto an overlapping range of itself, so the moved allocations are
+		// packed into a scratch buffer first and copied back in one go
+		unsigned int start = end;
+		std::vector<unsigned int> offsets(order.size());
+		for (unsigned int i = first; i < order.size(); i++)
+		{
+			offsets[i] = AlignUp(end, m_Allocations[order[i]].Alignment);
+			end = offsets[i] + m_Allocations[order[i]].Size;
+		}
+
+		unsigned int scratch;
+		GLCall(glGenBuffers(1, &scratch));
+		GLState::BindBuffer(GL_COPY_WRITE_BUFFER, scratch);
+		GLCall(glBufferData(GL_COPY_WRITE_BUFFER, end - start, nullptr, GL_STREAM_COPY));
+		GLState::BindBuffer(GL_COPY_READ_BUFFER, m_RendererID);
+		for (unsigned int i = first; i < order.size(); i++)
+		{
+			Allocation& info = m_Allocations[order[i]];
+			GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, info.Offset, offsets[i] - start, info.Size));
+			info.Offset = offsets[i];
+		}
+
+		GLState::BindBuffer(GL_COPY_READ_BUFFER, scratch);
+		GLState::BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+		GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, start, end - start));
+
+		GLState::OnDeleteBuffer(scratch);
+		GLCall(glDeleteBuffers(1, &scratch));
+	}
+
+	m_FreeBlocks.clear();
+	m_FreeBytes = 0;
+	AddFreeBlock(end, m_Capacity - end);
+}
+
+void BufferArena::Bind() const
+{
+	GLState::BindBuffer(m_Target, m_RendererID);
+}
+
+void BufferArena::UnBind() const
+{
+	GLState::BindBuffer(m_Target, 0);
+}
+
+unsigned int BufferArena::GetLargestFreeBlock() const
+{
+	unsigned int largest = 0;
+	for (const auto& block : m_FreeBlocks)
+	{
+		largest = std::max(largest, block.second);
+	}
+	return largest;
+}
+
+unsigned int BufferArena::TakeSpace(unsigned int size, unsigned int alignment)
+{
+	for (auto it = m_FreeBlocks.begin(); it != m_FreeBlocks.end(); it++)
+	{
+		unsigned int blockOffset = it->first;
+		unsigned int blockSize = it->second;
+		unsigned int offset = AlignUp(blockOffset, alignment);
+		if (offset + size > blockOffset + blockSize)
+		{
+			continue;
+		}
+
+		// Whatever is left before and after the space stays free
+		m_FreeBlocks.erase(it);
+		m_FreeBytes -= blockSize;
+		if (offset > blockOffset)
+		{
+			AddFreeBlock(blockOffset, offset - blockOffset);
+		}
+		if (offset + size < blockOffset + blockSize)
+		{
+			AddFreeBlock(offset + size, blockOffset + blockSize - offset - size);
+		}
+		return offset;
+	}
+	return InvalidAllocation;
+}
+
+void BufferArena::AddFreeBlock(unsigned int offset, unsigned int size)
+{
+	if (size == 0)
+	{
+		return;
+	}
+	m_FreeBytes += size;
+
+	auto next = m_FreeBlocks.lower_bound(offset);
+	if (next != m_FreeBlocks.begin())
+	{
+		auto previous = std::prev(next);
+		if (previous->first + previous->second == offset)
+		{
+			// Grow the block before instead of adding a new one
+			offset = previous->first;
+			size += previous->second;
+			m_FreeBlocks.erase(previous);
+		}
+	}
+	if (next != m_FreeBlocks.end() && offset + size == next->first)
+	{
+		size += next->second;
+		m_FreeBlocks.erase(next);
+	}
+	m_FreeBlocks[offset] = size;
+}
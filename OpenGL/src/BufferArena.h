@@ -0,0 +1,141 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <map>
+#include <vector>
+
+/**
+ *	One large GL buffer that many meshes are placed into, so drawing them needs no buffer binds.
+ *
+ *	Space is handed out by a first fit allocator whose free blocks are merged with their neighbours
+ *	when freed. Allocations are referred to by id rather than offset, as Defragment moves them.
+ *	VertexBuffer and IndexBuffer can be created as views into an arena, which must outlive them.
+ */
+class BufferArena
+{
+public:
+	/**
+	 *	Returned by Allocate when the arena is full
+	 */
+	static const unsigned int InvalidAllocation = 0xFFFFFFFF;
+
+	/**
+	 *	Creates the buffer
+	 *	@param target The target the buffer is drawn from, GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+	 *	@param capacity Size in bytes of the buffer, it never grows
+	 */
+	BufferArena(GLenum target, unsigned int capacity);
+
+	/**
+	 *	Deletes the buffer, any remaining views are left pointing at nothing
+	 */
+	~BufferArena();
+
+	BufferArena(const BufferArena&) = delete;
+	BufferArena& operator=(const BufferArena&) = delete;
+
+	/**
+	 *	Reserves space, defragmenting first if there is enough free space but no block is large enough
+	 *	@param size Size in bytes to reserve
+	 *	@param alignment The offset is a multiple of this, e.g. the vertex size to draw with a base vertex
+	 *	@param data Data to upload into the space, or null to leave it undefined
+	 *	@return the id of the allocation, or InvalidAllocation if it does not fit
+	 */
+	unsigned int Allocate(unsigned int size, unsigned int alignment, const void* data = nullptr);
+
+	/**
+	 *	Returns an allocation's space to the arena
+	 */
+	void Free(unsigned int allocation);
+
+	/**
+	 *	Replaces part of an allocation
+	 *	@param offset Offset in bytes from the start of the allocation
+	 */
+	void SetData(unsigned int allocation, const void* data, unsigned int size, unsigned int offset = 0);
+
+	/**
+	 *	Moves every allocation towards the start of the buffer, leaving one free block at the end.
+	 *	The data is copied on the GPU, only the offsets of the allocations change.
+	 */
+	void Defragment();
+
+	/**
+	 *	Bind this buffer to its target
+	 */
+	void Bind() const;
+
+	/**
+	 *	Unbind this buffer from its target
+	 */
+	void UnBind() const;
+
+	/**
+	 *	@return offset in bytes of an allocation from the start of the buffer
+	 */
+	inline unsigned int GetOffset(unsigned int allocation) const
+	{
+		return m_Allocations[allocation].Offset;
+	}
+
+	inline unsigned int GetSize(unsigned int allocation) const
+	{
+		return m_Allocations[allocation].Size;
+	}
+
+	inline unsigned int GetRendererID() const
+	{
+		return m_RendererID;
+	}
+
+	inline unsigned int GetCapacity() const
+	{
+		return m_Capacity;
+	}
+
+	/**
+	 *	@return bytes not used by any allocation
+	 */
+	inline unsigned int GetFreeBytes() const
+	{
+		return m_FreeBytes;
+	}
+
+	/**
+	 *	@return size in bytes of the largest allocation that fits without defragmenting
+	 */
+	unsigned int GetLargestFreeBlock() const;
+
+private:
+	struct Allocation
+	{
+		unsigned int Offset;
+		unsigned int Size;
+		unsigned int Alignment;
+		bool Used;
+	};
+
+	unsigned int m_RendererID;
+	GLenum m_Target;
+	unsigned int m_Capacity;
+	unsigned int m_FreeBytes;
+
+	// Free blocks, size keyed by offset, never touching each other
+	std::map<unsigned int, unsigned int> m_FreeBlocks;
+
+	// Indexed by allocation id
+	std::vector<Allocation> m_Allocations;
+	// Ids of freed allocations, reused before new ones are added
+	std::vector<unsigned int> m_FreeIds;
+
+	/**
+	 *	Takes space from the first free block it fits in
+	 *	@return the offset of the space, or InvalidAllocation if no block is large enough
+	 */
+	unsigned int TakeSpace(unsigned int size, unsigned int alignment);
+
+	/**
+	 *	Adds a free block, merging it with the blocks before and after it
+	 */
+	void AddFreeBlock(unsigned int offset, unsigned int size);
+};
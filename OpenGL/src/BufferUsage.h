@@ -0,0 +1,29 @@
+#pragma once
+
+#include <GL/glew.h>
+
+/**
+ *	How often the contents of a buffer are expected to change, passed to GL as a hint
+ */
+enum class BufferUsage
+{
+	// Written once, drawn many times
+	Static,
+	// Changed every now and then, e.g. an animated mesh
+	Dynamic,
+	// Rewritten for nearly every draw
+	Stream
+};
+
+/**
+ *	@return the GL usage hint for a BufferUsage, e.g. GL_STATIC_DRAW
+ */
+inline GLenum GetGLUsage(BufferUsage usage)
+{
+	switch (usage)
+	{
+	case BufferUsage::Dynamic: return GL_DYNAMIC_DRAW;
+	case BufferUsage::Stream: return GL_STREAM_DRAW;
+	default: return GL_STATIC_DRAW;
+	}
+}
@@ -0,0 +1,68 @@
+#include "CommandList.h"
+
+#include <cstring>
+
+void CommandList::Reset()
+{
+	m_Commands.clear();
+	m_Names.clear();
+}
+
+void CommandList::BindShader(Shader & shader)
+{
+	Push(CommandType::BindShader, &shader);
+}
+
+void CommandList::BindTexture(const Texture & texture, unsigned int slot)
+{
+	Push(CommandType::BindTexture, &texture).Value = slot;
+}
+
+void CommandList::SetUniform1i(const std::string & name, int value)
+{
+	unsigned int nameOffset = StoreName(name);
+	Command& command = Push(CommandType::SetUniform1i, nullptr);
+	command.Name = nameOffset;
+	command.IntValue = value;
+}
+
+void CommandList::SetUniform4f(const std::string & name, float v0, float v1, float v2, float v3)
+{
+	unsigned int nameOffset = StoreName(name);
+	Command& command = Push(CommandType::SetUniform4f, nullptr);
+	command.Name = nameOffset;
+	command.Values[0] = v0;
+	command.Values[1] = v1;
+	command.Values[2] = v2;
+	command.Values[3] = v3;
+}
+
+void CommandList::Draw(const VertexArray & va, const IndexBuffer & ib)
+{
+	Push(CommandType::Draw, &va).IB = &ib;
+}
+
+void CommandList::DrawInstanced(const VertexArray & va, const IndexBuffer & ib, unsigned int instanceCount)
+{
+	Command& command = Push(CommandType::DrawInstanced, &va);
+	command.IB = &ib;
+	command.Value = instanceCount;
+}
+
+CommandList::Command & CommandList::Push(CommandType type, const void * object)
+{
+	m_Commands.emplace_back();
+	Command& command = m_Commands.back();
+	command.Type = type;
+	command.Object = object;
+	command.IB = nullptr;
+	return command;
+}
+
+unsigned int CommandList::StoreName(const std::string & name)
+{
+	unsigned int offset = (unsigned int)m_Names.size();
+	m_Names.resize(offset + name.size() + 1);
+	std::memcpy(&m_Names[offset], name.c_str(), name.size() + 1);
+	return offset;
+}
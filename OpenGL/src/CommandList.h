@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+class Shader;
+class Texture;
+class VertexArray;
+class IndexBuffer;
+
+/**
+ *	Records binds, uniform changes and draws without calling into OpenGL, so it can be filled on
+ *	any thread. The thread that owns the context replays it with Renderer::Submit.
+ *
+ *	Each worker should record into its own CommandList; the lists are then submitted in the order
+ *	the frame needs them. Everything referenced must stay alive until the list has been submitted.
+ */
+class CommandList
+{
+public:
+	/**
+	 *	Empties the list, keeping its memory for the next frame
+	 */
+	void Reset();
+
+	/**
+	 *	Binds a shader, uniforms and draws that follow use it
+	 */
+	void BindShader(Shader& shader);
+
+	void BindTexture(const Texture& texture, unsigned int slot = 0);
+
+	/**
+	 *	Sets an int uniform (e.g. a texture slot) of the last bound shader
+	 */
+	void SetUniform1i(const std::string& name, int value);
+
+	/**
+	 *	Sets a vec4 uniform (e.g. a colour) of the last bound shader
+	 */
+	void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
+
+	/**
+	 *	Draws with the last bound shader
+	 */
+	void Draw(const VertexArray& va, const IndexBuffer& ib);
+
+	/**
+	 *	Draws many instances with the last bound shader
+	 */
+	void DrawInstanced(const VertexArray& va, const IndexBuffer& ib, unsigned int instanceCount);
+
+	inline unsigned int GetCommandCount() const
+	{
+		return (unsigned int)m_Commands.size();
+	}
+
+private:
+	friend class Renderer;
+
+	enum class CommandType
+	{
+		BindShader,
+		BindTexture,
+		SetUniform1i,
+		SetUniform4f,
+		Draw,
+		DrawInstanced
+	};
+
+	/**
+	 *	One recorded command, the members used depend on the type
+	 */
+	struct Command
+	{
+		CommandType Type;
+		const void* Object;      // Shader, Texture or VertexArray
+		const IndexBuffer* IB;
+		unsigned int Name;       // offset of the uniform name in m_Names
+		unsigned int Value;      // texture slot or instance count
+		int IntValue;
+		float Values[4];
+	};
+
+	std::vector<Command> m_Commands;
+
+	// Uniform names, null terminated one after another, so recording does not allocate per command
+	std::vector<char> m_Names;
+
+	/**
+	 *	Adds a command, setting the common members
+	 */
+	Command& Push(CommandType type, const void* object);
+
+	/**
+	 *	Copies a uniform name into m_Names
+	 *	@return the offset it was copied to
+	 */
+	unsigned int StoreName(const std::string& name);
+};
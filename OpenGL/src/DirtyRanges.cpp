@@ -0,0 +1,72 @@
+#include "DirtyRanges.h"
+
+#include <algorithm>
+
+#include "Renderer.h"
+
+void DirtyRanges::Add(unsigned int offset, unsigned int size)
+{
+	if (size > 0)
+	{
+		m_Ranges.push_back({ offset, size });
+	}
+}
+
+unsigned int DirtyRanges::Upload(GLenum target, const void * data, unsigned int size, GLenum usage, bool orphan)
+{
+	if (m_Ranges.empty())
+	{
+		return 0;
+	}
+
+	// The bytes between ranges are only known to be current when data holds the whole buffer
+	Coalesce(orphan ? MergeGap : 0);
+
+	unsigned int dirty = 0;
+	for (const Range& range : m_Ranges)
+	{
+		dirty += range.Size;
+	}
+
+	if (orphan && dirty * 2 >= size)
+	{
+		GLCall(glBufferData(target, size, data, usage));
+		dirty = size;
+	}
+	else
+	{
+		for (const Range& range : m_Ranges)
+		{
+			GLCall(glBufferSubData(target, range.Offset, range.Size, (const unsigned char*)data + range.Offset));
+		}
+	}
+
+	m_Ranges.clear();
+	return dirty;
+}
+
+void DirtyRanges::Coalesce(unsigned int gap)
+{
+	std::sort(m_Ranges.begin(), m_Ranges.end(), [](const Range& a, const Range& b)
+	{
+		return a.Offset < b.Offset;
+	});
+
+	unsigned int count = 0;
+	for (unsigned int i = 0; i < m_Ranges.size(); i++)
+	{
+		const Range& range = m_Ranges[i];
+		if (count > 0)
+		{
+			Range& last = m_Ranges[count - 1];
+			unsigned int lastEnd = last.Offset + last.Size;
+			if (range.Offset <= lastEnd + gap)
+			{
+				last.Size = std::max(lastEnd, range.Offset + range.Size) - last.Offset;
+				continue;
+			}
+		}
+		m_Ranges[count++] = range;
+	}
+	m_Ranges.resize(count);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+/**
+ *	Collects the parts of a buffer written by many small updates, so they are uploaded together.
+ *	The writes go to a CPU copy of the whole buffer, which the ranges are uploaded from.
+ */
+class DirtyRanges
+{
+public:
+	/**
+	 *	Ranges closer together than this are uploaded as one, re-sending the bytes in between is
+	 *	cheaper than another call
+	 */
+	static const unsigned int MergeGap = 256;
+
+	struct Range
+	{
+		unsigned int Offset;
+		unsigned int Size;
+	};
+
+	/**
+	 *	Marks bytes as changed
+	 */
+	void Add(unsigned int offset, unsigned int size);
+
+	/**
+	 *	Uploads every changed byte of the buffer bound to target from its CPU copy and forgets the ranges.
+	 *	When most of the buffer changed it is orphaned and uploaded whole instead, so the upload does not
+	 *	wait for draws that still read the old contents.
+	 *	@param target The target the buffer is bound to
+	 *	@param data The CPU copy of the whole buffer
+	 *	@param size Size in bytes of the buffer
+	 *	@param usage The usage hint the buffer was created with
+	 *	@param orphan false if data only holds the changed bytes, the buffer is then never uploaded whole and
+	 *	only ranges that overlap or touch are merged
+	 *	@return the number of bytes uploaded
+	 */
+	unsigned int Upload(GLenum target, const void* data, unsigned int size, GLenum usage, bool orphan = true);
+
+	inline bool IsEmpty() const
+	{
+		return m_Ranges.empty();
+	}
+
+	inline void Clear()
+	{
+		m_Ranges.clear();
+	}
+
+private:
+	std::vector<Range> m_Ranges;
+
+	/**
+	 *	Sorts the ranges and merges those that overlap or lie at most gap bytes apart
+	 */
+	void Coalesce(unsigned int gap);
+};
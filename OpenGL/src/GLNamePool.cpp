@@ -0,0 +1,138 @@
+#include "GLNamePool.h"
+
+#include <vector>
+
+#include "Renderer.h"
+#include "GLState.h"
+
+/**
+ *	The names of one kind of object held by the pool
+ */
+struct NameList
+{
+	// Generated but never used, they have no object yet
+	std::vector<unsigned int> Fresh;
+	// Released by their owner, their storage already dropped
+	std::vector<unsigned int> Recycled;
+};
+
+static NameList s_Buffers;
+static NameList s_Textures;
+static GLNamePool::Stats s_Stats;
+
+/**
+ *	@return a recycled name if there is one, otherwise a fresh one, generating a new batch if needed
+ */
+static unsigned int Take(NameList& names, void (*gen)(GLsizei, GLuint*))
+{
+	if (!names.Recycled.empty())
+	{
+		unsigned int name = names.Recycled.back();
+		names.Recycled.pop_back();
+		s_Stats.Recycled++;
+		return name;
+	}
+
+	if (names.Fresh.empty())
+	{
+		names.Fresh.resize(GLNamePool::BatchSize);
+		GLCall(gen(GLNamePool::BatchSize, names.Fresh.data()));
+		s_Stats.GenCalls++;
+	}
+	unsigned int name = names.Fresh.back();
+	names.Fresh.pop_back();
+	return name;
+}
+
+static void GenBuffers(GLsizei n, GLuint* names)
+{
+	glGenBuffers(n, names);
+}
+
+static void GenTextures(GLsizei n, GLuint* names)
+{
+	glGenTextures(n, names);
+}
+
+unsigned int GLNamePool::GenBuffer()
+{
+	return Take(s_Buffers, GenBuffers);
+}
+
+void GLNamePool::ReleaseBuffer(unsigned int buffer)
+{
+	if (s_Buffers.Recycled.size() < MaxRecycled)
+	{
+		// Free the old owner's storage now rather than when the name is taken again, which may be never.
+		// The copy write target is bound so no vertex array or other binding is disturbed.
+		GLState::BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		GLCall(glBufferData(GL_COPY_WRITE_BUFFER, 0, nullptr, GL_STATIC_DRAW));
+		GLState::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		s_Buffers.Recycled.push_back(buffer);
+		return;
+	}
+	GLState::OnDeleteBuffer(buffer);
+	GLCall(glDeleteBuffers(1, &buffer));
+	s_Stats.DeleteCalls++;
+}
+
+unsigned int GLNamePool::GenTexture()
+{
+	return Take(s_Textures, GenTextures);
+}
+
+void GLNamePool::ReleaseTexture(unsigned int texture)
+{
+	if (s_Textures.Recycled.size() < MaxRecycled)
+	{
+		// A 0 x 0 image frees the old owner's pixels
+		GLState::BindTexture(GLState::GetActiveTexture(), texture);
+		GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+		GLState::BindTexture(GLState::GetActiveTexture(), 0);
+		s_Textures.Recycled.push_back(texture);
+		return;
+	}
+	GLState::OnDeleteTexture(texture);
+	GLCall(glDeleteTextures(1, &texture));
+	s_Stats.DeleteCalls++;
+}
+
+void GLNamePool::Clear()
+{
+	std::vector<unsigned int> buffers = s_Buffers.Fresh;
+	buffers.insert(buffers.end(), s_Buffers.Recycled.begin(), s_Buffers.Recycled.end());
+	for (unsigned int buffer : buffers)
+	{
+		GLState::OnDeleteBuffer(buffer);
+	}
+	if (!buffers.empty())
+	{
+		GLCall(glDeleteBuffers((GLsizei)buffers.size(), buffers.data()));
+		s_Stats.DeleteCalls++;
+	}
+
+	std::vector<unsigned int> textures = s_Textures.Fresh;
+	textures.insert(textures.end(), s_Textures.Recycled.begin(), s_Textures.Recycled.end());
+	for (unsigned int texture : textures)
+	{
+		GLState::OnDeleteTexture(texture);
+	}
+	if (!textures.empty())
+	{
+		GLCall(glDeleteTextures((GLsizei)textures.size(), textures.data()));
+		s_Stats.DeleteCalls++;
+	}
+
+	s_Buffers = NameList();
+	s_Textures = NameList();
+}
+
+const GLNamePool::Stats& GLNamePool::GetStats()
+{
+	return s_Stats;
+}
+
+void GLNamePool::ResetStats()
+{
+	s_Stats = Stats();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <GL/glew.h>
+
+/**
+ *	Hands out GL buffer and texture names, generated in batches and recycled when released, so
+ *	streaming content in and out does not create and delete a GL object each time.
+ *
+ *	Releasing a name drops its storage (glBufferData or glTexImage2D of size 0), so only the names are
+ *	kept and only objects with mutable storage may be released here (not buffers made with
+ *	glBufferStorage). Must only be used on the thread owning the context.
+ */
+class GLNamePool
+{
+public:
+	/**
+	 *	Number of names generated by one glGen* call
+	 */
+	static const unsigned int BatchSize = 64;
+
+	/**
+	 *	Released names kept per kind, further names are deleted
+	 */
+	static const unsigned int MaxRecycled = 64;
+
+	/**
+	 *	Counters for the calls made since the last ResetStats
+	 */
+	struct Stats
+	{
+		unsigned int GenCalls = 0;
+		unsigned int DeleteCalls = 0;
+		// Names handed out again after being released
+		unsigned int Recycled = 0;
+	};
+
+	static unsigned int GenBuffer();
+
+	/**
+	 *	Returns a buffer name to the pool, the buffer is only deleted if the pool is full
+	 */
+	static void ReleaseBuffer(unsigned int buffer);
+
+	static unsigned int GenTexture();
+
+	/**
+	 *	Returns a 2D texture name to the pool, the texture is only deleted if the pool is full
+	 */
+	static void ReleaseTexture(unsigned int texture);
+
+	/**
+	 *	Deletes every name held by the pool, call before the context is destroyed
+	 */
+	static void Clear();
+
+	static const Stats& GetStats();
+
+	static void ResetStats();
+};
@@ -0,0 +1,239 @@
+#include "GLState.h"
+
+#include "Renderer.h"
+#include <unordered_map>
+
+// Marks a binding whose value is not known, so the next bind always goes to GL
+static const unsigned int s_Unknown = 0xFFFFFFFF;
+
+/**
+ *	The shadow copy of the GL bindings
+ */
+struct GLStateCache
+{
+	unsigned int Program = s_Unknown;
+	unsigned int VertexArray = s_Unknown;
+	unsigned int ActiveTexture = s_Unknown;
+	unsigned int Textures[GLState::MaxTextureUnits];
+
+	// Buffer bound to each target, except GL_ELEMENT_ARRAY_BUFFER
+	std::unordered_map<GLenum, unsigned int> Buffers;
+
+	// Element buffer bound to each vertex array
+	std::unordered_map<unsigned int, unsigned int> ElementBuffers;
+
+	GLState::Stats Stats;
+
+	GLStateCache()
+	{
+		for (unsigned int i = 0; i < GLState::MaxTextureUnits; i++)
+		{
+			Textures[i] = s_Unknown;
+		}
+	}
+};
+
+static GLStateCache s_State;
+
+// Not part of the shadow copy, so Invalidate keeps it
+static unsigned int s_BufferGeneration = 0;
+
+// The last deleted buffer names, the one deleted at generation g is at g % DeletedBufferHistory
+static const unsigned int DeletedBufferHistory = 1024;
+static unsigned int s_DeletedBuffers[DeletedBufferHistory];
+
+/**
+ *	Updates a shadowed value, returning true if GL has to be called
+ */
+static bool Changes(unsigned int& current, unsigned int value)
+{
+	if (current == value)
+	{
+		s_State.Stats.Hits++;
+		return false;
+	}
+	current = value;
+	s_State.Stats.Misses++;
+	return true;
+}
+
+void GLState::UseProgram(unsigned int program)
+{
+	if (Changes(s_State.Program, program))
+	{
+		GLCall(glUseProgram(program));
+	}
+}
+
+void GLState::BindVertexArray(unsigned int vertexArray)
+{
+	if (Changes(s_State.VertexArray, vertexArray))
+	{
+		GLCall(glBindVertexArray(vertexArray));
+	}
+}
+
+void GLState::BindBuffer(GLenum target, unsigned int buffer)
+{
+	if (target == GL_ELEMENT_ARRAY_BUFFER && s_State.VertexArray != s_Unknown)
+	{
+		auto it = s_State.ElementBuffers.find(s_State.VertexArray);
+		if (it == s_State.ElementBuffers.end())
+		{
+			it = s_State.ElementBuffers.insert({ s_State.VertexArray, s_Unknown }).first;
+		}
+		if (Changes(it->second, buffer))
+		{
+			GLCall(glBindBuffer(target, buffer));
+		}
+		return;
+	}
+
+	if (target == GL_ELEMENT_ARRAY_BUFFER)
+	{
+		// Without knowing the vertex array there is nowhere to remember this binding
+		s_State.Stats.Misses++;
+		GLCall(glBindBuffer(target, buffer));
+		return;
+	}
+
+	auto it = s_State.Buffers.find(target);
+	if (it == s_State.Buffers.end())
+	{
+		it = s_State.Buffers.insert({ target, s_Unknown }).first;
+	}
+	if (Changes(it->second, buffer))
+	{
+		GLCall(glBindBuffer(target, buffer));
+	}
+}
+
+void GLState::ActiveTexture(unsigned int unit)
+{
+	if (Changes(s_State.ActiveTexture, unit))
+	{
+		GLCall(glActiveTexture(GL_TEXTURE0 + unit));
+	}
+}
+
+void GLState::BindTexture(unsigned int unit, unsigned int texture)
+{
+	if (unit >= MaxTextureUnits)
+	{
+		ActiveTexture(unit);
+		s_State.Stats.Misses++;
+		GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+		return;
+	}
+
+	if (s_State.Textures[unit] == texture)
+	{
+		s_State.Stats.Hits++;
+		return;
+	}
+
+	ActiveTexture(unit);
+	Changes(s_State.Textures[unit], texture);
+	GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+}
+
+unsigned int GLState::GetActiveTexture()
+{
+	if (s_State.ActiveTexture == s_Unknown)
+	{
+		int unit;
+		GLCall(glGetIntegerv(GL_ACTIVE_TEXTURE, &unit));
+		s_State.ActiveTexture = (unsigned int)unit - GL_TEXTURE0;
+	}
+	return s_State.ActiveTexture;
+}
+
+void GLState::OnDeleteProgram(unsigned int program)
+{
+	// A deleted program stays in use until another one is used, and its name may be handed
+	// out again, so the current program can no longer be identified by name
+	if (s_State.Program == program)
+	{
+		s_State.Program = s_Unknown;
+	}
+}
+
+void GLState::OnDeleteVertexArray(unsigned int vertexArray)
+{
+	// Deleting the bound vertex array reverts the binding to 0
+	if (s_State.VertexArray == vertexArray)
+	{
+		s_State.VertexArray = 0;
+	}
+	s_State.ElementBuffers.erase(vertexArray);
+}
+
+void GLState::OnDeleteBuffer(unsigned int buffer)
+{
+	s_DeletedBuffers[s_BufferGeneration % DeletedBufferHistory] = buffer;
+	s_BufferGeneration++;
+
+	// Deleting a buffer unbinds it from the context's targets and from the bound vertex array
+	for (auto& binding : s_State.Buffers)
+	{
+		if (binding.second == buffer)
+		{
+			binding.second = 0;
+		}
+	}
+	for (auto& binding : s_State.ElementBuffers)
+	{
+		if (binding.second == buffer)
+		{
+			binding.second = binding.first == s_State.VertexArray ? 0 : s_Unknown;
+		}
+	}
+}
+
+void GLState::OnDeleteTexture(unsigned int texture)
+{
+	// Deleting a texture unbinds it from every unit
+	for (unsigned int i = 0; i < MaxTextureUnits; i++)
+	{
+		if (s_State.Textures[i] == texture)
+		{
+			s_State.Textures[i] = 0;
+		}
+	}
+}
+
+unsigned int GLState::GetBufferGeneration()
+{
+	return s_BufferGeneration;
+}
+
+bool GLState::GetDeletedBuffers(unsigned int generation, std::vector<unsigned int>& buffers)
+{
+	// Unsigned, so this also holds once the generation wraps around
+	if (s_BufferGeneration - generation > DeletedBufferHistory)
+	{
+		return false;
+	}
+	for (unsigned int i = generation; i != s_BufferGeneration; i++)
+	{
+		buffers.push_back(s_DeletedBuffers[i % DeletedBufferHistory]);
+	}
+	return true;
+}
+
+void GLState::Invalidate()
+{
+	GLState::Stats stats = s_State.Stats;
+	s_State = GLStateCache();
+	s_State.Stats = stats;
+}
+
+const GLState::Stats& GLState::GetStats()
+{
+	return s_State.Stats;
+}
+
+void GLState::ResetStats()
+{
+	s_State.Stats = Stats();
+}
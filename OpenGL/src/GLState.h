@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+
+#include <GL/glew.h>
+
+/**
+ *	Shadows the GL bindings this renderer changes and skips calls that would not change anything.
+ *	All binds of programs, vertex arrays, buffers and textures should go through here, otherwise the
+ *	shadow copy goes stale; call Invalidate after running GL code that binds things directly.
+ */
+class GLState
+{
+public:
+	/**
+	 *	Hits are calls that were skipped because the state already matched, misses were passed to GL
+	 */
+	struct Stats
+	{
+		unsigned int Hits = 0;
+		unsigned int Misses = 0;
+	};
+
+	/**
+	 *	Number of texture units that are tracked, binds to higher units always go to GL
+	 */
+	static const unsigned int MaxTextureUnits = 32;
+
+	static void UseProgram(unsigned int program);
+
+	static void BindVertexArray(unsigned int vertexArray);
+
+	/**
+	 *	Binds a buffer to a target. GL_ELEMENT_ARRAY_BUFFER is remembered per vertex array,
+	 *	as that binding is part of the vertex array's state.
+	 */
+	static void BindBuffer(GLenum target, unsigned int buffer);
+
+	/**
+	 *	@param unit Texture unit, 0 for GL_TEXTURE0
+	 */
+	static void ActiveTexture(unsigned int unit);
+
+	/**
+	 *	Binds a 2D texture to a texture unit, switching the active unit only when needed
+	 */
+	static void BindTexture(unsigned int unit, unsigned int texture);
+
+	/**
+	 *	@return the active texture unit, 0 for GL_TEXTURE0
+	 */
+	static unsigned int GetActiveTexture();
+
+	/**
+	 *	These must be called when the object is deleted, as GL may give the same name to a new object
+	 */
+	static void OnDeleteProgram(unsigned int program);
+	static void OnDeleteVertexArray(unsigned int vertexArray);
+	static void OnDeleteBuffer(unsigned int buffer);
+	static void OnDeleteTexture(unsigned int texture);
+
+	/**
+	 *	@return a number that changes whenever a buffer is deleted, so code remembering buffer names
+	 *	can tell when one of them may have been given to a new buffer
+	 */
+	static unsigned int GetBufferGeneration();
+
+	/**
+	 *	Adds the names of the buffers deleted since a generation, so only what refers to them has to be dropped
+	 *	@return false if more buffers were deleted since then than are remembered, callers must assume any name changed
+	 */
+	static bool GetDeletedBuffers(unsigned int generation, std::vector<unsigned int>& buffers);
+
+	/**
+	 *	Forgets all shadowed state, so the next bind of everything goes to GL
+	 */
+	static void Invalidate();
+
+	static const Stats& GetStats();
+
+	static void ResetStats();
+};
@@ -0,0 +1,884 @@
+#include "GltfLoader.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include "JsonValue.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include "vendor/stb_image/stb_image.h"
+
+// "glTF", "JSON" and "BIN\0" read as little endian integers
+static const unsigned int GlbMagic = 0x46546C67;
+static const unsigned int GlbJsonChunk = 0x4E4F534A;
+static const unsigned int GlbBinChunk = 0x004E4942;
+
+static const float s_Identity[16] =
+{
+	1.0f, 0.0f, 0.0f, 0.0f,
+	0.0f, 1.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, 1.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, 1.0f
+};
+
+/**
+ *	Encoded bytes of an image, kept alive until it is decoded
+ */
+struct EncodedImage
+{
+	const unsigned char* Data = nullptr;
+	size_t Size = 0;
+	MappedFile File;
+	std::vector<unsigned char> Decoded;
+	// Why decoding failed, read right after stbi_load_from_memory on the decoding thread
+	const char* Error = "unknown error";
+};
+
+static bool Fail(const std::string& path, const std::string& message)
+{
+	std::cout << "glTF file '" << path << "': " << message << std::endl;
+	return false;
+}
+
+static inline bool IsIndex(int index, size_t count)
+{
+	return index >= 0 && (size_t)index < count;
+}
+
+static int Base64Value(char c)
+{
+	if (c >= 'A' && c <= 'Z') return c - 'A';
+	if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+	if (c >= '0' && c <= '9') return c - '0' + 52;
+	if (c == '+' || c == '-') return 62;
+	if (c == '/' || c == '_') return 63;
+	return -1;
+}
+
+/**
+ *	Decodes the data of a "data:...;base64," URI
+ *	@return false if uri is not a base64 data URI
+ */
+static bool DecodeDataUri(const std::string& uri, std::vector<unsigned char>& data)
+{
+	size_t start = uri.find(";base64,");
+	if (uri.compare(0, 5, "data:") != 0 || start == std::string::npos)
+	{
+		return false;
+	}
+
+	data.clear();
+	data.reserve((uri.size() - start) / 4 * 3);
+	unsigned int bits = 0;
+	unsigned int bitCount = 0;
+	for (size_t i = start + 8; i < uri.size(); i++)
+	{
+		int value = Base64Value(uri[i]);
+		// Padding ends the data
+		if (value < 0)
+		{
+			break;
+		}
+		bits = bits << 6 | value;
+		bitCount += 6;
+		if (bitCount >= 8)
+		{
+			bitCount -= 8;
+			data.push_back((unsigned char)(bits >> bitCount));
+		}
+	}
+	return true;
+}
+
+/**
+ *	Turns a relative URI into a path next to the glTF file, undoing %20 style escapes
+ */
+static std::string ResolveUri(const std::string& directory, const std::string& uri)
+{
+	std::string path = directory;
+	for (size_t i = 0; i < uri.size(); i++)
+	{
+		if (uri[i] == '%' && i + 2 < uri.size() && std::isxdigit((unsigned char)uri[i + 1]) && std::isxdigit((unsigned char)uri[i + 2]))
+		{
+			path += (char)std::stoi(uri.substr(i + 1, 2), nullptr, 16);
+			i += 2;
+		}
+		else
+		{
+			path += uri[i];
+		}
+	}
+	return path;
+}
+
+static unsigned int GetComponentCount(const std::string& type)
+{
+	if (type == "SCALAR") return 1;
+	if (type == "VEC2") return 2;
+	if (type == "VEC3") return 3;
+	if (type == "VEC4") return 4;
+	if (type == "MAT2") return 4;
+	if (type == "MAT3") return 9;
+	if (type == "MAT4") return 16;
+	return 0;
+}
+
+static void ReadNumbers(const JsonValue& array, float* values, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; i++)
+	{
+		values[i] = (float)array[i].GetNumber(values[i]);
+	}
+}
+
+static int ReadTextureIndex(const JsonValue& textureInfo)
+{
+	return textureInfo["index"].GetInt(-1);
+}
+
+static void Multiply(const float* a, const float* b, float* result)
+{
+	for (unsigned int column = 0; column < 4; column++)
+	{
+		for (unsigned int row = 0; row < 4; row++)
+		{
+			float sum = 0.0f;
+			for (unsigned int k = 0; k < 4; k++)
+			{
+				sum += a[k * 4 + row] * b[column * 4 + k];
+			}
+			result[column * 4 + row] = sum;
+		}
+	}
+}
+
+/**
+ *	Builds translation * rotation * scale, the rotation a unit quaternion x, y, z, w
+ */
+static void ComposeTransform(const float* t, const float* q, const float* s, float* matrix)
+{
+	float x = q[0], y = q[1], z = q[2], w = q[3];
+	const float rotation[9] =
+	{
+		1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + z * w), 2.0f * (x * z - y * w),
+		2.0f * (x * y - z * w), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + x * w),
+		2.0f * (x * z + y * w), 2.0f * (y * z - x * w), 1.0f - 2.0f * (x * x + y * y)
+	};
+	for (unsigned int column = 0; column < 3; column++)
+	{
+		for (unsigned int row = 0; row < 3; row++)
+		{
+			matrix[column * 4 + row] = rotation[column * 3 + row] * s[column];
+		}
+		matrix[column * 4 + 3] = 0.0f;
+	}
+	matrix[12] = t[0];
+	matrix[13] = t[1];
+	matrix[14] = t[2];
+	matrix[15] = 1.0f;
+}
+
+/**
+ *	Reads one component of any glTF component type as a float
+ */
+static float ReadComponent(const unsigned char* data, unsigned int componentType, bool normalized)
+{
+	switch (componentType)
+	{
+	case GL_FLOAT:
+	{
+		float value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+	case GL_UNSIGNED_BYTE:
+		return normalized ? *data / 255.0f : (float)*data;
+	case GL_BYTE:
+	{
+		float value = (float)(signed char)*data;
+		return normalized ? std::fmax(value / 127.0f, -1.0f) : value;
+	}
+	case GL_UNSIGNED_SHORT:
+	{
+		unsigned short value;
+		std::memcpy(&value, data, sizeof(value));
+		return normalized ? value / 65535.0f : (float)value;
+	}
+	case GL_SHORT:
+	{
+		short value;
+		std::memcpy(&value, data, sizeof(value));
+		return normalized ? std::fmax(value / 32767.0f, -1.0f) : (float)value;
+	}
+	case GL_UNSIGNED_INT:
+	{
+		unsigned int value;
+		std::memcpy(&value, data, sizeof(value));
+		return (float)value;
+	}
+	}
+	return 0.0f;
+}
+
+static unsigned int ReadInteger(const unsigned char* data, unsigned int componentType)
+{
+	switch (componentType)
+	{
+	case GL_UNSIGNED_BYTE:
+		return *data;
+	case GL_UNSIGNED_SHORT:
+	{
+		unsigned short value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+	case GL_UNSIGNED_INT:
+	{
+		unsigned int value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+	}
+	return (unsigned int)ReadComponent(data, componentType, false);
+}
+
+unsigned int GltfLoader::GetComponentSize(unsigned int componentType)
+{
+	switch (componentType)
+	{
+	case GL_BYTE:
+	case GL_UNSIGNED_BYTE:
+		return 1;
+	case GL_SHORT:
+	case GL_UNSIGNED_SHORT:
+		return 2;
+	case GL_UNSIGNED_INT:
+	case GL_FLOAT:
+		return 4;
+	}
+	return 0;
+}
+
+const unsigned char * GltfAsset::GetAccessorData(const GltfAccessor & accessor) const
+{
+	if (accessor.BufferView < 0)
+	{
+		return nullptr;
+	}
+	const GltfBufferView& view = BufferViews[accessor.BufferView];
+	return Buffers[view.Buffer].Data + view.ByteOffset + accessor.ByteOffset;
+}
+
+unsigned int GltfAsset::GetAccessorStride(const GltfAccessor & accessor) const
+{
+	if (accessor.BufferView >= 0 && BufferViews[accessor.BufferView].ByteStride)
+	{
+		return BufferViews[accessor.BufferView].ByteStride;
+	}
+	return accessor.Components * GltfLoader::GetComponentSize(accessor.ComponentType);
+}
+
+void GltfAsset::ReadFloats(const GltfAccessor & accessor, std::vector<float>& values) const
+{
+	unsigned int components = accessor.Components;
+	unsigned int componentSize = GltfLoader::GetComponentSize(accessor.ComponentType);
+	values.assign((size_t)accessor.Count * components, 0.0f);
+
+	const unsigned char* data = GetAccessorData(accessor);
+	if (data)
+	{
+		unsigned int stride = GetAccessorStride(accessor);
+		for (unsigned int i = 0; i < accessor.Count; i++)
+		{
+			for (unsigned int c = 0; c < components; c++)
+			{
+				values[(size_t)i * components + c] = ReadComponent(data + (size_t)i * stride + c * componentSize,
+					accessor.ComponentType, accessor.Normalized);
+			}
+		}
+	}
+
+	if (accessor.SparseCount)
+	{
+		const GltfBufferView& indexView = BufferViews[accessor.SparseIndicesView];
+		const GltfBufferView& valueView = BufferViews[accessor.SparseValuesView];
+		const unsigned char* indices = Buffers[indexView.Buffer].Data + indexView.ByteOffset + accessor.SparseIndicesOffset;
+		const unsigned char* sparseValues = Buffers[valueView.Buffer].Data + valueView.ByteOffset + accessor.SparseValuesOffset;
+		unsigned int indexSize = GltfLoader::GetComponentSize(accessor.SparseIndexType);
+		for (unsigned int i = 0; i < accessor.SparseCount; i++)
+		{
+			unsigned int element = ReadInteger(indices + (size_t)i * indexSize, accessor.SparseIndexType);
+			if (element >= accessor.Count)
+			{
+				continue;
+			}
+			for (unsigned int c = 0; c < components; c++)
+			{
+				values[(size_t)element * components + c] = ReadComponent(sparseValues + ((size_t)i * components + c) * componentSize,
+					accessor.ComponentType, accessor.Normalized);
+			}
+		}
+	}
+}
+
+void GltfAsset::ReadIndices(const GltfAccessor & accessor, std::vector<unsigned int>& values) const
+{
+	values.assign(accessor.Count, 0);
+
+	const unsigned char* data = GetAccessorData(accessor);
+	if (data)
+	{
+		unsigned int stride = GetAccessorStride(accessor);
+		for (unsigned int i = 0; i < accessor.Count; i++)
+		{
+			values[i] = ReadInteger(data + (size_t)i * stride, accessor.ComponentType);
+		}
+	}
+
+	if (accessor.SparseCount)
+	{
+		const GltfBufferView& indexView = BufferViews[accessor.SparseIndicesView];
+		const GltfBufferView& valueView = BufferViews[accessor.SparseValuesView];
+		const unsigned char* indices = Buffers[indexView.Buffer].Data + indexView.ByteOffset + accessor.SparseIndicesOffset;
+		const unsigned char* sparseValues = Buffers[valueView.Buffer].Data + valueView.ByteOffset + accessor.SparseValuesOffset;
+		unsigned int indexSize = GltfLoader::GetComponentSize(accessor.SparseIndexType);
+		unsigned int valueSize = GltfLoader::GetComponentSize(accessor.ComponentType);
+		for (unsigned int i = 0; i < accessor.SparseCount; i++)
+		{
+			unsigned int element = ReadInteger(indices + (size_t)i * indexSize, accessor.SparseIndexType);
+			if (element < accessor.Count)
+			{
+				values[element] = ReadInteger(sparseValues + (size_t)i * valueSize, accessor.ComponentType);
+			}
+		}
+	}
+}
+
+/**
+ *	@return true if size bytes from offset into a buffer view are inside it
+ */
+static bool IsInView(const GltfAsset& asset, int view, size_t offset, size_t size)
+{
+	if (!IsIndex(view, asset.BufferViews.size()))
+	{
+		return false;
+	}
+	size_t length = asset.BufferViews[view].ByteLength;
+	return offset <= length && size <= length - offset;
+}
+
+static bool ReadBuffers(const JsonValue& json, const std::string& path, const std::string& directory,
+	const unsigned char* glbData, size_t glbSize, GltfAsset& asset)
+{
+	const JsonValue& buffers = json["buffers"];
+	for (unsigned int i = 0; i < buffers.Size(); i++)
+	{
+		const JsonValue& buffer = buffers[i];
+		size_t byteLength = (size_t)buffer["byteLength"].GetNumber();
+		GltfBuffer result;
+
+		if (!buffer.Has("uri"))
+		{
+			// Only the first buffer of a .glb can be its binary chunk
+			if (i != 0 || !glbData)
+			{
+				return Fail(path, "buffer " + std::to_string(i) + " has no data");
+			}
+			result.Data = glbData;
+			result.Size = glbSize;
+		}
+		else
+		{
+			const std::string& uri = buffer["uri"].GetString();
+			std::vector<unsigned char> decoded;
+			if (DecodeDataUri(uri, decoded))
+			{
+				asset.DecodedData.push_back(std::move(decoded));
+				result.Data = asset.DecodedData.back().data();
+				result.Size = asset.DecodedData.back().size();
+			}
+			else
+			{
+				MappedFile file(ResolveUri(directory, uri));
+				if (!file.IsOpen())
+				{
+					return Fail(path, "could not open buffer '" + uri + "'");
+				}
+				result.Data = (const unsigned char*)file.GetData();
+				result.Size = file.GetSize();
+				asset.Files.push_back(std::move(file));
+			}
+		}
+
+		if (result.Size < byteLength)
+		{
+			return Fail(path, "buffer " + std::to_string(i) + " is shorter than its byteLength");
+		}
+		result.Size = byteLength;
+		asset.Buffers.push_back(result);
+	}
+
+	const JsonValue& views = json["bufferViews"];
+	for (unsigned int i = 0; i < views.Size(); i++)
+	{
+		const JsonValue& view = views[i];
+		GltfBufferView result;
+		result.Buffer = view["buffer"].GetInt(-1);
+		result.ByteOffset = (size_t)view["byteOffset"].GetNumber();
+		result.ByteLength = (size_t)view["byteLength"].GetNumber();
+		result.ByteStride = (unsigned int)view["byteStride"].GetInt();
+		if (!IsIndex(result.Buffer, asset.Buffers.size()) || result.ByteOffset > asset.Buffers[result.Buffer].Size ||
+			result.ByteLength > asset.Buffers[result.Buffer].Size - result.ByteOffset)
+		{
+			return Fail(path, "buffer view " + std::to_string(i) + " is outside its buffer");
+		}
+		asset.BufferViews.push_back(result);
+	}
+	return true;
+}
+
+static bool ReadAccessors(const JsonValue& json, const std::string& path, GltfAsset& asset)
+{
+	const JsonValue& accessors = json["accessors"];
+	for (unsigned int i = 0; i < accessors.Size(); i++)
+	{
+		const JsonValue& accessor = accessors[i];
+		GltfAccessor result;
+		result.BufferView = accessor["bufferView"].GetInt(-1);
+		result.ByteOffset = (size_t)accessor["byteOffset"].GetNumber();
+		result.ComponentType = (unsigned int)accessor["componentType"].GetInt();
+		result.Components = GetComponentCount(accessor["type"].GetString());
+		result.Count = (unsigned int)accessor["count"].GetNumber();
+		result.Normalized = accessor["normalized"].GetBool();
+
+		std::string name = "accessor " + std::to_string(i);
+		unsigned int componentSize = GltfLoader::GetComponentSize(result.ComponentType);
+		if (componentSize == 0 || result.Components == 0)
+		{
+			return Fail(path, name + " has an unknown type");
+		}
+
+		size_t elementSize = (size_t)componentSize * result.Components;
+		if (result.BufferView >= 0 && result.Count > 0)
+		{
+			size_t stride = asset.BufferViews.size() > (size_t)result.BufferView && asset.BufferViews[result.BufferView].ByteStride ?
+				asset.BufferViews[result.BufferView].ByteStride : elementSize;
+			if (!IsInView(asset, result.BufferView, result.ByteOffset, stride * (result.Count - 1) + elementSize))
+			{
+				return Fail(path, name + " is outside its buffer view");
+			}
+		}
+
+		const JsonValue& sparse = accessor["sparse"];
+		if (!sparse.IsNull())
+		{
+			result.SparseCount = (unsigned int)sparse["count"].GetNumber();
+			result.SparseIndicesView = sparse["indices"]["bufferView"].GetInt(-1);
+			result.SparseIndicesOffset = (size_t)sparse["indices"]["byteOffset"].GetNumber();
+			result.SparseIndexType = (unsigned int)sparse["indices"]["componentType"].GetInt();
+			result.SparseValuesView = sparse["values"]["bufferView"].GetInt(-1);
+			result.SparseValuesOffset = (size_t)sparse["values"]["byteOffset"].GetNumber();
+
+			unsigned int indexSize = GltfLoader::GetComponentSize(result.SparseIndexType);
+			if (indexSize == 0 ||
+				!IsInView(asset, result.SparseIndicesView, result.SparseIndicesOffset, (size_t)result.SparseCount * indexSize) ||
+				!IsInView(asset, result.SparseValuesView, result.SparseValuesOffset, (size_t)result.SparseCount * elementSize))
+			{
+				return Fail(path, name + " has sparse data outside its buffer views");
+			}
+		}
+		asset.Accessors.push_back(result);
+	}
+	return true;
+}
+
+static bool ReadMaterials(const JsonValue& json, const std::string& path, GltfAsset& asset)
+{
+	const JsonValue& samplers = json["samplers"];
+	const JsonValue& textures = json["textures"];
+	for (unsigned int i = 0; i < textures.Size(); i++)
+	{
+		GltfTexture result;
+		// Without a source the image only comes from an extension, e.g. KHR_texture_basisu, the texture is then left out
+		result.Image = textures[i]["source"].GetInt(-1);
+		if (textures[i].Has("source") && !IsIndex(result.Image, asset.Images.size()))
+		{
+			return Fail(path, "texture " + std::to_string(i) + " refers to a missing image");
+		}
+		const JsonValue& sampler = samplers[textures[i]["sampler"].GetInt(-1)];
+		result.WrapS = (unsigned int)sampler["wrapS"].GetInt(GL_REPEAT);
+		result.WrapT = (unsigned int)sampler["wrapT"].GetInt(GL_REPEAT);
+		asset.Textures.push_back(result);
+	}
+
+	const JsonValue& materials = json["materials"];
+	for (unsigned int i = 0; i < materials.Size(); i++)
+	{
+		const JsonValue& material = materials[i];
+		const JsonValue& pbr = material["pbrMetallicRoughness"];
+		GltfMaterial result;
+		result.Name = material["name"].GetString();
+		ReadNumbers(pbr["baseColorFactor"], result.BaseColorFactor, 4);
+		result.BaseColorTexture = ReadTextureIndex(pbr["baseColorTexture"]);
+		result.MetallicFactor = (float)pbr["metallicFactor"].GetNumber(1.0);
+		result.RoughnessFactor = (float)pbr["roughnessFactor"].GetNumber(1.0);
+		result.MetallicRoughnessTexture = ReadTextureIndex(pbr["metallicRoughnessTexture"]);
+		result.NormalTexture = ReadTextureIndex(material["normalTexture"]);
+		result.NormalScale = (float)material["normalTexture"]["scale"].GetNumber(1.0);
+		result.OcclusionTexture = ReadTextureIndex(material["occlusionTexture"]);
+		result.OcclusionStrength = (float)material["occlusionTexture"]["strength"].GetNumber(1.0);
+		result.EmissiveTexture = ReadTextureIndex(material["emissiveTexture"]);
+		ReadNumbers(material["emissiveFactor"], result.EmissiveFactor, 3);
+		const std::string& alphaMode = material["alphaMode"].GetString();
+		result.Alpha = alphaMode == "MASK" ? GltfMaterial::AlphaMode::Mask :
+			alphaMode == "BLEND" ? GltfMaterial::AlphaMode::Blend : GltfMaterial::AlphaMode::Opaque;
+		result.AlphaCutoff = (float)material["alphaCutoff"].GetNumber(0.5);
+		result.DoubleSided = material["doubleSided"].GetBool();
+
+		int textureIndices[] = { result.BaseColorTexture, result.MetallicRoughnessTexture, result.NormalTexture,
+			result.OcclusionTexture, result.EmissiveTexture };
+		for (int texture : textureIndices)
+		{
+			if (texture != -1 && !IsIndex(texture, asset.Textures.size()))
+			{
+				return Fail(path, "material " + std::to_string(i) + " refers to a missing texture");
+			}
+		}
+		asset.Materials.push_back(result);
+	}
+	return true;
+}
+
+static bool ReadMeshes(const JsonValue& json, const std::string& path, GltfAsset& asset)
+{
+	const JsonValue& meshes = json["meshes"];
+	for (unsigned int i = 0; i < meshes.Size(); i++)
+	{
+		GltfMesh result;
+		result.Name = meshes[i]["name"].GetString();
+		const JsonValue& primitives = meshes[i]["primitives"];
+		for (unsigned int p = 0; p < primitives.Size(); p++)
+		{
+			const JsonValue& primitive = primitives[p];
+			GltfPrimitive resultPrimitive;
+			resultPrimitive.Indices = primitive["indices"].GetInt(-1);
+			resultPrimitive.Material = primitive["material"].GetInt(-1);
+			resultPrimitive.Mode = (unsigned int)primitive["mode"].GetInt(GL_TRIANGLES);
+			for (const auto& attribute : primitive["attributes"].GetMembers())
+			{
+				resultPrimitive.Attributes.push_back({ attribute.first, attribute.second.GetInt(-1) });
+				if (!IsIndex(resultPrimitive.Attributes.back().Accessor, asset.Accessors.size()))
+				{
+					return Fail(path, "mesh " + std::to_string(i) + " refers to a missing accessor");
+				}
+			}
+
+			if ((resultPrimitive.Indices != -1 && !IsIndex(resultPrimitive.Indices, asset.Accessors.size())) ||
+				(resultPrimitive.Material != -1 && !IsIndex(resultPrimitive.Material, asset.Materials.size())))
+			{
+				return Fail(path, "mesh " + std::to_string(i) + " refers to a missing accessor or material");
+			}
+			result.Primitives.push_back(resultPrimitive);
+		}
+		asset.Meshes.push_back(std::move(result));
+	}
+	return true;
+}
+
+static bool ReadNodes(const JsonValue& json, const std::string& path, GltfAsset& asset)
+{
+	const JsonValue& nodes = json["nodes"];
+	asset.Nodes.resize(nodes.Size());
+	for (unsigned int i = 0; i < nodes.Size(); i++)
+	{
+		const JsonValue& node = nodes[i];
+		GltfNode& result = asset.Nodes[i];
+		result.Name = node["name"].GetString();
+		result.Mesh = node["mesh"].GetInt(-1);
+		if (result.Mesh != -1 && !IsIndex(result.Mesh, asset.Meshes.size()))
+		{
+			return Fail(path, "node " + std::to_string(i) + " refers to a missing mesh");
+		}
+
+		if (node.Has("matrix"))
+		{
+			std::memcpy(result.Local, s_Identity, sizeof(s_Identity));
+			ReadNumbers(node["matrix"], result.Local, 16);
+		}
+		else
+		{
+			float translation[3] = { 0.0f, 0.0f, 0.0f };
+			float rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+			float scale[3] = { 1.0f, 1.0f, 1.0f };
+			ReadNumbers(node["translation"], translation, 3);
+			ReadNumbers(node["rotation"], rotation, 4);
+			ReadNumbers(node["scale"], scale, 3);
+			ComposeTransform(translation, rotation, scale, result.Local);
+		}
+
+		const JsonValue& children = node["children"];
+		for (unsigned int c = 0; c < children.Size(); c++)
+		{
+			int child = children[c].GetInt(-1);
+			if (!IsIndex(child, nodes.Size()) || asset.Nodes[child].Parent != -1 || child == (int)i)
+			{
+				return Fail(path, "node " + std::to_string(i) + " has a missing child or one with two parents");
+			}
+			asset.Nodes[child].Parent = i;
+			result.Children.push_back(child);
+		}
+	}
+
+	// Parents before children, starting from every node without a parent
+	std::vector<int> stack;
+	unsigned int visited = 0;
+	for (unsigned int i = 0; i < asset.Nodes.size(); i++)
+	{
+		if (asset.Nodes[i].Parent == -1)
+		{
+			stack.push_back(i);
+		}
+	}
+	while (!stack.empty())
+	{
+		GltfNode& node = asset.Nodes[stack.back()];
+		stack.pop_back();
+		visited++;
+		if (node.Parent == -1)
+		{
+			std::memcpy(node.World, node.Local, sizeof(node.World));
+		}
+		else
+		{
+			Multiply(asset.Nodes[node.Parent].World, node.Local, node.World);
+		}
+		stack.insert(stack.end(), node.Children.begin(), node.Children.end());
+	}
+	if (visited != asset.Nodes.size())
+	{
+		return Fail(path, "the node hierarchy has a cycle");
+	}
+
+	const JsonValue& scenes = json["scenes"];
+	for (unsigned int i = 0; i < scenes.Size(); i++)
+	{
+		GltfScene result;
+		result.Name = scenes[i]["name"].GetString();
+		const JsonValue& roots = scenes[i]["nodes"];
+		for (unsigned int r = 0; r < roots.Size(); r++)
+		{
+			int root = roots[r].GetInt(-1);
+			if (!IsIndex(root, asset.Nodes.size()))
+			{
+				return Fail(path, "scene " + std::to_string(i) + " refers to a missing node");
+			}
+			result.Nodes.push_back(root);
+		}
+		asset.Scenes.push_back(std::move(result));
+	}
+	asset.Scene = json["scene"].GetInt(asset.Scenes.empty() ? -1 : 0);
+	if (asset.Scene != -1 && !IsIndex(asset.Scene, asset.Scenes.size()))
+	{
+		return Fail(path, "the default scene is missing");
+	}
+	return true;
+}
+
+/**
+ *	Finds the encoded bytes of every image and decodes them, one task per image
+ */
+static bool ReadImages(const JsonValue& json, const std::string& path, const std::string& directory, GltfAsset& asset, ThreadPool* pool)
+{
+	const JsonValue& images = json["images"];
+	std::vector<EncodedImage> encoded(images.Size());
+	asset.Images.resize(images.Size());
+	for (unsigned int i = 0; i < images.Size(); i++)
+	{
+		const JsonValue& image = images[i];
+		EncodedImage& source = encoded[i];
+		asset.Images[i].Name = image["name"].GetString();
+
+		if (image.Has("bufferView"))
+		{
+			int view = image["bufferView"].GetInt(-1);
+			if (!IsIndex(view, asset.BufferViews.size()))
+			{
+				return Fail(path, "image " + std::to_string(i) + " refers to a missing buffer view");
+			}
+			source.Data = asset.Buffers[asset.BufferViews[view].Buffer].Data + asset.BufferViews[view].ByteOffset;
+			source.Size = asset.BufferViews[view].ByteLength;
+		}
+		else
+		{
+			const std::string& uri = image["uri"].GetString();
+			if (DecodeDataUri(uri, source.Decoded))
+			{
+				source.Data = source.Decoded.data();
+				source.Size = source.Decoded.size();
+			}
+			else if (source.File.Open(ResolveUri(directory, uri)))
+			{
+				source.Data = (const unsigned char*)source.File.GetData();
+				source.Size = source.File.GetSize();
+			}
+			else
+			{
+				return Fail(path, "could not open image '" + uri + "'");
+			}
+		}
+	}
+
+	// glTF puts the top row at v = 0, so the rows stay in file order, which is how stb_image decodes them
+	// as long as nothing sets stbi_set_flip_vertically_on_load
+	auto decode = [&encoded, &asset](unsigned int first, unsigned int last)
+	{
+		for (unsigned int i = first; i < last; i++)
+		{
+			GltfImage& image = asset.Images[i];
+			int channels;
+			unsigned char* pixels = stbi_load_from_memory(encoded[i].Data, (int)encoded[i].Size, &image.Width, &image.Height, &channels, 4);
+			if (pixels)
+			{
+				image.Pixels.assign(pixels, pixels + (size_t)image.Width * image.Height * 4);
+				stbi_image_free(pixels);
+			}
+			else
+			{
+				// stb_image keeps one reason for the whole process, a decode on another thread may still replace it
+				const char* reason = stbi_failure_reason();
+				if (reason)
+				{
+					encoded[i].Error = reason;
+				}
+				image.Width = 0;
+				image.Height = 0;
+			}
+		}
+	};
+	if (pool && images.Size() > 1)
+	{
+		// One task per image rather than ParallelFor's one range per worker, images differ a lot in size
+		std::vector<std::future<void>> results;
+		for (unsigned int i = 0; i < images.Size(); i++)
+		{
+			results.push_back(pool->Enqueue([&decode, i]() { decode(i, i + 1); }));
+		}
+		// The tasks refer to decode and encoded, so all of them must finish before an exception leaves this scope
+		for (std::future<void>& result : results)
+		{
+			result.wait();
+		}
+		for (std::future<void>& result : results)
+		{
+			result.get();
+		}
+	}
+	else
+	{
+		decode(0, images.Size());
+	}
+
+	for (unsigned int i = 0; i < images.Size(); i++)
+	{
+		if (asset.Images[i].Pixels.empty())
+		{
+			std::cout << "glTF file '" << path << "': could not decode image " << i << ", " << encoded[i].Error << std::endl;
+		}
+	}
+	return true;
+}
+
+bool GltfLoader::Load(const std::string & path, GltfAsset & asset, ThreadPool * pool)
+{
+	PROFILE_SCOPE("GltfLoader::Load");
+
+	asset = GltfAsset();
+
+	MappedFile file(path);
+	if (!file.IsOpen())
+	{
+		return Fail(path, "could not open the file");
+	}
+
+	const char* jsonText = file.GetData();
+	size_t jsonSize = file.GetSize();
+	const unsigned char* binData = nullptr;
+	size_t binSize = 0;
+
+	// A .glb is a 12 byte header and chunks of 8 byte headers, JSON first and then optionally the buffer
+	unsigned int header[3] = {};
+	if (file.GetSize() >= sizeof(header))
+	{
+		std::memcpy(header, file.GetData(), sizeof(header));
+	}
+	bool binary = header[0] == GlbMagic;
+	if (binary)
+	{
+		if (header[1] != 2 || header[2] > file.GetSize())
+		{
+			return Fail(path, "not a glTF 2.0 binary file");
+		}
+
+		size_t offset = sizeof(header);
+		while (offset + 8 <= header[2])
+		{
+			unsigned int chunk[2];
+			std::memcpy(chunk, file.GetData() + offset, sizeof(chunk));
+			offset += sizeof(chunk);
+			if (chunk[0] > header[2] - offset)
+			{
+				return Fail(path, "a chunk is longer than the file");
+			}
+			if (chunk[1] == GlbJsonChunk && offset == sizeof(header) + 8)
+			{
+				jsonText = file.GetData() + offset;
+				jsonSize = chunk[0];
+			}
+			else if (chunk[1] == GlbBinChunk && !binData)
+			{
+				binData = (const unsigned char*)file.GetData() + offset;
+				binSize = chunk[0];
+			}
+			// Chunks are padded to 4 bytes
+			offset += (chunk[0] + 3) & ~3u;
+		}
+		if (jsonText == file.GetData())
+		{
+			return Fail(path, "the JSON chunk is missing");
+		}
+	}
+
+	JsonValue json;
+	std::string error;
+	if (!JsonValue::Parse(jsonText, jsonSize, json, error))
+	{
+		return Fail(path, error);
+	}
+	if (json["asset"]["version"].GetString().compare(0, 2, "2.") != 0)
+	{
+		return Fail(path, "only glTF 2.0 is supported");
+	}
+
+	size_t slash = path.find_last_of("/\\");
+	std::string directory = slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+
+	if (!ReadBuffers(json, path, directory, binData, binSize, asset) ||
+		!ReadAccessors(json, path, asset) ||
+		!ReadImages(json, path, directory, asset, pool) ||
+		!ReadMaterials(json, path, asset) ||
+		!ReadMeshes(json, path, asset) ||
+		!ReadNodes(json, path, asset))
+	{
+		asset = GltfAsset();
+		return false;
+	}
+
+	// Buffer 0 points into the .glb
+	if (binary)
+	{
+		asset.Files.push_back(std::move(file));
+	}
+	return true;
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "MappedFile.h"
+
+class ThreadPool;
+
+/**
+ *	Bytes of a glTF buffer, inside a mapped .bin or .glb file or a decoded data: URI
+ */
+struct GltfBuffer
+{
+	const unsigned char* Data = nullptr;
+	size_t Size = 0;
+};
+
+struct GltfBufferView
+{
+	int Buffer = -1;
+	size_t ByteOffset = 0;
+	size_t ByteLength = 0;
+	// 0 when the elements of the accessors using this view are tightly packed
+	unsigned int ByteStride = 0;
+};
+
+/**
+ *	A typed view into a buffer view, e.g. the positions of a primitive
+ */
+struct GltfAccessor
+{
+	// -1 when the values all start as zero, only set by sparse substitution
+	int BufferView = -1;
+	size_t ByteOffset = 0;
+	// GL_BYTE, GL_UNSIGNED_BYTE, GL_SHORT, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT or GL_FLOAT
+	unsigned int ComponentType = 0;
+	// Components per element: 1 for SCALAR up to 4 for VEC4, 16 for MAT4
+	unsigned int Components = 0;
+	unsigned int Count = 0;
+	bool Normalized = false;
+
+	// Elements replaced by the sparse section, stored as indices and values in two buffer views
+	unsigned int SparseCount = 0;
+	int SparseIndicesView = -1;
+	size_t SparseIndicesOffset = 0;
+	unsigned int SparseIndexType = 0;
+	int SparseValuesView = -1;
+	size_t SparseValuesOffset = 0;
+};
+
+struct GltfAttribute
+{
+	// e.g. POSITION, NORMAL, TEXCOORD_0
+	std::string Semantic;
+	int Accessor = -1;
+};
+
+struct GltfPrimitive
+{
+	std::vector<GltfAttribute> Attributes;
+	// -1 for primitives drawn without indices
+	int Indices = -1;
+	int Material = -1;
+	// GL_TRIANGLES, GL_TRIANGLE_STRIP, ... glTF uses the GL values
+	unsigned int Mode = GL_TRIANGLES;
+};
+
+struct GltfMesh
+{
+	std::string Name;
+	std::vector<GltfPrimitive> Primitives;
+};
+
+struct GltfMaterial
+{
+	enum class AlphaMode
+	{
+		Opaque, Mask, Blend
+	};
+
+	std::string Name;
+	float BaseColorFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	// Indices into GltfAsset::Textures, or -1
+	int BaseColorTexture = -1;
+	float MetallicFactor = 1.0f;
+	float RoughnessFactor = 1.0f;
+	int MetallicRoughnessTexture = -1;
+	int NormalTexture = -1;
+	float NormalScale = 1.0f;
+	int OcclusionTexture = -1;
+	float OcclusionStrength = 1.0f;
+	int EmissiveTexture = -1;
+	float EmissiveFactor[3] = { 0.0f, 0.0f, 0.0f };
+	AlphaMode Alpha = AlphaMode::Opaque;
+	float AlphaCutoff = 0.5f;
+	bool DoubleSided = false;
+};
+
+struct GltfTexture
+{
+	// -1 when the texture has no source, as its image is only given by an extension
+	int Image = -1;
+	// GL_REPEAT, GL_MIRRORED_REPEAT or GL_CLAMP_TO_EDGE, from the texture's sampler
+	unsigned int WrapS = GL_REPEAT;
+	unsigned int WrapT = GL_REPEAT;
+};
+
+/**
+ *	A decoded image
+ */
+struct GltfImage
+{
+	std::string Name;
+	int Width = 0;
+	int Height = 0;
+	// Width * Height RGBA8 pixels, the top row of the image first, which glTF puts at v = 0.
+	// Empty if the image could not be decoded.
+	std::vector<unsigned char> Pixels;
+};
+
+struct GltfNode
+{
+	std::string Name;
+	int Parent = -1;
+	std::vector<int> Children;
+	int Mesh = -1;
+	// Column major, relative to the parent
+	float Local[16];
+	// Column major, Local combined with every parent's
+	float World[16];
+};
+
+struct GltfScene
+{
+	std::string Name;
+	// The root nodes
+	std::vector<int> Nodes;
+};
+
+/**
+ *	Everything in a glTF 2.0 file, read into memory but not yet handed to GL, see GltfModel for that.
+ *	Buffers stay in the mapped files, so accessors are read where they are.
+ */
+struct GltfAsset
+{
+	std::vector<GltfBuffer> Buffers;
+	std::vector<GltfBufferView> BufferViews;
+	std::vector<GltfAccessor> Accessors;
+	std::vector<GltfMesh> Meshes;
+	std::vector<GltfMaterial> Materials;
+	std::vector<GltfTexture> Textures;
+	std::vector<GltfImage> Images;
+	std::vector<GltfNode> Nodes;
+	std::vector<GltfScene> Scenes;
+	// The scene to show, -1 if the file does not say
+	int Scene = -1;
+
+	// Keep the buffers' memory alive
+	std::vector<MappedFile> Files;
+	std::vector<std::vector<unsigned char>> DecodedData;
+
+	GltfAsset() = default;
+	GltfAsset(const GltfAsset&) = delete;
+	GltfAsset& operator=(const GltfAsset&) = delete;
+	GltfAsset(GltfAsset&&) = default;
+	GltfAsset& operator=(GltfAsset&&) = default;
+
+	/**
+	 *	@return the first byte of an accessor's first element, or null if it has no buffer view
+	 */
+	const unsigned char* GetAccessorData(const GltfAccessor& accessor) const;
+
+	/**
+	 *	@return the bytes from one element of an accessor to the next
+	 */
+	unsigned int GetAccessorStride(const GltfAccessor& accessor) const;
+
+	/**
+	 *	Reads an accessor as floats, applying normalisation and sparse substitution
+	 *	@param values Receives Count * Components floats
+	 */
+	void ReadFloats(const GltfAccessor& accessor, std::vector<float>& values) const;
+
+	/**
+	 *	Reads a scalar integer accessor, e.g. indices, applying sparse substitution
+	 */
+	void ReadIndices(const GltfAccessor& accessor, std::vector<unsigned int>& values) const;
+};
+
+/**
+ *	Reads glTF 2.0 files, either .gltf JSON with its buffers and images in separate files or data: URIs,
+ *	or a binary .glb. Buffers are memory mapped rather than read, and images are decoded on a ThreadPool.
+ *	Extensions are ignored, so compressed meshes or textures (Draco, KTX2) are not supported.
+ */
+class GltfLoader
+{
+public:
+	/**
+	 *	@param pool Workers to decode images with, or null to decode on the calling thread. Not from one of its own tasks.
+	 *	@return false if the file can not be read, is not glTF 2.0, or refers to data it does not have
+	 */
+	static bool Load(const std::string& path, GltfAsset& asset, ThreadPool* pool = nullptr);
+
+	/**
+	 *	@return the number of bytes of one component of a GL component type
+	 */
+	static unsigned int GetComponentSize(unsigned int componentType);
+};
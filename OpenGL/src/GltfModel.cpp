@@ -0,0 +1,219 @@
+#include "GltfModel.h"
+
+#include <iostream>
+
+#include "GltfLoader.h"
+#include "Profiler.h"
+#include "Renderer.h"
+#include "Shader.h"
+#include "VertexBufferLayout.h"
+
+/**
+ *	Turns strip or fan indices into a triangle list, keeping the winding glTF gives each triangle
+ */
+static void ToTriangleList(unsigned int mode, const std::vector<unsigned int>& indices, std::vector<unsigned int>& triangles)
+{
+	triangles.clear();
+	if (indices.size() < 3)
+	{
+		return;
+	}
+
+	unsigned int count = (unsigned int)indices.size() - 2;
+	triangles.reserve((size_t)count * 3);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (mode == GL_TRIANGLE_FAN)
+		{
+			triangles.push_back(indices[i + 1]);
+			triangles.push_back(indices[i + 2]);
+			triangles.push_back(indices[0]);
+		}
+		else
+		{
+			triangles.push_back(indices[i]);
+			triangles.push_back(indices[i + 1 + i % 2]);
+			triangles.push_back(indices[i + 2 - i % 2]);
+		}
+	}
+}
+
+int GltfModel::GetAttributeLocation(const std::string & semantic)
+{
+	static const char* const semantics[] =
+	{
+		"POSITION", "TEXCOORD_0", "NORMAL", "TANGENT", "COLOR_0", "TEXCOORD_1", "JOINTS_0", "WEIGHTS_0"
+	};
+	for (int i = 0; i < (int)(sizeof(semantics) / sizeof(semantics[0])); i++)
+	{
+		if (semantic == semantics[i])
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+GltfModel::GltfModel(const GltfAsset & asset)
+{
+	PROFILE_SCOPE("GltfModel::GltfModel");
+
+	m_TextureIndices.assign(asset.Textures.size(), -1);
+	for (unsigned int i = 0; i < asset.Textures.size(); i++)
+	{
+		if (asset.Textures[i].Image < 0)
+		{
+			continue;
+		}
+		const GltfImage& image = asset.Images[asset.Textures[i].Image];
+		if (image.Pixels.empty())
+		{
+			continue;
+		}
+		m_TextureIndices[i] = (int)m_Textures.size();
+		m_Textures.emplace_back(image.Pixels.data(), image.Width, image.Height);
+		m_Textures.back().SetWrap(asset.Textures[i].WrapS, asset.Textures[i].WrapT);
+	}
+
+	// The vertex buffer of each buffer view, uploaded the first time an attribute reads from it
+	std::vector<int> viewBuffers(asset.BufferViews.size(), -1);
+	std::vector<unsigned int> indices;
+	std::vector<unsigned int> triangles;
+	std::vector<float> values;
+
+	for (unsigned int m = 0; m < asset.Meshes.size(); m++)
+	{
+		Mesh mesh = { (unsigned int)m_Primitives.size(), 0 };
+		for (const GltfPrimitive& primitive : asset.Meshes[m].Primitives)
+		{
+			if (primitive.Mode != GL_TRIANGLES && primitive.Mode != GL_TRIANGLE_STRIP && primitive.Mode != GL_TRIANGLE_FAN)
+			{
+				std::cout << "glTF mesh " << m << ": skipping a primitive of points or lines" << std::endl;
+				continue;
+			}
+
+			const GltfAttribute* position = nullptr;
+			for (const GltfAttribute& attribute : primitive.Attributes)
+			{
+				if (attribute.Semantic == "POSITION")
+				{
+					position = &attribute;
+				}
+			}
+			if (!position)
+			{
+				continue;
+			}
+
+			// Triangle lists of 16 or 32 bit indices are uploaded from the file, the rest is read first
+			bool direct = false;
+			if (primitive.Indices >= 0)
+			{
+				const GltfAccessor& accessor = asset.Accessors[primitive.Indices];
+				if (primitive.Mode == GL_TRIANGLES && accessor.BufferView >= 0 && !accessor.SparseCount &&
+					(accessor.ComponentType == GL_UNSIGNED_SHORT || accessor.ComponentType == GL_UNSIGNED_INT))
+				{
+					direct = true;
+					if (accessor.Count == 0)
+					{
+						continue;
+					}
+					if (accessor.ComponentType == GL_UNSIGNED_SHORT)
+					{
+						m_IndexBuffers.emplace_back((const unsigned short*)asset.GetAccessorData(accessor), accessor.Count);
+					}
+					else
+					{
+						m_IndexBuffers.emplace_back((const unsigned int*)asset.GetAccessorData(accessor), accessor.Count);
+					}
+				}
+				else
+				{
+					asset.ReadIndices(accessor, indices);
+				}
+			}
+			else
+			{
+				indices.resize(asset.Accessors[position->Accessor].Count);
+				for (unsigned int i = 0; i < indices.size(); i++)
+				{
+					indices[i] = i;
+				}
+			}
+
+			if (!direct)
+			{
+				if (primitive.Mode != GL_TRIANGLES)
+				{
+					ToTriangleList(primitive.Mode, indices, triangles);
+					indices.swap(triangles);
+				}
+				indices.resize(indices.size() / 3 * 3);
+				if (indices.empty())
+				{
+					continue;
+				}
+				m_IndexBuffers.emplace_back(indices.data(), (unsigned int)indices.size());
+			}
+
+			m_VertexArrays.emplace_back();
+			VertexArray& va = m_VertexArrays.back();
+			for (const GltfAttribute& attribute : primitive.Attributes)
+			{
+				int location = GetAttributeLocation(attribute.Semantic);
+				const GltfAccessor& accessor = asset.Accessors[attribute.Accessor];
+				if (location < 0 || accessor.Components > 4)
+				{
+					continue;
+				}
+
+				VertexBufferLayout layout;
+				va.SetNextAttribute(location);
+				if (accessor.BufferView >= 0 && !accessor.SparseCount)
+				{
+					int& buffer = viewBuffers[accessor.BufferView];
+					if (buffer < 0)
+					{
+						const GltfBufferView& view = asset.BufferViews[accessor.BufferView];
+						buffer = (int)m_ViewBuffers.size();
+						m_ViewBuffers.emplace_back(asset.Buffers[view.Buffer].Data + view.ByteOffset, (unsigned int)view.ByteLength);
+					}
+					layout.PushElement({ accessor.ComponentType, accessor.Components, (unsigned char)accessor.Normalized, 0 },
+						(unsigned int)accessor.ByteOffset);
+					layout.SetStride(asset.GetAccessorStride(accessor));
+					va.AddBuffer(m_ViewBuffers[buffer], layout);
+				}
+				else
+				{
+					asset.ReadFloats(accessor, values);
+					m_RepackedBuffers.emplace_back(values.data(), (unsigned int)(values.size() * sizeof(float)));
+					layout.Push<float>(accessor.Components);
+					va.AddBuffer(m_RepackedBuffers.back(), layout);
+				}
+			}
+
+			int texture = -1;
+			if (primitive.Material >= 0 && asset.Materials[primitive.Material].BaseColorTexture >= 0)
+			{
+				texture = m_TextureIndices[asset.Materials[primitive.Material].BaseColorTexture];
+			}
+			m_Primitives.push_back({ (unsigned int)m_VertexArrays.size() - 1, (unsigned int)m_IndexBuffers.size() - 1, texture });
+			mesh.Count++;
+		}
+		m_Meshes.push_back(mesh);
+	}
+}
+
+void GltfModel::DrawMesh(Renderer & renderer, unsigned int mesh, const Shader & shader) const
+{
+	const Mesh& range = m_Meshes[mesh];
+	for (unsigned int i = range.First; i < range.First + range.Count; i++)
+	{
+		const Primitive& primitive = m_Primitives[i];
+		if (primitive.TextureIndex >= 0)
+		{
+			m_Textures[primitive.TextureIndex].Bind(0);
+		}
+		renderer.Draw(m_VertexArrays[primitive.VertexArrayIndex], m_IndexBuffers[primitive.IndexBufferIndex], shader);
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "IndexBuffer.h"
+#include "Texture.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+
+struct GltfAsset;
+class Renderer;
+class Shader;
+
+/**
+ *	The GL objects for the meshes and textures of a GltfAsset.
+ *	Every buffer view that vertex attributes read from is uploaded once, straight from the mapped file,
+ *	and the attributes point into it with the accessor's offset and the view's stride, so interleaved
+ *	or packed data is never rearranged on the CPU. Only sparse accessors and ones without a buffer view
+ *	are read into floats first.
+ *
+ *	Attributes are placed at fixed locations for shaders to declare:
+ *	POSITION 0, TEXCOORD_0 1, NORMAL 2, TANGENT 3, COLOR_0 4, TEXCOORD_1 5, JOINTS_0 6, WEIGHTS_0 7.
+ *	POSITION and TEXCOORD_0 are where Basic.shader reads them.
+ */
+class GltfModel
+{
+public:
+	/**
+	 *	Uploads everything, the asset can be destroyed afterwards
+	 */
+	GltfModel(const GltfAsset& asset);
+
+	GltfModel(const GltfModel&) = delete;
+	GltfModel& operator=(const GltfModel&) = delete;
+
+	/**
+	 *	Draws every primitive of a mesh with the base color texture of its material bound to slot 0.
+	 *	The shader's uniforms, e.g. the node's World matrix, are left to the caller.
+	 */
+	void DrawMesh(Renderer& renderer, unsigned int mesh, const Shader& shader) const;
+
+	/**
+	 *	@return the attribute location for a glTF semantic, or -1 for ones that are not drawn
+	 */
+	static int GetAttributeLocation(const std::string& semantic);
+
+	inline unsigned int GetMeshCount() const
+	{
+		return (unsigned int)m_Meshes.size();
+	}
+
+	/**
+	 *	@return the number of buffer views uploaded as they are in the file
+	 */
+	inline unsigned int GetUploadedViewCount() const
+	{
+		return (unsigned int)m_ViewBuffers.size();
+	}
+
+	/**
+	 *	@return the number of accessors that had to be converted to floats before uploading
+	 */
+	inline unsigned int GetRepackedAccessorCount() const
+	{
+		return (unsigned int)m_RepackedBuffers.size();
+	}
+
+private:
+	/**
+	 *	Indices into the vectors below, -1 when there is no texture
+	 */
+	struct Primitive
+	{
+		unsigned int VertexArrayIndex;
+		unsigned int IndexBufferIndex;
+		int TextureIndex;
+	};
+
+	/**
+	 *	A mesh's primitives, from First to First + Count in m_Primitives
+	 */
+	struct Mesh
+	{
+		unsigned int First;
+		unsigned int Count;
+	};
+
+	std::vector<VertexBuffer> m_ViewBuffers;
+	std::vector<VertexBuffer> m_RepackedBuffers;
+	std::vector<VertexArray> m_VertexArrays;
+	std::vector<IndexBuffer> m_IndexBuffers;
+	// One per GltfTexture, as textures sharing an image may still wrap differently
+	std::vector<Texture> m_Textures;
+	// Index into m_Textures for each GltfTexture, -1 where there is no image or it could not be decoded
+	std::vector<int> m_TextureIndices;
+	std::vector<Primitive> m_Primitives;
+	std::vector<Mesh> m_Meshes;
+};
@@ -1,38 +1,295 @@
 #include "IndexBuffer.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "Renderer.h"
+#include "GLState.h"
+#include "BufferArena.h"
+#include "GLNamePool.h"
 #include <GL/glew.h>
 
-IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
-	: m_Count(count)
+/**
+ *	@return GL_UNSIGNED_SHORT if every index fits into 16 bits, otherwise GL_UNSIGNED_INT
+ */
+static GLenum GetNarrowestType(const unsigned int* data, unsigned int count)
+{
+	unsigned int maxIndex = 0;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		maxIndex = std::max(maxIndex, data[i]);
+	}
+	return maxIndex <= 0xFFFF ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+/**
+ *	@return true if every index fits into the type
+ */
+static bool FitsType(const unsigned int* data, unsigned int count, GLenum type)
+{
+	unsigned int maxValue = type == GL_UNSIGNED_BYTE ? 0xFF : type == GL_UNSIGNED_SHORT ? 0xFFFF : 0xFFFFFFFF;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (data[i] > maxValue)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ *	Writes indices as the given type
+ *	@param out Room for count indices of the type
+ */
+static void ConvertIndices(const unsigned int* data, unsigned int count, GLenum type, void* out)
+{
+	switch (type)
+	{
+	case GL_UNSIGNED_BYTE:
+		for (unsigned int i = 0; i < count; i++)
+		{
+			ASSERT(data[i] <= 0xFF);
+			((unsigned char*)out)[i] = (unsigned char)data[i];
+		}
+		break;
+	case GL_UNSIGNED_SHORT:
+		for (unsigned int i = 0; i < count; i++)
+		{
+			ASSERT(data[i] <= 0xFFFF);
+			((unsigned short*)out)[i] = (unsigned short)data[i];
+		}
+		break;
+	default:
+		std::memcpy(out, data, count * sizeof(unsigned int));
+		break;
+	}
+}
+
+IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count, BufferUsage usage)
+	: m_Count(count), m_Arena(nullptr), m_Allocation(0), m_Usage(usage)
 {
 	// This is just to be cautious, these should be equal but it's possible they won't be
 	ASSERT(sizeof(unsigned int) == sizeof(GLuint));
 
-	// Generate a number (1) of buffers and bind their ID
-	GLCall(glGenBuffers(1, &m_RendererID));
-	// Bind this buffer, allowing us to draw on it
-	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
-	// Initialize the buffer and pass it data
-	GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW));
+	SetType(GetNarrowestType(data, count));
+	std::vector<unsigned char> indices(count * m_IndexSize);
+	ConvertIndices(data, count, m_Type, indices.data());
+	Create(indices.data(), count);
+}
+
+IndexBuffer::IndexBuffer(const unsigned short* data, unsigned int count, BufferUsage usage)
+	: m_Count(count), m_Arena(nullptr), m_Allocation(0), m_Usage(usage)
+{
+	SetType(GL_UNSIGNED_SHORT);
+	Create(data, count);
+}
+
+IndexBuffer::IndexBuffer(const unsigned char* data, unsigned int count, BufferUsage usage)
+	: m_Count(count), m_Arena(nullptr), m_Allocation(0), m_Usage(usage)
+{
+	SetType(GL_UNSIGNED_BYTE);
+	Create(data, count);
+}
+
+IndexBuffer::IndexBuffer(const void * data, unsigned int count, GLenum type, BufferUsage usage)
+	: m_Count(count), m_Arena(nullptr), m_Allocation(0), m_Usage(usage)
+{
+	ASSERT(type == GL_UNSIGNED_INT || type == GL_UNSIGNED_SHORT || type == GL_UNSIGNED_BYTE);
+	SetType(type);
+	Create(data, count);
+}
+
+IndexBuffer::IndexBuffer(BufferArena & arena, const unsigned int * data, unsigned int count)
+	: m_RendererID(arena.GetRendererID()), m_Count(count), m_Arena(&arena), m_Usage(BufferUsage::Static)
+{
+	SetType(GetNarrowestType(data, count));
+	std::vector<unsigned char> indices(count * m_IndexSize);
+	ConvertIndices(data, count, m_Type, indices.data());
+
+	m_Allocation = arena.Allocate(count * m_IndexSize, m_IndexSize, indices.data());
+	ASSERT(m_Allocation != BufferArena::InvalidAllocation);
 }
 
 IndexBuffer::~IndexBuffer()
 {
-	GLCall(glDeleteBuffers(1, &m_RendererID));
+	Release();
+}
+
+IndexBuffer::IndexBuffer(IndexBuffer && other) noexcept
+	: m_RendererID(other.m_RendererID), m_Count(other.m_Count), m_Type(other.m_Type), m_IndexSize(other.m_IndexSize),
+	m_Arena(other.m_Arena), m_Allocation(other.m_Allocation), m_Usage(other.m_Usage),
+	m_Shadow(std::move(other.m_Shadow)), m_Dirty(std::move(other.m_Dirty))
+{
+	other.m_RendererID = 0;
+	other.m_Arena = nullptr;
+}
+
+IndexBuffer & IndexBuffer::operator=(IndexBuffer && other) noexcept
+{
+	if (this != &other)
+	{
+		Release();
+		m_RendererID = other.m_RendererID;
+		m_Count = other.m_Count;
+		m_Type = other.m_Type;
+		m_IndexSize = other.m_IndexSize;
+		m_Arena = other.m_Arena;
+		m_Allocation = other.m_Allocation;
+		m_Usage = other.m_Usage;
+		m_Shadow = std::move(other.m_Shadow);
+		m_Dirty = std::move(other.m_Dirty);
+		other.m_RendererID = 0;
+		other.m_Arena = nullptr;
+	}
+	return *this;
 }
 
 void IndexBuffer::Bind() const
 {
-	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 }
 
 void IndexBuffer::UnBind() const
 {
-	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void IndexBuffer::SetData(const unsigned int * data, unsigned int count)
+{
+	if (m_Arena)
+	{
+		// The view's space and type are fixed
+		std::vector<unsigned char> indices(count * m_IndexSize);
+		ConvertIndices(data, count, m_Type, indices.data());
+		m_Arena->SetData(m_Allocation, indices.data(), (unsigned int)indices.size());
+		m_Count = count;
+		return;
+	}
+
+	GLenum type = GetNarrowestType(data, count);
+	bool resize = type != m_Type || count != m_Count;
+	SetType(type);
+	m_Count = count;
+
+	std::vector<unsigned char> indices(count * m_IndexSize);
+	ConvertIndices(data, count, m_Type, indices.data());
+
+	m_Dirty.Clear();
+	if (m_Usage != BufferUsage::Static)
+	{
+		m_Shadow = indices;
+	}
+
+	// Updates go through GL_COPY_WRITE_BUFFER, binding GL_ELEMENT_ARRAY_BUFFER would change the bound vertex array
+	GLState::BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+	if (m_Usage == BufferUsage::Static && !resize)
+	{
+		GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, 0, indices.size(), indices.data()));
+	}
+	else
+	{
+		// New storage, the old one is released once the GPU is done with it
+		GLCall(glBufferData(GL_COPY_WRITE_BUFFER, indices.size(), indices.data(), GetGLUsage(m_Usage)));
+	}
+}
+
+void IndexBuffer::SetSubData(const unsigned int * data, unsigned int count, unsigned int first)
+{
+	ASSERT(first + count <= m_Count);
+
+	unsigned int offset = first * m_IndexSize;
+	unsigned int size = count * m_IndexSize;
+
+	if (m_Usage != BufferUsage::Static && !m_Arena)
+	{
+		if (!FitsType(data, count, m_Type))
+		{
+			Widen(GetNarrowestType(data, count));
+			offset = first * m_IndexSize;
+			size = count * m_IndexSize;
+		}
+		ConvertIndices(data, count, m_Type, m_Shadow.data() + offset);
+		m_Dirty.Add(offset, size);
+		return;
+	}
+
+	std::vector<unsigned char> indices(size);
+	ConvertIndices(data, count, m_Type, indices.data());
+	if (m_Arena)
+	{
+		m_Arena->SetData(m_Allocation, indices.data(), size, offset);
+		return;
+	}
+
+	GLState::BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+	GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, indices.data()));
+}
+
+unsigned int IndexBuffer::Flush()
+{
+	if (m_Dirty.IsEmpty())
+	{
+		return 0;
+	}
+	GLState::BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+	return m_Dirty.Upload(GL_COPY_WRITE_BUFFER, m_Shadow.data(), m_Count * m_IndexSize, GetGLUsage(m_Usage));
+}
+
+unsigned int IndexBuffer::GetOffset() const
+{
+	return m_Arena ? m_Arena->GetOffset(m_Allocation) : 0;
+}
+
+void IndexBuffer::SetType(GLenum type)
+{
+	m_Type = type;
+	m_IndexSize = type == GL_UNSIGNED_BYTE ? 1 : type == GL_UNSIGNED_SHORT ? 2 : 4;
+}
+
+void IndexBuffer::Widen(GLenum type)
+{
+	std::vector<unsigned int> indices(m_Count);
+	for (unsigned int i = 0; i < m_Count; i++)
+	{
+		const unsigned char* index = m_Shadow.data() + i * m_IndexSize;
+		indices[i] = m_IndexSize == 1 ? *index : m_IndexSize == 2 ? *(const unsigned short*)index : *(const unsigned int*)index;
+	}
+
+	SetType(type);
+	m_Shadow.resize(m_Count * m_IndexSize);
+	ConvertIndices(indices.data(), m_Count, m_Type, m_Shadow.data());
+
+	// The whole buffer changes size, so the pending writes are part of this upload
+	m_Dirty.Clear();
+	GLState::BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+	GLCall(glBufferData(GL_COPY_WRITE_BUFFER, m_Shadow.size(), m_Shadow.data(), GetGLUsage(m_Usage)));
+}
+
+void IndexBuffer::Create(const void * data, unsigned int count)
+{
+	if (m_Usage != BufferUsage::Static)
+	{
+		m_Shadow.assign((const unsigned char*)data, (const unsigned char*)data + count * m_IndexSize);
+	}
+
+	// Take a buffer name from the pool and bind it
+	m_RendererID = GLNamePool::GenBuffer();
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+	// Initialize the buffer and pass it data
+	GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * m_IndexSize, data, GetGLUsage(m_Usage)));
 }
 
-inline unsigned int IndexBuffer::GetCount() const
+void IndexBuffer::Release()
 {
-	return m_Count;
+	if (m_Arena)
+	{
+		m_Arena->Free(m_Allocation);
+	}
+	else if (m_RendererID)
+	{
+		GLNamePool::ReleaseBuffer(m_RendererID);
+	}
+	m_RendererID = 0;
+	m_Arena = nullptr;
 }
@@ -1,21 +1,65 @@
 #pragma once
 
+#include <vector>
+
+#include "BufferUsage.h"
+#include "DirtyRanges.h"
+
+class BufferArena;
+
 class IndexBuffer
 {
 
 public:
 	/**
-	 *	Construct an Index Buffer
+	 *	Construct an Index Buffer, stored as GL_UNSIGNED_SHORT when every index fits into 16 bits
+	 *  @param data An array containing information on how vertices form edges between each other
+	 *  @param count The element count of the object
+	 *  @param usage How often the indices will change. Dynamic and Stream buffers keep a CPU copy for SetSubData.
+	 */
+	IndexBuffer(const unsigned int* data, unsigned int count, BufferUsage usage = BufferUsage::Static);
+
+	/**
+	 *	Construct an Index Buffer of GL_UNSIGNED_SHORT indices
+	 */
+	IndexBuffer(const unsigned short* data, unsigned int count, BufferUsage usage = BufferUsage::Static);
+
+	/**
+	 *	Construct an Index Buffer of GL_UNSIGNED_BYTE indices.
+	 *	Never picked automatically, as many GPUs cannot fetch byte indices and the driver widens them on the CPU.
+	 */
+	IndexBuffer(const unsigned char* data, unsigned int count, BufferUsage usage = BufferUsage::Static);
+
+	/**
+	 *	Construct an Index Buffer from indices already stored as the given type, uploaded as they are
+	 *	without being scanned or converted, e.g. straight from a mapped file
+	 *  @param type GL_UNSIGNED_INT, GL_UNSIGNED_SHORT or GL_UNSIGNED_BYTE
+	 */
+	IndexBuffer(const void* data, unsigned int count, GLenum type, BufferUsage usage = BufferUsage::Static);
+
+	/**
+	 *	Construct an Index Buffer that is a view into part of a BufferArena, sharing its GL buffer.
+	 *	The indices are narrowed the same way as for a buffer of its own.
+	 *  @param arena The arena to allocate from, must have been created for GL_ELEMENT_ARRAY_BUFFER and outlive this buffer
 	 *  @param data An array containing information on how vertices form edges between each other
 	 *  @param count The element count of the object
 	 */
-	IndexBuffer(const unsigned int* data, unsigned int count);
+	IndexBuffer(BufferArena& arena, const unsigned int* data, unsigned int count);
 
 	/**
-	 * Instruct OpenGL to delete this buffer
+	 * Instruct OpenGL to delete this buffer, or give the space back to the arena for a view
 	 */
 	~IndexBuffer();
 
+	IndexBuffer(const IndexBuffer&) = delete;
+	IndexBuffer& operator=(const IndexBuffer&) = delete;
+
+	/**
+	 * Moves the GL object to a new owner, leaving other empty
+	 */
+	IndexBuffer(IndexBuffer&& other) noexcept;
+	IndexBuffer& operator=(IndexBuffer&& other) noexcept;
+
 	/**
 	 *	Bind this buffer, allowing it to be drawn
 	 */
@@ -26,10 +70,83 @@ public:
 	 */
 	void UnBind() const;
 
+	/**
+	 *	Replace all indices, resizing the buffer and picking its type again if needed.
+	 *	Dynamic and Stream buffers are orphaned, so the upload does not wait for draws still using the old indices.
+	 *	Writes from SetSubData that were not flushed yet are dropped.
+	 *  @param data The new indices
+	 *  @param count The number of indices, for views it must not exceed the view's count and the
+	 *  indices must fit the view's type
+	 */
+	void SetData(const unsigned int* data, unsigned int count);
+
+	/**
+	 *	Replace some of the indices.
+	 *	For Dynamic and Stream buffers the write only goes to the CPU copy, and Flush uploads all writes
+	 *	since the last Flush together. Static buffers and views are updated straight away.
+	 *	A Dynamic or Stream buffer whose type is too narrow for the new indices is widened and uploaded
+	 *	again whole, so GetType may change.
+	 *  @param data The new indices, for Static buffers and views they must fit the buffer's type
+	 *  @param count The number of indices
+	 *  @param first The position of the first index to replace
+	 */
+	void SetSubData(const unsigned int* data, unsigned int count, unsigned int first);
+
+	/**
+	 *	Uploads the writes of SetSubData, merging nearby ones. Call once per frame before drawing.
+	 *	@return the number of bytes uploaded
+	 */
+	unsigned int Flush();
+
+	inline BufferUsage GetUsage() const
+	{
+		return m_Usage;
+	}
+
+	/**
+	 * @return the GL buffer, shared with other views of the same arena
+	 */
+	inline unsigned int GetRendererID() const
+	{
+		return m_RendererID;
+	}
+
 	/**
 	 * @return number of elements of this object
 	 */
-	inline unsigned int GetCount() const;
+	inline unsigned int GetCount() const
+	{
+		return m_Count;
+	}
+
+	/**
+	 * @return the type of the indices, GL_UNSIGNED_INT, GL_UNSIGNED_SHORT or GL_UNSIGNED_BYTE
+	 */
+	inline GLenum GetType() const
+	{
+		return m_Type;
+	}
+
+	/**
+	 * @return the size in bytes of one index
+	 */
+	inline unsigned int GetIndexSize() const
+	{
+		return m_IndexSize;
+	}
+
+	/**
+	 * @return the offset in bytes of this buffer's indices in the GL buffer, only non zero for views
+	 */
+	unsigned int GetOffset() const;
+
+	/**
+	 * @return the position of this buffer's first index in the GL buffer
+	 */
+	inline unsigned int GetFirstIndex() const
+	{
+		return GetOffset() / m_IndexSize;
+	}
 
 protected:
 
@@ -44,4 +161,42 @@ private:
 	 */
 	unsigned int m_Count;
 
+	GLenum m_Type;
+	unsigned int m_IndexSize;
+
+	/**
+	 *	The arena and allocation this is a view of, null for buffers that own their GL buffer
+	 */
+	BufferArena* m_Arena;
+	unsigned int m_Allocation;
+
+	BufferUsage m_Usage;
+
+	/**
+	 *	CPU copy of the indices of Dynamic and Stream buffers, in the buffer's type. SetSubData writes here.
+	 */
+	std::vector<unsigned char> m_Shadow;
+	DirtyRanges m_Dirty;
+
+	/**
+	 *	Sets the type of the indices
+	 */
+	void SetType(GLenum type);
+
+	/**
+	 *	Converts the CPU copy to a wider type and uploads it to new storage, including the writes not flushed yet
+	 */
+	void Widen(GLenum type);
+
+	/**
+	 *	Creates the GL buffer, and the CPU copy if the usage needs one
+	 *	@param data count indices of the buffer's type
+	 */
+	void Create(const void* data, unsigned int count);
+
+	/**
+	 *	Gives the GL buffer back to the pool, or the space back to the arena for a view
+	 */
+	void Release();
+
 };
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "IndirectBuffer.h"
+
+#include "Renderer.h"
+#include "GLState.h"
+#include <GL/glew.h>
+
+IndirectBuffer::IndirectBuffer(const DrawElementsIndirectCommand* commands, unsigned int count)
+	: m_RendererID(0), m_Capacity(0)
+{
+	if (IsSupported())
+	{
+		GLCall(glGenBuffers(1, &m_RendererID));
+	}
+	SetData(commands, count);
+}
+
+IndirectBuffer::~IndirectBuffer()
+{
+	if (m_RendererID)
+	{
+		GLState::OnDeleteBuffer(m_RendererID);
+		GLCall(glDeleteBuffers(1, &m_RendererID));
+	}
+}
+
+void IndirectBuffer::SetData(const DrawElementsIndirectCommand * commands, unsigned int count)
+{
+	m_Commands.assign(commands, commands + count);
+
+	if (!m_RendererID)
+	{
+		return;
+	}
+
+	unsigned int size = count * (unsigned int)sizeof(DrawElementsIndirectCommand);
+	Bind();
+	if (size > m_Capacity)
+	{
+		// Reallocate with the new data
+		GLCall(glBufferData(GL_DRAW_INDIRECT_BUFFER, size, commands, GL_DYNAMIC_DRAW));
+		m_Capacity = size;
+	}
+	else if (size > 0)
+	{
+		GLCall(glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, size, commands));
+	}
+}
+
+void IndirectBuffer::Bind() const
+{
+	GLState::BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+}
+
+void IndirectBuffer::UnBind() const
+{
+	GLState::BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+bool IndirectBuffer::IsSupported()
+{
+	return GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+
+/**
+ *	One draw of a multi draw, laid out exactly as glMultiDrawElementsIndirect reads it
+ */
+struct DrawElementsIndirectCommand
+{
+	unsigned int Count;
+	unsigned int InstanceCount;
+	// Counted from the start of the GL index buffer, not from a view's first index
+	unsigned int FirstIndex;
+	int BaseVertex;
+	unsigned int BaseInstance;
+};
+
+class IndirectBuffer
+{
+
+public:
+	/**
+	 *	Construct an Indirect Buffer
+	 *  @param commands An array of draws that index into shared vertex and index buffers
+	 *  @param count The number of draws
+	 */
+	IndirectBuffer(const DrawElementsIndirectCommand* commands, unsigned int count);
+
+	/**
+	 * Instruct OpenGL to delete this buffer
+	 */
+	~IndirectBuffer();
+
+	IndirectBuffer(const IndirectBuffer&) = delete;
+	IndirectBuffer& operator=(const IndirectBuffer&) = delete;
+
+	/**
+	 *	Replace the draws held by this buffer, growing it if necessary
+	 */
+	void SetData(const DrawElementsIndirectCommand* commands, unsigned int count);
+
+	/**
+	 *	Bind this buffer to GL_DRAW_INDIRECT_BUFFER
+	 */
+	void Bind() const;
+
+	/**
+	 *	Unbind this buffer from GL_DRAW_INDIRECT_BUFFER
+	 */
+	void UnBind() const;
+
+	/**
+	 * @return number of draws in this buffer
+	 */
+	inline unsigned int GetCount() const
+	{
+		return (unsigned int)m_Commands.size();
+	}
+
+	/**
+	 * @return the CPU copy of the draws, used when multi draw indirect is not available
+	 */
+	inline const std::vector<DrawElementsIndirectCommand>& GetCommands() const
+	{
+		return m_Commands;
+	}
+
+	/**
+	 * @return true if the context supports glMultiDrawElementsIndirect (GL 4.3 or ARB_multi_draw_indirect)
+	 */
+	static bool IsSupported();
+
+private:
+	/**
+	 *	The ID for this buffer, 0 when the context has no indirect drawing
+	 */
+	unsigned int m_RendererID;
+
+	/**
+	 *	Size in bytes of the GL buffer
+	 */
+	unsigned int m_Capacity;
+
+	std::vector<DrawElementsIndirectCommand> m_Commands;
+
+};
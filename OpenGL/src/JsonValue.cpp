@@ -0,0 +1,367 @@
+#include "JsonValue.h"
+
+#include <cstdlib>
+#include <cstring>
+
+// Deeper documents are rejected rather than risking the stack
+static const unsigned int MaxDepth = 256;
+
+static const JsonValue s_Null;
+
+/**
+ *	Recursive descent over the text, one function per kind of value
+ */
+struct JsonReader
+{
+	const char* Begin;
+	const char* P;
+	const char* End;
+	std::string Error;
+
+	bool Fail(const char* message)
+	{
+		if (Error.empty())
+		{
+			Error = std::string(message) + " at byte " + std::to_string(P - Begin);
+		}
+		return false;
+	}
+
+	void SkipWhitespace()
+	{
+		while (P < End && (*P == ' ' || *P == '\t' || *P == '\n' || *P == '\r'))
+		{
+			P++;
+		}
+	}
+
+	bool Expect(const char* word)
+	{
+		size_t length = std::strlen(word);
+		if ((size_t)(End - P) < length || std::memcmp(P, word, length) != 0)
+		{
+			return Fail("Unexpected character");
+		}
+		P += length;
+		return true;
+	}
+
+	bool ReadValue(JsonValue& value, unsigned int depth)
+	{
+		if (depth > MaxDepth)
+		{
+			return Fail("Too deeply nested");
+		}
+
+		SkipWhitespace();
+		if (P >= End)
+		{
+			return Fail("Unexpected end");
+		}
+
+		switch (*P)
+		{
+		case '{':
+			return ReadObject(value, depth);
+		case '[':
+			return ReadArray(value, depth);
+		case '"':
+			value.m_Type = JsonValue::Type::String;
+			return ReadString(value.m_String);
+		case 't':
+			value.m_Type = JsonValue::Type::Bool;
+			value.m_Bool = true;
+			return Expect("true");
+		case 'f':
+			value.m_Type = JsonValue::Type::Bool;
+			value.m_Bool = false;
+			return Expect("false");
+		case 'n':
+			value.m_Type = JsonValue::Type::Null;
+			return Expect("null");
+		default:
+			value.m_Type = JsonValue::Type::Number;
+			return ReadNumber(value.m_Number);
+		}
+	}
+
+	bool ReadObject(JsonValue& value, unsigned int depth)
+	{
+		value.m_Type = JsonValue::Type::Object;
+		P++;
+		SkipWhitespace();
+		if (P < End && *P == '}')
+		{
+			P++;
+			return true;
+		}
+
+		while (true)
+		{
+			SkipWhitespace();
+			if (P >= End || *P != '"')
+			{
+				return Fail("Expected a member name");
+			}
+			value.m_Members.emplace_back();
+			if (!ReadString(value.m_Members.back().first))
+			{
+				return false;
+			}
+
+			SkipWhitespace();
+			if (P >= End || *P != ':')
+			{
+				return Fail("Expected ':'");
+			}
+			P++;
+			if (!ReadValue(value.m_Members.back().second, depth + 1))
+			{
+				return false;
+			}
+
+			SkipWhitespace();
+			if (P < End && *P == ',')
+			{
+				P++;
+			}
+			else if (P < End && *P == '}')
+			{
+				P++;
+				return true;
+			}
+			else
+			{
+				return Fail("Expected ',' or '}'");
+			}
+		}
+	}
+
+	bool ReadArray(JsonValue& value, unsigned int depth)
+	{
+		value.m_Type = JsonValue::Type::Array;
+		P++;
+		SkipWhitespace();
+		if (P < End && *P == ']')
+		{
+			P++;
+			return true;
+		}
+
+		while (true)
+		{
+			value.m_Elements.emplace_back();
+			if (!ReadValue(value.m_Elements.back(), depth + 1))
+			{
+				return false;
+			}
+
+			SkipWhitespace();
+			if (P < End && *P == ',')
+			{
+				P++;
+			}
+			else if (P < End && *P == ']')
+			{
+				P++;
+				return true;
+			}
+			else
+			{
+				return Fail("Expected ',' or ']'");
+			}
+		}
+	}
+
+	bool ReadHex(unsigned int& code)
+	{
+		if (End - P < 4)
+		{
+			return Fail("Bad escape");
+		}
+		code = 0;
+		for (unsigned int i = 0; i < 4; i++, P++)
+		{
+			char c = *P;
+			unsigned int digit;
+			if (c >= '0' && c <= '9')
+			{
+				digit = c - '0';
+			}
+			else if (c >= 'a' && c <= 'f')
+			{
+				digit = c - 'a' + 10;
+			}
+			else if (c >= 'A' && c <= 'F')
+			{
+				digit = c - 'A' + 10;
+			}
+			else
+			{
+				return Fail("Bad escape");
+			}
+			code = code * 16 + digit;
+		}
+		return true;
+	}
+
+	static void AppendUtf8(std::string& string, unsigned int code)
+	{
+		if (code < 0x80)
+		{
+			string += (char)code;
+		}
+		else if (code < 0x800)
+		{
+			string += (char)(0xC0 | code >> 6);
+			string += (char)(0x80 | (code & 0x3F));
+		}
+		else if (code < 0x10000)
+		{
+			string += (char)(0xE0 | code >> 12);
+			string += (char)(0x80 | (code >> 6 & 0x3F));
+			string += (char)(0x80 | (code & 0x3F));
+		}
+		else
+		{
+			string += (char)(0xF0 | code >> 18);
+			string += (char)(0x80 | (code >> 12 & 0x3F));
+			string += (char)(0x80 | (code >> 6 & 0x3F));
+			string += (char)(0x80 | (code & 0x3F));
+		}
+	}
+
+	bool ReadString(std::string& string)
+	{
+		P++;
+		while (true)
+		{
+			// Copy everything up to the next quote or escape in one go
+			const char* run = P;
+			while (P < End && *P != '"' && *P != '\\')
+			{
+				P++;
+			}
+			string.append(run, P);
+			if (P >= End)
+			{
+				return Fail("Unterminated string");
+			}
+			if (*P == '"')
+			{
+				P++;
+				return true;
+			}
+
+			P++;
+			if (P >= End)
+			{
+				return Fail("Unterminated string");
+			}
+			char escape = *P++;
+			switch (escape)
+			{
+			case '"': string += '"'; break;
+			case '\\': string += '\\'; break;
+			case '/': string += '/'; break;
+			case 'b': string += '\b'; break;
+			case 'f': string += '\f'; break;
+			case 'n': string += '\n'; break;
+			case 'r': string += '\r'; break;
+			case 't': string += '\t'; break;
+			case 'u':
+			{
+				unsigned int code = 0;
+				if (!ReadHex(code))
+				{
+					return false;
+				}
+				// Characters outside the basic plane come as a pair of surrogates
+				if (code >= 0xD800 && code < 0xDC00 && End - P >= 6 && P[0] == '\\' && P[1] == 'u')
+				{
+					P += 2;
+					unsigned int low = 0;
+					if (!ReadHex(low))
+					{
+						return false;
+					}
+					code = low >= 0xDC00 && low < 0xE000 ? 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00) : 0xFFFD;
+				}
+				AppendUtf8(string, code);
+				break;
+			}
+			default:
+				return Fail("Bad escape");
+			}
+		}
+	}
+
+	bool ReadNumber(double& number)
+	{
+		// strtod needs a terminated string, and numbers are short. It reads the decimal point of the
+		// C locale, which the renderer never changes.
+		char buffer[64];
+		size_t length = 0;
+		while (P + length < End && length < sizeof(buffer) - 1 && P[length] != '\0' && std::strchr("+-0123456789.eE", P[length]))
+		{
+			buffer[length] = P[length];
+			length++;
+		}
+		buffer[length] = '\0';
+
+		char* end;
+		number = std::strtod(buffer, &end);
+		if (length == 0 || end != buffer + length)
+		{
+			return Fail("Bad number");
+		}
+		P += length;
+		return true;
+	}
+};
+
+JsonValue::JsonValue()
+	: m_Type(Type::Null), m_Bool(false), m_Number(0.0)
+{
+}
+
+bool JsonValue::Parse(const char * text, size_t size, JsonValue & result, std::string & error)
+{
+	result = JsonValue();
+
+	JsonReader reader = { text, text, text + size, std::string() };
+	if (reader.ReadValue(result, 0))
+	{
+		reader.SkipWhitespace();
+		if (reader.P == reader.End)
+		{
+			return true;
+		}
+		reader.Fail("Unexpected text after the document");
+	}
+
+	error = reader.Error;
+	result = JsonValue();
+	return false;
+}
+
+const JsonValue & JsonValue::operator[](int index) const
+{
+	if (m_Type != Type::Array || index < 0 || (size_t)index >= m_Elements.size())
+	{
+		return s_Null;
+	}
+	return m_Elements[index];
+}
+
+const JsonValue & JsonValue::operator[](const char * key) const
+{
+	for (const auto& member : m_Members)
+	{
+		if (member.first == key)
+		{
+			return member.second;
+		}
+	}
+	return s_Null;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ *	A parsed JSON document, or one value inside it.
+ *	Lookups of missing members or elements return a null value rather than failing, so optional
+ *	fields can be read with a fallback: value["scale"][0].GetNumber(1.0)
+ */
+class JsonValue
+{
+public:
+	enum class Type
+	{
+		Null, Bool, Number, String, Array, Object
+	};
+
+	JsonValue();
+
+	/**
+	 *	Parses a whole document, the text does not need to end with a null character
+	 *	@param error Set to what went wrong and where when parsing fails
+	 *	@return false if the text is not valid JSON
+	 */
+	static bool Parse(const char* text, size_t size, JsonValue& result, std::string& error);
+
+	inline Type GetType() const
+	{
+		return m_Type;
+	}
+
+	inline bool IsNull() const
+	{
+		return m_Type == Type::Null;
+	}
+
+	inline bool IsNumber() const
+	{
+		return m_Type == Type::Number;
+	}
+
+	inline bool IsString() const
+	{
+		return m_Type == Type::String;
+	}
+
+	inline bool IsArray() const
+	{
+		return m_Type == Type::Array;
+	}
+
+	inline bool IsObject() const
+	{
+		return m_Type == Type::Object;
+	}
+
+	inline bool GetBool(bool fallback = false) const
+	{
+		return m_Type == Type::Bool ? m_Bool : fallback;
+	}
+
+	inline double GetNumber(double fallback = 0.0) const
+	{
+		return m_Type == Type::Number ? m_Number : fallback;
+	}
+
+	inline int GetInt(int fallback = 0) const
+	{
+		return m_Type == Type::Number ? (int)m_Number : fallback;
+	}
+
+	/**
+	 *	@return the string, or an empty one if this is not a string
+	 */
+	inline const std::string& GetString() const
+	{
+		return m_String;
+	}
+
+	/**
+	 *	@return the number of elements of an array or members of an object, 0 for anything else
+	 */
+	inline unsigned int Size() const
+	{
+		return (unsigned int)(m_Type == Type::Array ? m_Elements.size() : m_Members.size());
+	}
+
+	/**
+	 *	@return the element at index of an array, or a null value
+	 */
+	const JsonValue& operator[](int index) const;
+
+	/**
+	 *	@return the member called key of an object, or a null value
+	 */
+	const JsonValue& operator[](const char* key) const;
+
+	inline bool Has(const char* key) const
+	{
+		return !(*this)[key].IsNull();
+	}
+
+	/**
+	 *	@return the members of an object in the order they were written
+	 */
+	inline const std::vector<std::pair<std::string, JsonValue>>& GetMembers() const
+	{
+		return m_Members;
+	}
+
+private:
+	Type m_Type;
+	bool m_Bool;
+	double m_Number;
+	std::string m_String;
+	std::vector<JsonValue> m_Elements;
+	std::vector<std::pair<std::string, JsonValue>> m_Members;
+
+	// The parser in JsonValue.cpp fills values in directly
+	friend struct JsonReader;
+};
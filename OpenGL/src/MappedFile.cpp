@@ -0,0 +1,178 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+	: m_Data(nullptr), m_Size(0), m_Open(false)
+#ifdef _WIN32
+	, m_File(nullptr), m_Mapping(nullptr)
+#endif
+{
+}
+
+MappedFile::MappedFile(const std::string & path)
+	: MappedFile()
+{
+	Open(path);
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile && other) noexcept
+	: MappedFile()
+{
+	*this = std::move(other);
+}
+
+MappedFile & MappedFile::operator=(MappedFile && other) noexcept
+{
+	if (this != &other)
+	{
+		// The old mapping is closed by other's destructor
+		std::swap(m_Data, other.m_Data);
+		std::swap(m_Size, other.m_Size);
+		std::swap(m_Open, other.m_Open);
+#ifdef _WIN32
+		std::swap(m_File, other.m_File);
+		std::swap(m_Mapping, other.m_Mapping);
+#endif
+	}
+	return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string & path)
+{
+	Close();
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	m_File = file;
+	m_Open = true;
+	m_Size = (size_t)size.QuadPart;
+	// Empty files can not be mapped
+	if (m_Size == 0)
+	{
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		Close();
+		return false;
+	}
+	m_Mapping = mapping;
+
+	m_Data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!m_Data)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data)
+	{
+		UnmapViewOfFile(m_Data);
+	}
+	if (m_Mapping)
+	{
+		CloseHandle(m_Mapping);
+	}
+	if (m_File)
+	{
+		CloseHandle(m_File);
+	}
+	m_Data = nullptr;
+	m_Size = 0;
+	m_Open = false;
+	m_File = nullptr;
+	m_Mapping = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string & path)
+{
+	Close();
+
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(file, &status) != 0)
+	{
+		close(file);
+		return false;
+	}
+
+	m_Open = true;
+	m_Size = (size_t)status.st_size;
+	if (m_Size > 0)
+	{
+		void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data == MAP_FAILED)
+		{
+			close(file);
+			Close();
+			return false;
+		}
+		// Loaders read the file front to back
+		madvise(data, m_Size, MADV_SEQUENTIAL);
+		m_Data = (const char*)data;
+	}
+	// The mapping keeps the file alive
+	close(file);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data)
+	{
+		munmap((void*)m_Data, m_Size);
+	}
+	m_Data = nullptr;
+	m_Size = 0;
+	m_Open = false;
+}
+
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ *	A file mapped read only into memory, so loaders parse it in place instead of copying it through a stream.
+ *	The data stays valid until the MappedFile is destroyed.
+ */
+class MappedFile
+{
+public:
+	MappedFile();
+
+	/**
+	 *	Maps the file, check IsOpen to see if that worked
+	 */
+	MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+	 * Moves the mapping to a new owner, leaving other closed
+	 */
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	/**
+	 *	Maps a file, unmapping the one mapped before
+	 *	@return false if the file could not be opened or mapped
+	 */
+	bool Open(const std::string& path);
+
+	void Close();
+
+	/**
+	 *	@return true if a file is mapped, an empty file counts as mapped with no data
+	 */
+	inline bool IsOpen() const
+	{
+		return m_Open;
+	}
+
+	inline const char* GetData() const
+	{
+		return m_Data;
+	}
+
+	inline size_t GetSize() const
+	{
+		return m_Size;
+	}
+
+private:
+	const char* m_Data;
+	size_t m_Size;
+	bool m_Open;
+#ifdef _WIN32
+	void* m_File;
+	void* m_Mapping;
+#endif
+};
@@ -0,0 +1,238 @@
+#include "MeshFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+
+static_assert(sizeof(MeshFileHeader) == 96, "MeshFileHeader must not change size without a new Version");
+static_assert(sizeof(MeshLod) == 12, "MeshLods are stored as they are in memory");
+
+static const char s_Magic[4] = { 'M', 'E', 'S', 'H' };
+static const unsigned long long Alignment = 16;
+
+static inline unsigned long long Align(unsigned long long offset)
+{
+	return (offset + Alignment - 1) / Alignment * Alignment;
+}
+
+/**
+ *	@return true if [offset, offset + size) lies inside the file and is aligned
+ */
+static inline bool IsInside(unsigned long long offset, unsigned long long size, unsigned long long fileSize)
+{
+	return offset % Alignment == 0 && offset <= fileSize && size <= fileSize - offset;
+}
+
+/**
+ *	@return true if the element is one VertexBufferLayout can describe, its size is not known otherwise
+ */
+static bool IsSupportedElement(const MeshFileElement& element)
+{
+	switch (element.Type)
+	{
+	case GL_FLOAT:
+	case GL_UNSIGNED_INT:
+	case GL_UNSIGNED_BYTE:
+	case GL_BYTE:
+	case GL_SHORT:
+	case GL_UNSIGNED_SHORT:
+	case GL_HALF_FLOAT:
+		return element.Count >= 1 && element.Count <= 4;
+	case GL_INT_2_10_10_10_REV:
+		return element.Count == 4;
+	}
+	return false;
+}
+
+MeshFile::MeshFile()
+	: m_Header(nullptr)
+{
+}
+
+MeshFile::MeshFile(const std::string & path)
+	: m_Header(nullptr)
+{
+	Open(path);
+}
+
+bool MeshFile::Open(const std::string & path)
+{
+	m_Header = nullptr;
+	m_Layout = VertexBufferLayout();
+	if (!m_File.Open(path))
+	{
+		std::cout << "Could not open mesh file '" << path << "'" << std::endl;
+		return false;
+	}
+
+	const MeshFileHeader* header = (const MeshFileHeader*)m_File.GetData();
+	unsigned long long size = m_File.GetSize();
+	if (size < sizeof(MeshFileHeader) || std::memcmp(header->Magic, s_Magic, sizeof(s_Magic)) != 0)
+	{
+		std::cout << "'" << path << "' is not a mesh file" << std::endl;
+		m_File.Close();
+		return false;
+	}
+	if (header->Version != Version)
+	{
+		std::cout << "'" << path << "' is mesh file version " << header->Version << ", convert it again for version " << Version << std::endl;
+		m_File.Close();
+		return false;
+	}
+
+	unsigned int indexSize = header->IndexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+	bool valid = header->FileSize == size &&
+		(header->IndexType == GL_UNSIGNED_SHORT || header->IndexType == GL_UNSIGNED_INT) &&
+		IsInside(header->ElementsOffset, (unsigned long long)header->ElementCount * sizeof(MeshFileElement), size) &&
+		IsInside(header->VerticesOffset, (unsigned long long)header->VertexCount * header->VertexStride, size) &&
+		IsInside(header->IndicesOffset, (unsigned long long)header->IndexCount * indexSize, size) &&
+		IsInside(header->LodsOffset, (unsigned long long)header->LodCount * sizeof(MeshLod), size);
+
+	// Only the small tables are checked, the vertices and indices are handed to GL as they are
+	const MeshFileElement* elements = (const MeshFileElement*)(m_File.GetData() + header->ElementsOffset);
+	for (unsigned int i = 0; valid && i < header->ElementCount; i++)
+	{
+		// Elements keep the offsets they were written with, so padded or interleaved layouts load as they were
+		valid = IsSupportedElement(elements[i]);
+		if (valid)
+		{
+			VertexBufferElement element = { elements[i].Type, elements[i].Count, (unsigned char)elements[i].Normalized, 0 };
+			valid = (unsigned long long)elements[i].Offset + element.GetSize() <= header->VertexStride;
+			m_Layout.PushElement(element, elements[i].Offset);
+		}
+	}
+
+	const MeshLod* lods = (const MeshLod*)(m_File.GetData() + header->LodsOffset);
+	for (unsigned int i = 0; valid && i < header->LodCount; i++)
+	{
+		valid = lods[i].FirstIndex <= header->IndexCount && lods[i].IndexCount <= header->IndexCount - lods[i].FirstIndex;
+	}
+
+	if (!valid)
+	{
+		std::cout << "'" << path << "' is damaged" << std::endl;
+		m_Layout = VertexBufferLayout();
+		m_File.Close();
+		return false;
+	}
+
+	// Keeps any padding between and after the elements, e.g. from VertexBufferLayout::AlignStride
+	m_Layout.SetStride(header->VertexStride);
+	m_Header = header;
+	return true;
+}
+
+VertexBuffer MeshFile::CreateVertexBuffer() const
+{
+	ASSERT(IsOpen());
+	return VertexBuffer(GetVertices(), m_Header->VertexCount * m_Header->VertexStride);
+}
+
+IndexBuffer MeshFile::CreateIndexBuffer() const
+{
+	ASSERT(IsOpen());
+	// Write already picked the narrowest type, so the mapped indices go to GL as they are
+	return IndexBuffer(GetIndices(), m_Header->IndexCount, m_Header->IndexType);
+}
+
+bool MeshFile::Write(const std::string & path, const void * vertices, unsigned int vertexCount, const VertexBufferLayout & layout,
+	const unsigned int * indices, unsigned int indexCount, const MeshLod * lods, unsigned int lodCount)
+{
+	const auto& elements = layout.GetElements();
+	ASSERT(!elements.empty() && elements[0].type == GL_FLOAT && elements[0].count >= 3);
+
+	MeshLod wholeMesh = { 0, indexCount, 0.0f };
+	if (!lods || lodCount == 0)
+	{
+		lods = &wholeMesh;
+		lodCount = 1;
+	}
+
+	bool shortIndices = vertexCount <= 65536;
+	unsigned int indexSize = shortIndices ? sizeof(unsigned short) : sizeof(unsigned int);
+	unsigned int stride = layout.GetStride();
+
+	MeshFileHeader header = {};
+	std::memcpy(header.Magic, s_Magic, sizeof(s_Magic));
+	header.Version = Version;
+	header.VertexCount = vertexCount;
+	header.VertexStride = stride;
+	header.ElementCount = (unsigned int)elements.size();
+	header.IndexCount = indexCount;
+	header.IndexType = shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	header.LodCount = lodCount;
+	header.ElementsOffset = Align(sizeof(MeshFileHeader));
+	header.VerticesOffset = Align(header.ElementsOffset + header.ElementCount * sizeof(MeshFileElement));
+	header.IndicesOffset = Align(header.VerticesOffset + (unsigned long long)vertexCount * stride);
+	header.LodsOffset = Align(header.IndicesOffset + (unsigned long long)indexCount * indexSize);
+	header.FileSize = header.LodsOffset + lodCount * sizeof(MeshLod);
+
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		header.BoundsMin[i] = 0.0f;
+		header.BoundsMax[i] = 0.0f;
+	}
+	for (unsigned int v = 0; v < vertexCount; v++)
+	{
+		const float* position = (const float*)((const unsigned char*)vertices + (size_t)v * stride + elements[0].offset);
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			if (v == 0 || position[i] < header.BoundsMin[i])
+			{
+				header.BoundsMin[i] = position[i];
+			}
+			if (v == 0 || position[i] > header.BoundsMax[i])
+			{
+				header.BoundsMax[i] = position[i];
+			}
+		}
+	}
+
+	std::vector<MeshFileElement> fileElements;
+	for (const VertexBufferElement& element : elements)
+	{
+		fileElements.push_back({ element.type, element.count, element.normalized, element.offset });
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not write mesh file '" << path << "'" << std::endl;
+		return false;
+	}
+
+	static const char padding[Alignment] = {};
+	auto pad = [&file](unsigned long long offset)
+	{
+		file.write(padding, (std::streamsize)(offset - (unsigned long long)file.tellp()));
+	};
+
+	file.write((const char*)&header, sizeof(header));
+	pad(header.ElementsOffset);
+	file.write((const char*)fileElements.data(), fileElements.size() * sizeof(MeshFileElement));
+	pad(header.VerticesOffset);
+	file.write((const char*)vertices, (std::streamsize)vertexCount * stride);
+	pad(header.IndicesOffset);
+	if (shortIndices)
+	{
+		std::vector<unsigned short> narrowed(indices, indices + indexCount);
+		file.write((const char*)narrowed.data(), (std::streamsize)indexCount * indexSize);
+	}
+	else
+	{
+		file.write((const char*)indices, (std::streamsize)indexCount * indexSize);
+	}
+	pad(header.LodsOffset);
+	file.write((const char*)lods, lodCount * sizeof(MeshLod));
+
+	if (!file)
+	{
+		std::cout << "Could not write mesh file '" << path << "'" << std::endl;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <string>
+
+#include "MappedFile.h"
+#include "MeshSimplifier.h"
+#include "VertexBufferLayout.h"
+
+class VertexBuffer;
+class IndexBuffer;
+
+/**
+ *	Start of a .mesh file. It is followed by ElementCount MeshFileElements, the vertices, the indices
+ *	and LodCount MeshLods, each starting at its offset from the start of the file, 16 byte aligned.
+ *	Everything is stored little endian, the way the loading machine reads it.
+ */
+struct MeshFileHeader
+{
+	// "MESH"
+	char Magic[4];
+	unsigned int Version;
+	unsigned int VertexCount;
+	unsigned int VertexStride;
+	unsigned int ElementCount;
+	unsigned int IndexCount;
+	// GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	unsigned int IndexType;
+	unsigned int LodCount;
+	// Of the positions, the first element
+	float BoundsMin[3];
+	float BoundsMax[3];
+	unsigned long long ElementsOffset;
+	unsigned long long VerticesOffset;
+	unsigned long long IndicesOffset;
+	unsigned long long LodsOffset;
+	unsigned long long FileSize;
+};
+
+/**
+ *	A VertexBufferElement as stored in a .mesh file
+ */
+struct MeshFileElement
+{
+	unsigned int Type;
+	unsigned int Count;
+	unsigned int Normalized;
+	unsigned int Offset;
+};
+
+/**
+ *	A mesh in the binary .mesh format, written ahead of time by MeshConverter so nothing is parsed at
+ *	launch. Open maps the file and checks the header, after which the vertices and indices are read
+ *	straight from the mapping by the buffer constructors.
+ */
+class MeshFile
+{
+public:
+	/**
+	 *	Changes whenever the layout of the file changes, older files have to be converted again
+	 */
+	static const unsigned int Version = 1;
+
+	MeshFile();
+
+	/**
+	 *	Opens the file, check IsOpen to see if that worked
+	 */
+	MeshFile(const std::string& path);
+
+	MeshFile(const MeshFile&) = delete;
+	MeshFile& operator=(const MeshFile&) = delete;
+
+	/**
+	 *	Maps a .mesh file and checks that its header matches its contents
+	 *	@return false if the file can not be read, is not a .mesh file or was written by another version
+	 */
+	bool Open(const std::string& path);
+
+	inline bool IsOpen() const
+	{
+		return m_Header != nullptr;
+	}
+
+	/**
+	 *	Uploads the vertices
+	 */
+	VertexBuffer CreateVertexBuffer() const;
+
+	/**
+	 *	Uploads the indices of every level of detail straight from the mapping, in the type Write stored
+	 */
+	IndexBuffer CreateIndexBuffer() const;
+
+	inline const VertexBufferLayout& GetLayout() const
+	{
+		return m_Layout;
+	}
+
+	inline const void* GetVertices() const
+	{
+		return m_File.GetData() + m_Header->VerticesOffset;
+	}
+
+	inline unsigned int GetVertexCount() const
+	{
+		return m_Header->VertexCount;
+	}
+
+	inline const void* GetIndices() const
+	{
+		return m_File.GetData() + m_Header->IndicesOffset;
+	}
+
+	inline unsigned int GetIndexCount() const
+	{
+		return m_Header->IndexCount;
+	}
+
+	/**
+	 *	@return GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	 */
+	inline unsigned int GetIndexType() const
+	{
+		return m_Header->IndexType;
+	}
+
+	/**
+	 *	@return the levels of detail, finest first, at least the whole mesh as level 0
+	 */
+	inline const MeshLod* GetLods() const
+	{
+		return (const MeshLod*)(m_File.GetData() + m_Header->LodsOffset);
+	}
+
+	inline unsigned int GetLodCount() const
+	{
+		return m_Header->LodCount;
+	}
+
+	inline const float* GetBoundsMin() const
+	{
+		return m_Header->BoundsMin;
+	}
+
+	inline const float* GetBoundsMax() const
+	{
+		return m_Header->BoundsMax;
+	}
+
+	/**
+	 *	Writes a .mesh file. Indices are stored as GL_UNSIGNED_SHORT when there are at most 65536 vertices.
+	 *	@param vertices vertexCount vertices laid out as layout, the first element is x, y, z float positions
+	 *	@param indices The indices of every level one after another
+	 *	@param lods The levels in indices, or null to store the whole mesh as the only level
+	 *	@return false if the file could not be written
+	 */
+	static bool Write(const std::string& path, const void* vertices, unsigned int vertexCount, const VertexBufferLayout& layout,
+		const unsigned int* indices, unsigned int indexCount, const MeshLod* lods = nullptr, unsigned int lodCount = 0);
+
+private:
+	MappedFile m_File;
+	// Points into m_File, null until a file is opened
+	const MeshFileHeader* m_Header;
+	VertexBufferLayout m_Layout;
+};
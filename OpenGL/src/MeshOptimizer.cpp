@@ -0,0 +1,394 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Renderer.h"
+
+/**
+ *	A FIFO post-transform cache. A vertex is cached while fewer than Size vertices were transformed
+ *	after it, which only needs one timestamp per vertex.
+ */
+class VertexCache
+{
+public:
+	VertexCache(unsigned int vertexCount, unsigned int size)
+		: m_Times(vertexCount, 0), m_Size(size), m_Time(size + 1)
+	{
+	}
+
+	/**
+	 *	@return true if the vertex had to be transformed, adding it to the cache
+	 */
+	bool Miss(unsigned int vertex)
+	{
+		if (m_Time - m_Times[vertex] > m_Size)
+		{
+			m_Times[vertex] = m_Time++;
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 *	@return how long ago a vertex was added, larger than Size if it is not cached
+	 */
+	unsigned int GetAge(unsigned int vertex) const
+	{
+		return m_Time - m_Times[vertex];
+	}
+
+	/**
+	 *	Evicts every vertex
+	 */
+	void Flush()
+	{
+		m_Time += m_Size + 1;
+	}
+
+private:
+	std::vector<unsigned int> m_Times;
+	unsigned int m_Size;
+	unsigned int m_Time;
+};
+
+/**
+ *	The triangles using each vertex, stored as one list of triangle ids with an offset per vertex
+ */
+struct VertexTriangles
+{
+	std::vector<unsigned int> Offsets;
+	std::vector<unsigned int> Counts;
+	std::vector<unsigned int> Triangles;
+
+	VertexTriangles(const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount)
+		: Offsets(vertexCount, 0), Counts(vertexCount, 0), Triangles(indexCount)
+	{
+		for (unsigned int i = 0; i < indexCount; i++)
+		{
+			Counts[indices[i]]++;
+		}
+		unsigned int offset = 0;
+		for (unsigned int v = 0; v < vertexCount; v++)
+		{
+			Offsets[v] = offset;
+			offset += Counts[v];
+		}
+
+		std::vector<unsigned int> filled(vertexCount, 0);
+		for (unsigned int i = 0; i < indexCount; i++)
+		{
+			unsigned int v = indices[i];
+			Triangles[Offsets[v] + filled[v]++] = i / 3;
+		}
+	}
+};
+
+void MeshOptimizer::OptimizeVertexCache(unsigned int* destination, const unsigned int* indices, unsigned int indexCount,
+	unsigned int vertexCount, unsigned int cacheSize)
+{
+	ASSERT(indexCount % 3 == 0);
+	if (indexCount == 0)
+	{
+		return;
+	}
+
+	// destination may be indices, so the input is kept
+	std::vector<unsigned int> input(indices, indices + indexCount);
+	unsigned int triangleCount = indexCount / 3;
+
+	VertexTriangles adjacency(input.data(), indexCount, vertexCount);
+	// Triangles not emitted yet, per vertex
+	std::vector<unsigned int> live = adjacency.Counts;
+	std::vector<bool> emitted(triangleCount, false);
+	// Vertices of emitted triangles, the most recent last, to restart from when the fan runs dry
+	std::vector<unsigned int> deadEnds;
+	std::vector<unsigned int> candidates;
+	VertexCache cache(vertexCount, cacheSize);
+
+	unsigned int output = 0;
+	unsigned int cursor = 0;
+	int fan = (int)input[0];
+	while (fan >= 0)
+	{
+		// Emit every remaining triangle around the fanning vertex
+		candidates.clear();
+		unsigned int begin = adjacency.Offsets[fan];
+		unsigned int end = begin + adjacency.Counts[fan];
+		for (unsigned int i = begin; i < end; i++)
+		{
+			unsigned int triangle = adjacency.Triangles[i];
+			if (emitted[triangle])
+			{
+				continue;
+			}
+			for (unsigned int corner = 0; corner < 3; corner++)
+			{
+				unsigned int v = input[triangle * 3 + corner];
+				destination[output++] = v;
+				deadEnds.push_back(v);
+				candidates.push_back(v);
+				live[v]--;
+				cache.Miss(v);
+			}
+			emitted[triangle] = true;
+		}
+
+		// Continue with the candidate that will still be cached after its own triangles are emitted,
+		// preferring the one added to the cache earliest
+		int next = -1;
+		int best = -1;
+		for (unsigned int v : candidates)
+		{
+			if (live[v] == 0)
+			{
+				continue;
+			}
+			int priority = 0;
+			if (cache.GetAge(v) + 2 * live[v] <= cacheSize)
+			{
+				priority = (int)cache.GetAge(v);
+			}
+			if (priority > best)
+			{
+				best = priority;
+				next = (int)v;
+			}
+		}
+
+		if (next == -1)
+		{
+			// Dead end, go back to a recent vertex that still has triangles, or the next unused one
+			while (!deadEnds.empty() && next == -1)
+			{
+				unsigned int v = deadEnds.back();
+				deadEnds.pop_back();
+				if (live[v] > 0)
+				{
+					next = (int)v;
+				}
+			}
+			while (next == -1 && cursor < vertexCount)
+			{
+				if (live[cursor] > 0)
+				{
+					next = (int)cursor;
+				}
+				cursor++;
+			}
+		}
+		fan = next;
+	}
+	ASSERT(output == indexCount);
+}
+
+void MeshOptimizer::OptimizeOverdraw(unsigned int* destination, const unsigned int* indices, unsigned int indexCount,
+	const float* positions, unsigned int vertexCount, unsigned int positionStride, float threshold, unsigned int cacheSize)
+{
+	ASSERT(indexCount % 3 == 0);
+	if (indexCount == 0)
+	{
+		return;
+	}
+
+	std::vector<unsigned int> input(indices, indices + indexCount);
+	unsigned int triangleCount = indexCount / 3;
+
+	// A cluster starts wherever all three vertices of a triangle miss the cache
+	std::vector<unsigned int> hardClusters;
+	{
+		VertexCache cache(vertexCount, cacheSize);
+		for (unsigned int t = 0; t < triangleCount; t++)
+		{
+			unsigned int misses = cache.Miss(input[t * 3]) + cache.Miss(input[t * 3 + 1]) + cache.Miss(input[t * 3 + 2]);
+			if (misses == 3)
+			{
+				hardClusters.push_back(t);
+			}
+		}
+		if (hardClusters.empty() || hardClusters[0] != 0)
+		{
+			hardClusters.insert(hardClusters.begin(), 0);
+		}
+	}
+
+	// Split the clusters where the part so far is already about as cache efficient as the whole cluster,
+	// so starting over with a cold cache there costs little
+	std::vector<unsigned int> clusters;
+	VertexCache cache(vertexCount, cacheSize);
+	for (unsigned int c = 0; c < hardClusters.size(); c++)
+	{
+		unsigned int start = hardClusters[c];
+		unsigned int end = c + 1 < hardClusters.size() ? hardClusters[c + 1] : triangleCount;
+
+		cache.Flush();
+		unsigned int clusterMisses = 0;
+		for (unsigned int t = start; t < end; t++)
+		{
+			clusterMisses += cache.Miss(input[t * 3]) + cache.Miss(input[t * 3 + 1]) + cache.Miss(input[t * 3 + 2]);
+		}
+		float clusterACMR = (float)clusterMisses / (end - start);
+
+		cache.Flush();
+		clusters.push_back(start);
+		unsigned int segmentStart = start;
+		unsigned int misses = 0;
+		for (unsigned int t = start; t < end; t++)
+		{
+			misses += cache.Miss(input[t * 3]) + cache.Miss(input[t * 3 + 1]) + cache.Miss(input[t * 3 + 2]);
+			if (t + 1 < end && (float)misses <= threshold * clusterACMR * (t + 1 - segmentStart))
+			{
+				clusters.push_back(t + 1);
+				segmentStart = t + 1;
+				misses = 0;
+				cache.Flush();
+			}
+		}
+	}
+
+	// Area weighted centre and normal of every cluster, and the centre of the whole mesh
+	struct ClusterInfo
+	{
+		unsigned int Start, End;
+		float Centre[3];
+		float Normal[3];
+		float Area;
+		float Sort;
+	};
+	std::vector<ClusterInfo> infos(clusters.size());
+	float meshCentre[3] = { 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+	for (unsigned int c = 0; c < clusters.size(); c++)
+	{
+		ClusterInfo& info = infos[c];
+		info = ClusterInfo();
+		info.Start = clusters[c];
+		info.End = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+		for (unsigned int t = info.Start; t < info.End; t++)
+		{
+			const float* p[3];
+			for (unsigned int corner = 0; corner < 3; corner++)
+			{
+				p[corner] = (const float*)((const unsigned char*)positions + (size_t)input[t * 3 + corner] * positionStride);
+			}
+			float e1[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+			float e2[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+			float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			for (unsigned int axis = 0; axis < 3; axis++)
+			{
+				info.Centre[axis] += (p[0][axis] + p[1][axis] + p[2][axis]) / 3.0f * area;
+				info.Normal[axis] += n[axis];
+			}
+			info.Area += area;
+		}
+
+		for (unsigned int axis = 0; axis < 3; axis++)
+		{
+			meshCentre[axis] += info.Centre[axis];
+			info.Centre[axis] = info.Area > 0.0f ? info.Centre[axis] / info.Area : 0.0f;
+		}
+		meshArea += info.Area;
+	}
+	for (unsigned int axis = 0; axis < 3; axis++)
+	{
+		meshCentre[axis] = meshArea > 0.0f ? meshCentre[axis] / meshArea : 0.0f;
+	}
+
+	// Clusters facing away from the centre are on the outside, so drawing them first occludes the rest
+	for (ClusterInfo& info : infos)
+	{
+		float length = std::sqrt(info.Normal[0] * info.Normal[0] + info.Normal[1] * info.Normal[1] + info.Normal[2] * info.Normal[2]);
+		info.Sort = 0.0f;
+		if (length > 0.0f)
+		{
+			for (unsigned int axis = 0; axis < 3; axis++)
+			{
+				info.Sort += (info.Centre[axis] - meshCentre[axis]) * info.Normal[axis] / length;
+			}
+		}
+	}
+	std::stable_sort(infos.begin(), infos.end(), [](const ClusterInfo& a, const ClusterInfo& b)
+	{
+		return a.Sort > b.Sort;
+	});
+
+	unsigned int output = 0;
+	for (const ClusterInfo& info : infos)
+	{
+		for (unsigned int i = info.Start * 3; i < info.End * 3; i++)
+		{
+			destination[output++] = input[i];
+		}
+	}
+}
+
+unsigned int MeshOptimizer::OptimizeVertexFetch(void* vertices, unsigned int* indices, unsigned int indexCount,
+	unsigned int vertexCount, unsigned int vertexSize)
+{
+	const unsigned int unused = 0xFFFFFFFF;
+	std::vector<unsigned int> remap(vertexCount, unused);
+	std::vector<unsigned char> reordered((size_t)vertexCount * vertexSize);
+
+	unsigned int next = 0;
+	for (unsigned int i = 0; i < indexCount; i++)
+	{
+		unsigned int v = indices[i];
+		if (remap[v] == unused)
+		{
+			remap[v] = next;
+			std::memcpy(&reordered[(size_t)next * vertexSize], (const unsigned char*)vertices + (size_t)v * vertexSize, vertexSize);
+			next++;
+		}
+		indices[i] = remap[v];
+	}
+
+	std::memcpy(vertices, reordered.data(), (size_t)next * vertexSize);
+	return next;
+}
+
+unsigned int MeshOptimizer::Optimize(void* vertices, unsigned int* indices, unsigned int indexCount, unsigned int vertexCount,
+	unsigned int vertexSize, const float* positions)
+{
+	OptimizeVertexCache(indices, indices, indexCount, vertexCount);
+	if (positions)
+	{
+		OptimizeOverdraw(indices, indices, indexCount, positions, vertexCount, vertexSize);
+	}
+	return OptimizeVertexFetch(vertices, indices, indexCount, vertexCount, vertexSize);
+}
+
+MeshOptimizer::VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const unsigned int* indices, unsigned int indexCount,
+	unsigned int vertexCount, unsigned int cacheSize)
+{
+	VertexCacheStats stats;
+	stats.TrianglesCount = indexCount / 3;
+
+	VertexCache cache(vertexCount, cacheSize);
+	std::vector<bool> used(vertexCount, false);
+	unsigned int usedCount = 0;
+	for (unsigned int i = 0; i < indexCount; i++)
+	{
+		unsigned int v = indices[i];
+		if (cache.Miss(v))
+		{
+			stats.VerticesTransformed++;
+		}
+		if (!used[v])
+		{
+			used[v] = true;
+			usedCount++;
+		}
+	}
+
+	if (stats.TrianglesCount > 0)
+	{
+		stats.ACMR = (float)stats.VerticesTransformed / stats.TrianglesCount;
+		stats.ATVR = (float)stats.VerticesTransformed / usedCount;
+	}
+	return stats;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+/**
+ *	Reorders indexed triangle meshes so the GPU does less work drawing them, before they are uploaded
+ *	to a VertexBuffer and IndexBuffer. The usual order is OptimizeVertexCache, OptimizeOverdraw and
+ *	finally OptimizeVertexFetch, which Optimize does in one go.
+ *
+ *	Vertex cache ordering uses Tipsify (Sander, Nehab and Barczak, "Fast Triangle Reordering for
+ *	Vertex Locality and Reduced Overdraw", 2007), which also yields the clusters the overdraw pass sorts.
+ */
+class MeshOptimizer
+{
+public:
+	/**
+	 *	Post-transform cache size assumed by default, a conservative value for current GPUs
+	 */
+	static const unsigned int DefaultCacheSize = 16;
+
+	/**
+	 *	How well an index order uses a FIFO post-transform vertex cache
+	 */
+	struct VertexCacheStats
+	{
+		unsigned int TrianglesCount = 0;
+		unsigned int VerticesTransformed = 0;
+		// Average cache miss ratio, vertices transformed per triangle: 3 at worst, about 0.5 at best
+		float ACMR = 0.0f;
+		// Average transform to vertex ratio, vertices transformed per vertex used: 1 is ideal
+		float ATVR = 0.0f;
+	};
+
+	/**
+	 *	Reorders triangles so vertices are reused while they are still in the post-transform cache
+	 *	@param destination Receives indexCount reordered indices, may be the same as indices
+	 *	@param indices Triangle list indices, each below vertexCount
+	 */
+	static void OptimizeVertexCache(unsigned int* destination, const unsigned int* indices, unsigned int indexCount,
+		unsigned int vertexCount, unsigned int cacheSize = DefaultCacheSize);
+
+	/**
+	 *	Reorders the clusters of a cache optimised mesh so triangles facing outwards are drawn first and
+	 *	hide what is behind them. A cluster starts wherever the order jumps to vertices that are not in the
+	 *	cache, and clusters are split further where that costs little cache efficiency.
+	 *	@param destination Receives indexCount reordered indices, may be the same as indices
+	 *	@param indices Indices ordered by OptimizeVertexCache
+	 *	@param positions x, y, z of the first vertex, the following vertices are positionStride bytes apart
+	 *	@param threshold How much worse than the cache optimised order the ACMR may get, e.g. 1.05 for 5%
+	 */
+	static void OptimizeOverdraw(unsigned int* destination, const unsigned int* indices, unsigned int indexCount,
+		const float* positions, unsigned int vertexCount, unsigned int positionStride, float threshold = 1.05f,
+		unsigned int cacheSize = DefaultCacheSize);
+
+	/**
+	 *	Reorders vertices into the order the indices first use them, so vertex fetch reads memory
+	 *	sequentially, and drops vertices that are never used. The indices are remapped to match.
+	 *	@param vertices vertexCount vertices of vertexSize bytes, reordered in place
+	 *	@param indices Remapped in place
+	 *	@return the number of vertices left
+	 */
+	static unsigned int OptimizeVertexFetch(void* vertices, unsigned int* indices, unsigned int indexCount,
+		unsigned int vertexCount, unsigned int vertexSize);
+
+	/**
+	 *	Runs every pass, skipping overdraw when positions is null (e.g. for flat 2D meshes)
+	 *	@param vertices vertexCount vertices of vertexSize bytes, reordered in place
+	 *	@param indices Reordered and remapped in place
+	 *	@param positions x, y, z of the first vertex inside vertices, or null
+	 *	@return the number of vertices left
+	 */
+	static unsigned int Optimize(void* vertices, unsigned int* indices, unsigned int indexCount, unsigned int vertexCount,
+		unsigned int vertexSize, const float* positions = nullptr);
+
+	/**
+	 *	Simulates a FIFO post-transform cache of cacheSize vertices over the indices
+	 */
+	static VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount,
+		unsigned int cacheSize = DefaultCacheSize);
+};
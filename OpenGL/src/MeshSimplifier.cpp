@@ -0,0 +1,446 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_set>
+
+#include "Renderer.h"
+#include "MeshOptimizer.h"
+
+static const unsigned int s_MaxDimension = 3 + MeshSimplifier::MaxAttributes;
+
+/**
+ *	A quadric per vertex over points of Dimension floats, the position followed by the weighted attributes.
+ *	Each is stored as the upper triangle of A, then b, then c, for an error of p'Ap + 2b'p + c, and
+ *	last the total area of its triangles, which turns the error into an average squared distance.
+ */
+class QuadricSet
+{
+public:
+	QuadricSet(unsigned int vertexCount, unsigned int dimension)
+		: m_Dimension(dimension), m_Size(dimension * (dimension + 1) / 2 + dimension + 2),
+		m_Values((size_t)vertexCount * m_Size, 0.0f)
+	{
+	}
+
+	/**
+	 *	Adds the quadric of the plane through a triangle, weighted by its area, to each of its vertices
+	 */
+	void AddTriangle(const unsigned int* vertices, const float* p0, const float* p1, const float* p2)
+	{
+		unsigned int d = m_Dimension;
+		float e1[s_MaxDimension];
+		float e2[s_MaxDimension];
+		for (unsigned int i = 0; i < d; i++)
+		{
+			e1[i] = p1[i] - p0[i];
+			e2[i] = p2[i] - p0[i];
+		}
+
+		// The area only counts positions, so attributes do not make triangles weigh more
+		float cross[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+		float area = 0.5f * std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+
+		// Orthonormal e1, e2 spanning the triangle
+		float length = std::sqrt(Dot(e1, e1));
+		if (length == 0.0f || area == 0.0f)
+		{
+			return;
+		}
+		Scale(e1, 1.0f / length);
+		float along = Dot(e2, e1);
+		for (unsigned int i = 0; i < d; i++)
+		{
+			e2[i] -= along * e1[i];
+		}
+		length = std::sqrt(Dot(e2, e2));
+		if (length == 0.0f)
+		{
+			return;
+		}
+		Scale(e2, 1.0f / length);
+
+		// A = I - e1e1' - e2e2', b = (p0.e1)e1 + (p0.e2)e2 - p0, c = p0.p0 - (p0.e1)^2 - (p0.e2)^2
+		float quadric[s_MaxDimension * (s_MaxDimension + 1) / 2 + s_MaxDimension + 2];
+		unsigned int k = 0;
+		for (unsigned int i = 0; i < d; i++)
+		{
+			for (unsigned int j = i; j < d; j++)
+			{
+				quadric[k++] = area * ((i == j ? 1.0f : 0.0f) - e1[i] * e1[j] - e2[i] * e2[j]);
+			}
+		}
+		float p0e1 = Dot(p0, e1);
+		float p0e2 = Dot(p0, e2);
+		for (unsigned int i = 0; i < d; i++)
+		{
+			quadric[k++] = area * (p0e1 * e1[i] + p0e2 * e2[i] - p0[i]);
+		}
+		quadric[k++] = area * (Dot(p0, p0) - p0e1 * p0e1 - p0e2 * p0e2);
+		quadric[k] = area;
+
+		for (unsigned int corner = 0; corner < 3; corner++)
+		{
+			float* target = Get(vertices[corner]);
+			for (unsigned int i = 0; i < m_Size; i++)
+			{
+				target[i] += quadric[i];
+			}
+		}
+	}
+
+	/**
+	 *	Adds the quadric of one vertex to another
+	 */
+	void Add(unsigned int to, unsigned int from)
+	{
+		float* target = Get(to);
+		const float* source = Get(from);
+		for (unsigned int i = 0; i < m_Size; i++)
+		{
+			target[i] += source[i];
+		}
+	}
+
+	/**
+	 *	@return the error of the sum of two vertices' quadrics at a point, the average squared distance to their planes
+	 */
+	float Evaluate(unsigned int a, unsigned int b, const float* point) const
+	{
+		float area = m_Values[(size_t)a * m_Size + m_Size - 1] + m_Values[(size_t)b * m_Size + m_Size - 1];
+		if (area == 0.0f)
+		{
+			return 0.0f;
+		}
+		float error = (Sum(a, point) + Sum(b, point)) / area;
+		// Rounding can take it slightly below zero
+		return error > 0.0f ? error : 0.0f;
+	}
+
+private:
+	unsigned int m_Dimension;
+	unsigned int m_Size;
+	std::vector<float> m_Values;
+
+	float* Get(unsigned int vertex)
+	{
+		return &m_Values[(size_t)vertex * m_Size];
+	}
+
+	/**
+	 *	@return p'Ap + 2b'p + c of a vertex's quadric
+	 */
+	float Sum(unsigned int vertex, const float* point) const
+	{
+		unsigned int d = m_Dimension;
+		const float* q = &m_Values[(size_t)vertex * m_Size];
+		float error = 0.0f;
+		unsigned int k = 0;
+		for (unsigned int i = 0; i < d; i++)
+		{
+			error += q[k++] * point[i] * point[i];
+			for (unsigned int j = i + 1; j < d; j++)
+			{
+				error += 2.0f * q[k++] * point[i] * point[j];
+			}
+		}
+		for (unsigned int i = 0; i < d; i++)
+		{
+			error += 2.0f * q[k++] * point[i];
+		}
+		return error + q[k];
+	}
+
+	float Dot(const float* a, const float* b) const
+	{
+		float result = 0.0f;
+		for (unsigned int i = 0; i < m_Dimension; i++)
+		{
+			result += a[i] * b[i];
+		}
+		return result;
+	}
+
+	void Scale(float* a, float scale) const
+	{
+		for (unsigned int i = 0; i < m_Dimension; i++)
+		{
+			a[i] *= scale;
+		}
+	}
+};
+
+/**
+ *	An edge collapse moving From onto To
+ */
+struct Collapse
+{
+	unsigned int From;
+	unsigned int To;
+	float Error;
+};
+
+static void Normal(const float* a, const float* b, const float* c, float* normal)
+{
+	float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+	float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+	normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+unsigned int MeshSimplifier::Simplify(unsigned int * destination, const unsigned int * indices, unsigned int indexCount,
+	const float * positions, unsigned int vertexCount, unsigned int positionStride, unsigned int targetIndexCount,
+	float targetError, float * resultError, const SimplifyAttributes & attributes)
+{
+	ASSERT(indexCount % 3 == 0);
+	ASSERT(attributes.Count <= MaxAttributes);
+
+	std::vector<unsigned int> current(indices, indices + indexCount);
+	unsigned int d = 3 + attributes.Count;
+
+	// Points scaled so the mesh is 1 across, making errors independent of its size
+	float min[3] = { 0.0f, 0.0f, 0.0f };
+	float max[3] = { 0.0f, 0.0f, 0.0f };
+	for (unsigned int v = 0; v < vertexCount; v++)
+	{
+		const float* p = (const float*)((const unsigned char*)positions + (size_t)v * positionStride);
+		for (unsigned int axis = 0; axis < 3; axis++)
+		{
+			min[axis] = v == 0 || p[axis] < min[axis] ? p[axis] : min[axis];
+			max[axis] = v == 0 || p[axis] > max[axis] ? p[axis] : max[axis];
+		}
+	}
+	float extent = std::max(max[0] - min[0], std::max(max[1] - min[1], max[2] - min[2]));
+	float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+
+	std::vector<float> points((size_t)vertexCount * d);
+	for (unsigned int v = 0; v < vertexCount; v++)
+	{
+		float* point = &points[(size_t)v * d];
+		const float* p = (const float*)((const unsigned char*)positions + (size_t)v * positionStride);
+		for (unsigned int axis = 0; axis < 3; axis++)
+		{
+			point[axis] = (p[axis] - min[axis]) * scale;
+		}
+		if (attributes.Count)
+		{
+			const float* a = (const float*)((const unsigned char*)attributes.Data + (size_t)v * attributes.Stride);
+			for (unsigned int i = 0; i < attributes.Count; i++)
+			{
+				point[3 + i] = a[i] * (attributes.Weights ? attributes.Weights[i] : 1.0f);
+			}
+		}
+	}
+
+	QuadricSet quadrics(vertexCount, d);
+	for (unsigned int i = 0; i < indexCount; i += 3)
+	{
+		quadrics.AddTriangle(&current[i], &points[(size_t)current[i] * d], &points[(size_t)current[i + 1] * d], &points[(size_t)current[i + 2] * d]);
+	}
+
+	// An edge used by one triangle only is on a border or a seam, its vertices stay where they are
+	std::vector<bool> locked(vertexCount, false);
+	{
+		std::unordered_set<unsigned long long> edges;
+		edges.reserve(indexCount);
+		for (unsigned int i = 0; i < indexCount; i++)
+		{
+			unsigned int a = current[i];
+			unsigned int b = current[i - i % 3 + (i + 1) % 3];
+			edges.insert((unsigned long long)a << 32 | b);
+		}
+		for (unsigned int i = 0; i < indexCount; i++)
+		{
+			unsigned int a = current[i];
+			unsigned int b = current[i - i % 3 + (i + 1) % 3];
+			if (edges.find((unsigned long long)b << 32 | a) == edges.end())
+			{
+				locked[a] = true;
+				locked[b] = true;
+			}
+		}
+	}
+
+	float limit = targetError * targetError;
+	float reached = 0.0f;
+	std::vector<Collapse> collapses;
+	std::vector<unsigned int> offsets(vertexCount + 1);
+	std::vector<unsigned int> triangles;
+	std::vector<unsigned int> remap(vertexCount);
+	std::vector<bool> touched(vertexCount);
+
+	// Each pass collapses the cheapest edges whose neighbourhoods do not overlap, then rebuilds the triangles
+	while (current.size() > targetIndexCount)
+	{
+		unsigned int count = (unsigned int)current.size();
+
+		// Triangles around each vertex
+		std::fill(offsets.begin(), offsets.end(), 0);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			offsets[current[i] + 1]++;
+		}
+		for (unsigned int v = 0; v < vertexCount; v++)
+		{
+			offsets[v + 1] += offsets[v];
+		}
+		triangles.resize(count);
+		{
+			std::vector<unsigned int> filled(offsets.begin(), offsets.end() - 1);
+			for (unsigned int i = 0; i < count; i++)
+			{
+				triangles[filled[current[i]]++] = i / 3;
+			}
+		}
+
+		// The cheaper direction of every edge
+		collapses.clear();
+		for (unsigned int i = 0; i < count; i++)
+		{
+			unsigned int a = current[i];
+			unsigned int b = current[i - i % 3 + (i + 1) % 3];
+			const float* pa = &points[(size_t)a * d];
+			const float* pb = &points[(size_t)b * d];
+			float ab = locked[a] ? -1.0f : quadrics.Evaluate(a, b, pb);
+			float ba = locked[b] ? -1.0f : quadrics.Evaluate(a, b, pa);
+			if (ab >= 0.0f && (ba < 0.0f || ab <= ba))
+			{
+				collapses.push_back({ a, b, ab });
+			}
+			else if (ba >= 0.0f)
+			{
+				collapses.push_back({ b, a, ba });
+			}
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y)
+		{
+			return x.Error < y.Error;
+		});
+
+		for (unsigned int v = 0; v < vertexCount; v++)
+		{
+			remap[v] = v;
+		}
+		std::fill(touched.begin(), touched.end(), false);
+
+		unsigned int trianglesToRemove = (count - targetIndexCount + 2) / 3;
+		unsigned int removed = 0;
+		for (const Collapse& collapse : collapses)
+		{
+			if (collapse.Error > limit || removed >= trianglesToRemove)
+			{
+				break;
+			}
+			if (touched[collapse.From] || touched[collapse.To])
+			{
+				continue;
+			}
+
+			// Moving From must not turn any of its other triangles over
+			const float* to = &points[(size_t)collapse.To * d];
+			bool flips = false;
+			unsigned int shared = 0;
+			for (unsigned int t = offsets[collapse.From]; t < offsets[collapse.From + 1] && !flips; t++)
+			{
+				const unsigned int* triangle = &current[triangles[t] * 3];
+				if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+				{
+					shared++;
+					continue;
+				}
+				const float* before[3];
+				const float* after[3];
+				for (unsigned int corner = 0; corner < 3; corner++)
+				{
+					before[corner] = &points[(size_t)triangle[corner] * d];
+					after[corner] = triangle[corner] == collapse.From ? to : before[corner];
+				}
+				float n0[3];
+				float n1[3];
+				Normal(before[0], before[1], before[2], n0);
+				Normal(after[0], after[1], after[2], n1);
+				flips = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] <= 0.0f;
+			}
+			if (flips)
+			{
+				continue;
+			}
+
+			remap[collapse.From] = collapse.To;
+			quadrics.Add(collapse.To, collapse.From);
+			reached = std::max(reached, collapse.Error);
+			removed += shared;
+
+			// Nothing around From may change again this pass, as the checks above relied on it
+			for (unsigned int t = offsets[collapse.From]; t < offsets[collapse.From + 1]; t++)
+			{
+				const unsigned int* triangle = &current[triangles[t] * 3];
+				touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+			}
+		}
+
+		if (removed == 0)
+		{
+			break;
+		}
+
+		unsigned int written = 0;
+		for (unsigned int i = 0; i < count; i += 3)
+		{
+			unsigned int a = remap[current[i]];
+			unsigned int b = remap[current[i + 1]];
+			unsigned int c = remap[current[i + 2]];
+			if (a != b && b != c && c != a)
+			{
+				current[written++] = a;
+				current[written++] = b;
+				current[written++] = c;
+			}
+		}
+		current.resize(written);
+	}
+
+	if (resultError)
+	{
+		*resultError = std::sqrt(reached);
+	}
+	std::memcpy(destination, current.data(), current.size() * sizeof(unsigned int));
+	return (unsigned int)current.size();
+}
+
+std::vector<MeshLod> MeshSimplifier::BuildLods(std::vector<unsigned int>& lodIndices, const unsigned int * indices, unsigned int indexCount,
+	const float * positions, unsigned int vertexCount, unsigned int positionStride, unsigned int maxLevels,
+	float reduction, float maxError, const SimplifyAttributes & attributes)
+{
+	std::vector<MeshLod> lods;
+	lodIndices.assign(indices, indices + indexCount);
+	lods.push_back({ 0, indexCount, 0.0f });
+
+	std::vector<unsigned int> level(indices, indices + indexCount);
+	float error = 0.0f;
+	while (lods.size() < maxLevels && error < maxError)
+	{
+		unsigned int previous = (unsigned int)level.size();
+		unsigned int target = (unsigned int)(previous * reduction) / 3 * 3;
+
+		// Each level starts from the one before, so the errors add up
+		float levelError = 0.0f;
+		unsigned int count = Simplify(level.data(), level.data(), previous, positions, vertexCount, positionStride, target,
+			maxError - error, &levelError, attributes);
+		if (count == 0 || count > previous - previous / 10)
+		{
+			break;
+		}
+		level.resize(count);
+		error += levelError;
+
+		std::vector<unsigned int> ordered(count);
+		MeshOptimizer::OptimizeVertexCache(ordered.data(), level.data(), count, vertexCount);
+
+		lods.push_back({ (unsigned int)lodIndices.size(), count, error });
+		lodIndices.insert(lodIndices.end(), ordered.begin(), ordered.end());
+	}
+	return lods;
+}
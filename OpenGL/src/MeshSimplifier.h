@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+/**
+ *	Vertex attributes that simplification should keep, besides the positions
+ */
+struct SimplifyAttributes
+{
+	// The attributes of the first vertex, the following vertices are Stride bytes apart
+	const float* Data = nullptr;
+	unsigned int Stride = 0;
+	// Floats per vertex, at most MeshSimplifier::MaxAttributes
+	unsigned int Count = 0;
+	// How much a difference in each attribute counts compared to positions, which are scaled so the
+	// mesh is 1 across. Null weighs every attribute 1.
+	const float* Weights = nullptr;
+};
+
+/**
+ *	One level of detail, a range of an index buffer holding every level one after another
+ */
+struct MeshLod
+{
+	unsigned int FirstIndex;
+	unsigned int IndexCount;
+	// Largest distance the surface moved, relative to the size of the mesh
+	float Error;
+};
+
+/**
+ *	Reduces the triangle count of indexed meshes for levels of detail, using quadric error metrics
+ *	(Garland and Heckbert, "Simplifying Surfaces with Color and Texture using Quadric Error Metrics", 1998).
+ *
+ *	Edges are collapsed onto one of their vertices rather than a new one, so every level keeps using
+ *	the original vertex buffer and only the indices change. Vertices on open borders, which include the
+ *	seams where vertices are split for different UVs or normals, never move, so seams do not tear.
+ */
+class MeshSimplifier
+{
+public:
+	/**
+	 *	Most attribute floats per vertex taken into account
+	 */
+	static const unsigned int MaxAttributes = 8;
+
+	/**
+	 *	Removes triangles until at most targetIndexCount indices are left, or no collapse stays under targetError
+	 *	@param destination Receives the indices, at most indexCount, may be the same as indices
+	 *	@param positions x, y, z of the first vertex, the following vertices are positionStride bytes apart
+	 *	@param targetError The error allowed, relative to the size of the mesh, e.g. 0.01 for 1%
+	 *	@param resultError Set to the error reached, relative to the size of the mesh, unless null
+	 *	@return the number of indices left
+	 */
+	static unsigned int Simplify(unsigned int* destination, const unsigned int* indices, unsigned int indexCount,
+		const float* positions, unsigned int vertexCount, unsigned int positionStride, unsigned int targetIndexCount,
+		float targetError, float* resultError = nullptr, const SimplifyAttributes& attributes = SimplifyAttributes());
+
+	/**
+	 *	Builds a chain of levels of detail, each about reduction times the triangles of the one before and
+	 *	ordered for the vertex cache. Level 0 is the full mesh. Stops early once a level would exceed
+	 *	maxError or barely shrinks.
+	 *	@param lodIndices Receives the indices of every level one after another, for a single IndexBuffer
+	 *	@return the levels, finest first
+	 */
+	static std::vector<MeshLod> BuildLods(std::vector<unsigned int>& lodIndices, const unsigned int* indices, unsigned int indexCount,
+		const float* positions, unsigned int vertexCount, unsigned int positionStride, unsigned int maxLevels,
+		float reduction = 0.5f, float maxError = 0.05f, const SimplifyAttributes& attributes = SimplifyAttributes());
+};
@@ -0,0 +1,762 @@
+#include "NullGL.h"
+
+#ifdef GL_NULL_BACKEND
+
+#include <GL/glew.h>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+/**
+ *	Everything the null backend remembers between calls
+ */
+struct NullGLState
+{
+	NullGL::Stats Stats;
+	std::map<std::string, unsigned long long> CallCounts;
+
+	GLuint NextName = 1;
+	GLint MajorVersion = 3;
+	GLint MinorVersion = 3;
+	GLuint ActiveTexture = 0;
+
+	// Buffer bound to each target, needed to know what Map/SubData refer to
+	std::unordered_map<GLenum, GLuint> BoundBuffers;
+	std::unordered_map<GLuint, GLsizeiptr> BufferSizes;
+	// Contents are only kept for buffers that are mapped or read by the null backend (indirect draws)
+	std::unordered_map<GLuint, std::vector<unsigned char>> BufferContents;
+	// Bytes counted as uploaded when a mapped buffer is unmapped
+	std::unordered_map<GLuint, GLsizeiptr> MappedLengths;
+
+	std::unordered_map<GLuint, std::unordered_map<std::string, GLint>> UniformLocations;
+};
+
+static NullGLState s_State;
+
+/**
+ *	@return the counter of a function, the reference stays valid for the lifetime of the program
+ */
+static unsigned long long& CallCount(const char* function)
+{
+	return s_State.CallCounts[function];
+}
+
+// Counts a call of the enclosing function, the counter lookup is only done on the first call
+#define NULLGL_RECORD(name) static unsigned long long& callCount = CallCount(name); callCount++; s_State.Stats.Calls++
+
+static void GenNames(GLsizei n, GLuint* names)
+{
+	for (GLsizei i = 0; i < n; i++)
+	{
+		names[i] = s_State.NextName++;
+	}
+}
+
+static GLuint BoundBuffer(GLenum target)
+{
+	auto it = s_State.BoundBuffers.find(target);
+	return it == s_State.BoundBuffers.end() ? 0 : it->second;
+}
+
+static std::vector<unsigned char>& BufferContents(GLuint buffer)
+{
+	std::vector<unsigned char>& contents = s_State.BufferContents[buffer];
+	contents.resize((size_t)s_State.BufferSizes[buffer]);
+	return contents;
+}
+
+static void RecordDraw(GLenum mode, GLsizei count, GLsizei instanceCount)
+{
+	s_State.Stats.Draws++;
+	if (mode == GL_TRIANGLES)
+	{
+		s_State.Stats.Triangles += (unsigned long long)(count / 3) * instanceCount;
+	}
+}
+
+static unsigned int BytesPerPixel(GLenum format, GLenum type)
+{
+	unsigned int components = format == GL_RGBA ? 4 : format == GL_RGB ? 3 : format == GL_RG ? 2 : 1;
+	unsigned int size = (type == GL_FLOAT || type == GL_UNSIGNED_INT || type == GL_INT) ? 4
+		: (type == GL_UNSIGNED_SHORT || type == GL_SHORT || type == GL_HALF_FLOAT) ? 2 : 1;
+	return components * size;
+}
+
+// GL 1.1 functions, which are exported by the GL library rather than loaded by GLEW
+
+extern "C"
+{
+
+void GLAPIENTRY glClear(GLbitfield mask)
+{
+	NULLGL_RECORD("glClear");
+}
+
+void GLAPIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+	NULLGL_RECORD("glDrawElements");
+	s_State.Stats.DrawCalls++;
+	RecordDraw(mode, count, 1);
+}
+
+GLenum GLAPIENTRY glGetError(void)
+{
+	NULLGL_RECORD("glGetError");
+	return GL_NO_ERROR;
+}
+
+void GLAPIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+	NULLGL_RECORD("glTexParameteri");
+}
+
+const GLubyte* GLAPIENTRY glGetString(GLenum name)
+{
+	NULLGL_RECORD("glGetString");
+	switch (name)
+	{
+	case GL_VENDOR: return (const GLubyte*)"NullGL";
+	case GL_RENDERER: return (const GLubyte*)"NullGL recording backend";
+	case GL_VERSION: return (const GLubyte*)"3.3 NullGL";
+	case GL_SHADING_LANGUAGE_VERSION: return (const GLubyte*)"3.30 NullGL";
+	}
+	return (const GLubyte*)"";
+}
+
+void GLAPIENTRY glEnable(GLenum cap)
+{
+	NULLGL_RECORD("glEnable");
+	s_State.Stats.StateChanges++;
+}
+
+void GLAPIENTRY glDisable(GLenum cap)
+{
+	NULLGL_RECORD("glDisable");
+	s_State.Stats.StateChanges++;
+}
+
+void GLAPIENTRY glFinish(void)
+{
+	NULLGL_RECORD("glFinish");
+}
+
+void GLAPIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	NULLGL_RECORD("glBlendFunc");
+	s_State.Stats.StateChanges++;
+}
+
+void GLAPIENTRY glBindTexture(GLenum target, GLuint texture)
+{
+	NULLGL_RECORD("glBindTexture");
+	s_State.Stats.StateChanges++;
+}
+
+void GLAPIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	NULLGL_RECORD("glViewport");
+	s_State.Stats.StateChanges++;
+}
+
+void GLAPIENTRY glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+	NULLGL_RECORD("glTexImage2D");
+	if (pixels && BoundBuffer(GL_PIXEL_UNPACK_BUFFER) == 0)
+	{
+		s_State.Stats.BytesUploaded += (unsigned long long)width * height * BytesPerPixel(format, type);
+	}
+}
+
+void GLAPIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+{
+	NULLGL_RECORD("glTexSubImage2D");
+	if (BoundBuffer(GL_PIXEL_UNPACK_BUFFER) == 0)
+	{
+		s_State.Stats.BytesUploaded += (unsigned long long)width * height * BytesPerPixel(format, type);
+	}
+}
+
+void GLAPIENTRY glPixelStorei(GLenum pname, GLint param)
+{
+	NULLGL_RECORD("glPixelStorei");
+}
+
+void GLAPIENTRY glGetIntegerv(GLenum pname, GLint* params)
+{
+	NULLGL_RECORD("glGetIntegerv");
+	switch (pname)
+	{
+	case GL_ACTIVE_TEXTURE: *params = GL_TEXTURE0 + s_State.ActiveTexture; break;
+	case GL_MAX_TEXTURE_IMAGE_UNITS: *params = 16; break;
+	case GL_MAJOR_VERSION: *params = s_State.MajorVersion; break;
+	case GL_MINOR_VERSION: *params = s_State.MinorVersion; break;
+	default: *params = 0; break;
+	}
+}
+
+void GLAPIENTRY glGenTextures(GLsizei n, GLuint* textures)
+{
+	NULLGL_RECORD("glGenTextures");
+	GenNames(n, textures);
+}
+
+void GLAPIENTRY glDeleteTextures(GLsizei n, const GLuint* textures)
+{
+	NULLGL_RECORD("glDeleteTextures");
+}
+
+}
+
+// Functions GLEW loads at runtime, the backend sets GLEW's function pointers to these instead
+
+static void GLAPIENTRY NullActiveTexture(GLenum texture)
+{
+	NULLGL_RECORD("glActiveTexture");
+	s_State.ActiveTexture = texture - GL_TEXTURE0;
+	s_State.Stats.StateChanges++;
+}
+
+static void GLAPIENTRY NullAttachShader(GLuint program, GLuint shader)
+{
+	NULLGL_RECORD("glAttachShader");
+}
+
+static void GLAPIENTRY NullBindBuffer(GLenum target, GLuint buffer)
+{
+	NULLGL_RECORD("glBindBuffer");
+	s_State.BoundBuffers[target] = buffer;
+	s_State.Stats.StateChanges++;
+}
+
+static void GLAPIENTRY NullBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	NULLGL_RECORD("glBindFramebuffer");
+	s_State.Stats.StateChanges++;
+}
+
+static void GLAPIENTRY NullBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+	NULLGL_RECORD("glBindRenderbuffer");
+}
+
+static void GLAPIENTRY NullBindVertexArray(GLuint array)
+{
+	NULLGL_RECORD("glBindVertexArray");
+	s_State.Stats.StateChanges++;
+}
+
+static void GLAPIENTRY NullBindVertexBuffer(GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride)
+{
+	NULLGL_RECORD("glBindVertexBuffer");
+	s_State.Stats.StateChanges++;
+}
+
+static void GLAPIENTRY NullBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+	NULLGL_RECORD("glBufferData");
+	GLuint buffer = BoundBuffer(target);
+	s_State.BufferSizes[buffer] = size;
+	if (data)
+	{
+		s_State.Stats.BytesUploaded += size;
+		if (target == GL_DRAW_INDIRECT_BUFFER)
+		{
+			std::memcpy(BufferContents(buffer).data(), data, size);
+		}
+	}
+}
+
+static void GLAPIENTRY NullBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags)
+{
+	NULLGL_RECORD("glBufferStorage");
+	s_State.BufferSizes[BoundBuffer(target)] = size;
+	if (data)
+	{
+		s_State.Stats.BytesUploaded += size;
+	}
+}
+
+static void GLAPIENTRY NullBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	NULLGL_RECORD("glBufferSubData");
+	s_State.Stats.BytesUploaded += size;
+	GLuint buffer = BoundBuffer(target);
+	if (target == GL_DRAW_INDIRECT_BUFFER)
+	{
+		std::memcpy(BufferContents(buffer).data() + offset, data, size);
+	}
+}
+
+static GLenum GLAPIENTRY NullCheckFramebufferStatus(GLenum target)
+{
+	NULLGL_RECORD("glCheckFramebufferStatus");
+	return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static GLenum GLAPIENTRY NullClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+	NULLGL_RECORD("glClientWaitSync");
+	return GL_ALREADY_SIGNALED;
+}
+
+static void GLAPIENTRY NullCompileShader(GLuint shader)
+{
+	NULLGL_RECORD("glCompileShader");
+}
+
+static void GLAPIENTRY NullCopyBufferSubData(GLenum readtarget, GLenum writetarget, GLintptr readoffset, GLintptr writeoffset, GLsizeiptr size)
+{
+	NULLGL_RECORD("glCopyBufferSubData");
+}
+
+static GLuint GLAPIENTRY NullCreateProgram(void)
+{
+	NULLGL_RECORD("glCreateProgram");
+	return s_State.NextName++;
+}
+
+static GLuint GLAPIENTRY NullCreateShader(GLenum type)
+{
+	NULLGL_RECORD("glCreateShader");
+	return s_State.NextName++;
+}
+
+static void GLAPIENTRY NullDebugMessageCallback(GLDEBUGPROC callback, const void* userParam)
+{
+	NULLGL_RECORD("glDebugMessageCallback");
+}
+
+static void GLAPIENTRY NullDebugMessageCallbackARB(GLDEBUGPROCARB callback, const void* userParam)
+{
+	NULLGL_RECORD("glDebugMessageCallbackARB");
+}
+
+static void GLAPIENTRY NullDebugMessageControl(GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint* ids, GLboolean enabled)
+{
+	NULLGL_RECORD("glDebugMessageControl");
+}
+
+static void GLAPIENTRY NullDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	NULLGL_RECORD("glDeleteBuffers");
+	for (GLsizei i = 0; i < n; i++)
+	{
+		s_State.BufferSizes.erase(buffers[i]);
+		s_State.BufferContents.erase(buffers[i]);
+		s_State.MappedLengths.erase(buffers[i]);
+	}
+}
+
+static void GLAPIENTRY NullDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+	NULLGL_RECORD("glDeleteFramebuffers");
+}
+
+static void GLAPIENTRY NullDeleteProgram(GLuint program)
+{
+	NULLGL_RECORD("glDeleteProgram");
+	s_State.UniformLocations.erase(program);
+}
+
+static void GLAPIENTRY NullDeleteQueries(GLsizei n, const GLuint* ids)
+{
+	NULLGL_RECORD("glDeleteQueries");
+}
+
+static void GLAPIENTRY NullDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+	NULLGL_RECORD("glDeleteRenderbuffers");
+}
+
+static void GLAPIENTRY NullDeleteShader(GLuint shader)
+{
+	NULLGL_RECORD("glDeleteShader");
+}
+
+static void GLAPIENTRY NullDeleteSync(GLsync sync)
+{
+	NULLGL_RECORD("glDeleteSync");
+}
+
+static void GLAPIENTRY NullDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+	NULLGL_RECORD("glDeleteVertexArrays");
+}
+
+static void GLAPIENTRY NullDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, void* indices, GLint basevertex)
+{
+	NULLGL_RECORD("glDrawElementsBaseVertex");
+	s_State.Stats.DrawCalls++;
+	RecordDraw(mode, count, 1);
+}
+
+static void GLAPIENTRY NullDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei primcount)
+{
+	NULLGL_RECORD("glDrawElementsInstanced");
+	s_State.Stats.DrawCalls++;
+	RecordDraw(mode, count, primcount);
+}
+
+static void GLAPIENTRY NullDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei primcount, GLint basevertex)
+{
+	NULLGL_RECORD("glDrawElementsInstancedBaseVertex");
+	s_State.Stats.DrawCalls++;
+	RecordDraw(mode, count, primcount);
+}
+
+static void GLAPIENTRY NullEnableVertexAttribArray(GLuint index)
+{
+	NULLGL_RECORD("glEnableVertexAttribArray");
+}
+
+static GLsync GLAPIENTRY NullFenceSync(GLenum condition, GLbitfield flags)
+{
+	NULLGL_RECORD("glFenceSync");
+	// Any non-null handle will do, it is never looked at
+	return (GLsync)(size_t)s_State.NextName++;
+}
+
+static void GLAPIENTRY NullFlushMappedBufferRange(GLenum target, GLintptr offset, GLsizeiptr length)
+{
+	NULLGL_RECORD("glFlushMappedBufferRange");
+	s_State.Stats.BytesUploaded += length;
+}
+
+static void GLAPIENTRY NullFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+	NULLGL_RECORD("glFramebufferRenderbuffer");
+}
+
+static void GLAPIENTRY NullGenBuffers(GLsizei n, GLuint* buffers)
+{
+	NULLGL_RECORD("glGenBuffers");
+	GenNames(n, buffers);
+}
+
+static void GLAPIENTRY NullGenFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+	NULLGL_RECORD("glGenFramebuffers");
+	GenNames(n, framebuffers);
+}
+
+static void GLAPIENTRY NullGenQueries(GLsizei n, GLuint* ids)
+{
+	NULLGL_RECORD("glGenQueries");
+	GenNames(n, ids);
+}
+
+static void GLAPIENTRY NullGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+	NULLGL_RECORD("glGenRenderbuffers");
+	GenNames(n, renderbuffers);
+}
+
+static void GLAPIENTRY NullGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+	NULLGL_RECORD("glGenVertexArrays");
+	GenNames(n, arrays);
+}
+
+static void GLAPIENTRY NullGetInteger64v(GLenum pname, GLint64* params)
+{
+	NULLGL_RECORD("glGetInteger64v");
+	*params = 0;
+}
+
+static void GLAPIENTRY NullGetQueryObjectiv(GLuint id, GLenum pname, GLint* params)
+{
+	NULLGL_RECORD("glGetQueryObjectiv");
+	// Every query is finished straight away, with a result of 0
+	*params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+
+static void GLAPIENTRY NullGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params)
+{
+	NULLGL_RECORD("glGetQueryObjectui64v");
+	*params = 0;
+}
+
+static void GLAPIENTRY NullGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+	NULLGL_RECORD("glGetShaderInfoLog");
+	if (length)
+	{
+		*length = 0;
+	}
+	if (bufSize > 0)
+	{
+		infoLog[0] = '\0';
+	}
+}
+
+static void GLAPIENTRY NullGetShaderiv(GLuint shader, GLenum pname, GLint* param)
+{
+	NULLGL_RECORD("glGetShaderiv");
+	*param = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+static GLint GLAPIENTRY NullGetUniformLocation(GLuint program, const GLchar* name)
+{
+	NULLGL_RECORD("glGetUniformLocation");
+	// Every uniform exists, each name gets its own location per program
+	std::unordered_map<std::string, GLint>& locations = s_State.UniformLocations[program];
+	auto it = locations.find(name);
+	if (it == locations.end())
+	{
+		it = locations.insert({ name, (GLint)locations.size() }).first;
+	}
+	return it->second;
+}
+
+static void GLAPIENTRY NullLinkProgram(GLuint program)
+{
+	NULLGL_RECORD("glLinkProgram");
+}
+
+static void* GLAPIENTRY NullMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+	NULLGL_RECORD("glMapBufferRange");
+	GLuint buffer = BoundBuffer(target);
+	// Explicitly flushed ranges are counted when they are flushed instead
+	s_State.MappedLengths[buffer] = (access & GL_MAP_FLUSH_EXPLICIT_BIT) ? 0 : length;
+	return BufferContents(buffer).data() + offset;
+}
+
+static void GLAPIENTRY NullMultiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei primcount, GLsizei stride)
+{
+	NULLGL_RECORD("glMultiDrawElementsIndirect");
+	s_State.Stats.DrawCalls++;
+
+	// The commands are read from the bound indirect buffer, as the GPU would
+	const std::vector<unsigned char>& contents = BufferContents(BoundBuffer(GL_DRAW_INDIRECT_BUFFER));
+	if (stride == 0)
+	{
+		stride = 5 * sizeof(GLuint);
+	}
+	for (GLsizei i = 0; i < primcount; i++)
+	{
+		size_t offset = (size_t)indirect + (size_t)i * stride;
+		if (offset + 2 * sizeof(GLuint) > contents.size())
+		{
+			break;
+		}
+		GLuint command[2];
+		std::memcpy(command, contents.data() + offset, sizeof(command));
+		RecordDraw(mode, command[0], command[1]);
+	}
+}
+
+static void GLAPIENTRY NullQueryCounter(GLuint id, GLenum target)
+{
+	NULLGL_RECORD("glQueryCounter");
+}
+
+static void GLAPIENTRY NullRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+	NULLGL_RECORD("glRenderbufferStorage");
+}
+
+static void GLAPIENTRY NullShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+{
+	NULLGL_RECORD("glShaderSource");
+}
+
+static void GLAPIENTRY NullUniform1i(GLint location, GLint v0)
+{
+	NULLGL_RECORD("glUniform1i");
+	s_State.Stats.UniformUploads++;
+}
+
+static void GLAPIENTRY NullUniform1iv(GLint location, GLsizei count, const GLint* value)
+{
+	NULLGL_RECORD("glUniform1iv");
+	s_State.Stats.UniformUploads++;
+}
+
+static void GLAPIENTRY NullUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+	NULLGL_RECORD("glUniform4f");
+	s_State.Stats.UniformUploads++;
+}
+
+static GLboolean GLAPIENTRY NullUnmapBuffer(GLenum target)
+{
+	NULLGL_RECORD("glUnmapBuffer");
+	s_State.Stats.BytesUploaded += s_State.MappedLengths[BoundBuffer(target)];
+	return GL_TRUE;
+}
+
+static void GLAPIENTRY NullUseProgram(GLuint program)
+{
+	NULLGL_RECORD("glUseProgram");
+	s_State.Stats.StateChanges++;
+}
+
+static void GLAPIENTRY NullValidateProgram(GLuint program)
+{
+	NULLGL_RECORD("glValidateProgram");
+}
+
+static void GLAPIENTRY NullVertexAttribBinding(GLuint attribindex, GLuint bindingindex)
+{
+	NULLGL_RECORD("glVertexAttribBinding");
+}
+
+static void GLAPIENTRY NullVertexAttribDivisor(GLuint index, GLuint divisor)
+{
+	NULLGL_RECORD("glVertexAttribDivisor");
+}
+
+static void GLAPIENTRY NullVertexAttribFormat(GLuint attribindex, GLint size, GLenum type, GLboolean normalized, GLuint relativeoffset)
+{
+	NULLGL_RECORD("glVertexAttribFormat");
+}
+
+static void GLAPIENTRY NullVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)
+{
+	NULLGL_RECORD("glVertexAttribPointer");
+}
+
+static void GLAPIENTRY NullVertexBindingDivisor(GLuint bindingindex, GLuint divisor)
+{
+	NULLGL_RECORD("glVertexBindingDivisor");
+}
+
+// The definitions GLEW would otherwise provide
+
+extern "C"
+{
+
+PFNGLACTIVETEXTUREPROC __glewActiveTexture = NullActiveTexture;
+PFNGLATTACHSHADERPROC __glewAttachShader = NullAttachShader;
+PFNGLBINDBUFFERPROC __glewBindBuffer = NullBindBuffer;
+PFNGLBINDFRAMEBUFFERPROC __glewBindFramebuffer = NullBindFramebuffer;
+PFNGLBINDRENDERBUFFERPROC __glewBindRenderbuffer = NullBindRenderbuffer;
+PFNGLBINDVERTEXARRAYPROC __glewBindVertexArray = NullBindVertexArray;
+PFNGLBINDVERTEXBUFFERPROC __glewBindVertexBuffer = NullBindVertexBuffer;
+PFNGLBUFFERDATAPROC __glewBufferData = NullBufferData;
+PFNGLBUFFERSTORAGEPROC __glewBufferStorage = NullBufferStorage;
+PFNGLBUFFERSUBDATAPROC __glewBufferSubData = NullBufferSubData;
+PFNGLCHECKFRAMEBUFFERSTATUSPROC __glewCheckFramebufferStatus = NullCheckFramebufferStatus;
+PFNGLCLIENTWAITSYNCPROC __glewClientWaitSync = NullClientWaitSync;
+PFNGLCOMPILESHADERPROC __glewCompileShader = NullCompileShader;
+PFNGLCOPYBUFFERSUBDATAPROC __glewCopyBufferSubData = NullCopyBufferSubData;
+PFNGLCREATEPROGRAMPROC __glewCreateProgram = NullCreateProgram;
+PFNGLCREATESHADERPROC __glewCreateShader = NullCreateShader;
+PFNGLDEBUGMESSAGECALLBACKPROC __glewDebugMessageCallback = NullDebugMessageCallback;
+PFNGLDEBUGMESSAGECALLBACKARBPROC __glewDebugMessageCallbackARB = NullDebugMessageCallbackARB;
+PFNGLDEBUGMESSAGECONTROLPROC __glewDebugMessageControl = NullDebugMessageControl;
+PFNGLDELETEBUFFERSPROC __glewDeleteBuffers = NullDeleteBuffers;
+PFNGLDELETEFRAMEBUFFERSPROC __glewDeleteFramebuffers = NullDeleteFramebuffers;
+PFNGLDELETEPROGRAMPROC __glewDeleteProgram = NullDeleteProgram;
+PFNGLDELETEQUERIESPROC __glewDeleteQueries = NullDeleteQueries;
+PFNGLDELETERENDERBUFFERSPROC __glewDeleteRenderbuffers = NullDeleteRenderbuffers;
+PFNGLDELETESHADERPROC __glewDeleteShader = NullDeleteShader;
+PFNGLDELETESYNCPROC __glewDeleteSync = NullDeleteSync;
+PFNGLDELETEVERTEXARRAYSPROC __glewDeleteVertexArrays = NullDeleteVertexArrays;
+PFNGLDRAWELEMENTSBASEVERTEXPROC __glewDrawElementsBaseVertex = NullDrawElementsBaseVertex;
+PFNGLDRAWELEMENTSINSTANCEDPROC __glewDrawElementsInstanced = NullDrawElementsInstanced;
+PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC __glewDrawElementsInstancedBaseVertex = NullDrawElementsInstancedBaseVertex;
+PFNGLENABLEVERTEXATTRIBARRAYPROC __glewEnableVertexAttribArray = NullEnableVertexAttribArray;
+PFNGLFENCESYNCPROC __glewFenceSync = NullFenceSync;
+PFNGLFLUSHMAPPEDBUFFERRANGEPROC __glewFlushMappedBufferRange = NullFlushMappedBufferRange;
+PFNGLFRAMEBUFFERRENDERBUFFERPROC __glewFramebufferRenderbuffer = NullFramebufferRenderbuffer;
+PFNGLGENBUFFERSPROC __glewGenBuffers = NullGenBuffers;
+PFNGLGENFRAMEBUFFERSPROC __glewGenFramebuffers = NullGenFramebuffers;
+PFNGLGENQUERIESPROC __glewGenQueries = NullGenQueries;
+PFNGLGENRENDERBUFFERSPROC __glewGenRenderbuffers = NullGenRenderbuffers;
+PFNGLGENVERTEXARRAYSPROC __glewGenVertexArrays = NullGenVertexArrays;
+PFNGLGETINTEGER64VPROC __glewGetInteger64v = NullGetInteger64v;
+PFNGLGETQUERYOBJECTIVPROC __glewGetQueryObjectiv = NullGetQueryObjectiv;
+PFNGLGETQUERYOBJECTUI64VPROC __glewGetQueryObjectui64v = NullGetQueryObjectui64v;
+PFNGLGETSHADERINFOLOGPROC __glewGetShaderInfoLog = NullGetShaderInfoLog;
+PFNGLGETSHADERIVPROC __glewGetShaderiv = NullGetShaderiv;
+PFNGLGETUNIFORMLOCATIONPROC __glewGetUniformLocation = NullGetUniformLocation;
+PFNGLLINKPROGRAMPROC __glewLinkProgram = NullLinkProgram;
+PFNGLMAPBUFFERRANGEPROC __glewMapBufferRange = NullMapBufferRange;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC __glewMultiDrawElementsIndirect = NullMultiDrawElementsIndirect;
+PFNGLQUERYCOUNTERPROC __glewQueryCounter = NullQueryCounter;
+PFNGLRENDERBUFFERSTORAGEPROC __glewRenderbufferStorage = NullRenderbufferStorage;
+PFNGLSHADERSOURCEPROC __glewShaderSource = NullShaderSource;
+PFNGLUNIFORM1IPROC __glewUniform1i = NullUniform1i;
+PFNGLUNIFORM1IVPROC __glewUniform1iv = NullUniform1iv;
+PFNGLUNIFORM4FPROC __glewUniform4f = NullUniform4f;
+PFNGLUNMAPBUFFERPROC __glewUnmapBuffer = NullUnmapBuffer;
+PFNGLUSEPROGRAMPROC __glewUseProgram = NullUseProgram;
+PFNGLVALIDATEPROGRAMPROC __glewValidateProgram = NullValidateProgram;
+PFNGLVERTEXATTRIBBINDINGPROC __glewVertexAttribBinding = NullVertexAttribBinding;
+PFNGLVERTEXATTRIBDIVISORPROC __glewVertexAttribDivisor = NullVertexAttribDivisor;
+PFNGLVERTEXATTRIBFORMATPROC __glewVertexAttribFormat = NullVertexAttribFormat;
+PFNGLVERTEXATTRIBPOINTERPROC __glewVertexAttribPointer = NullVertexAttribPointer;
+PFNGLVERTEXBINDINGDIVISORPROC __glewVertexBindingDivisor = NullVertexBindingDivisor;
+
+GLboolean __GLEW_VERSION_3_3 = GL_FALSE;
+GLboolean __GLEW_VERSION_4_0 = GL_FALSE;
+GLboolean __GLEW_VERSION_4_1 = GL_FALSE;
+GLboolean __GLEW_VERSION_4_2 = GL_FALSE;
+GLboolean __GLEW_VERSION_4_3 = GL_FALSE;
+GLboolean __GLEW_VERSION_4_4 = GL_FALSE;
+GLboolean __GLEW_VERSION_4_5 = GL_FALSE;
+GLboolean __GLEW_ARB_buffer_storage = GL_FALSE;
+GLboolean __GLEW_ARB_debug_output = GL_FALSE;
+GLboolean __GLEW_ARB_multi_draw_indirect = GL_FALSE;
+GLboolean __GLEW_ARB_vertex_attrib_binding = GL_FALSE;
+GLboolean __GLEW_KHR_debug = GL_FALSE;
+
+GLboolean glewExperimental = GL_FALSE;
+
+GLenum GLEWAPIENTRY glewInit(void)
+{
+	return GLEW_OK;
+}
+
+}
+
+void NullGL::Install(int majorVersion, int minorVersion)
+{
+	std::map<std::string, unsigned long long> callCounts;
+	callCounts.swap(s_State.CallCounts);
+	s_State = NullGLState();
+	// The counters are referenced by the functions that already ran, so the map itself must survive
+	s_State.CallCounts.swap(callCounts);
+	ResetStats();
+
+	s_State.MajorVersion = majorVersion;
+	s_State.MinorVersion = minorVersion;
+
+	int version = majorVersion * 10 + minorVersion;
+	__GLEW_VERSION_3_3 = version >= 33;
+	__GLEW_VERSION_4_0 = version >= 40;
+	__GLEW_VERSION_4_1 = version >= 41;
+	__GLEW_VERSION_4_2 = version >= 42;
+	__GLEW_VERSION_4_3 = version >= 43;
+	__GLEW_VERSION_4_4 = version >= 44;
+	__GLEW_VERSION_4_5 = version >= 45;
+}
+
+const NullGL::Stats& NullGL::GetStats()
+{
+	return s_State.Stats;
+}
+
+void NullGL::ResetStats()
+{
+	s_State.Stats = Stats();
+	for (auto& count : s_State.CallCounts)
+	{
+		count.second = 0;
+	}
+}
+
+const std::map<std::string, unsigned long long>& NullGL::GetCallCounts()
+{
+	return s_State.CallCounts;
+}
+
+unsigned long long NullGL::GetCallCount(const std::string & function)
+{
+	auto it = s_State.CallCounts.find(function);
+	return it == s_State.CallCounts.end() ? 0 : it->second;
+}
+
+#endif
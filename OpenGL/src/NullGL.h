@@ -0,0 +1,57 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+/**
+ *	A GL backend that records calls instead of running them, for measuring the renderer's own CPU
+ *	overhead and counting its GL calls on machines with no GPU or display.
+ *
+ *	Only available in builds that define GL_NULL_BACKEND. Those builds must not link opengl32/libGL or
+ *	GLEW, NullGL.cpp defines the GL entry points the renderer uses in their place. On Windows also
+ *	define WINGDIAPI as empty, so the GL 1.1 functions are not declared dllimport.
+ *
+ *	Objects get names and shaders always compile, but nothing is drawn and nothing can be read back,
+ *	except mapped buffer memory which is backed by ordinary memory.
+ */
+class NullGL
+{
+public:
+	/**
+	 *	Counters for everything recorded since the last ResetStats
+	 */
+	struct Stats
+	{
+		unsigned long long Calls = 0;
+		// glDraw* and glMultiDraw* calls
+		unsigned long long DrawCalls = 0;
+		// Draws, counting each draw of a multi draw
+		unsigned long long Draws = 0;
+		unsigned long long Triangles = 0;
+		// Data passed to buffers and textures, including flushed or unmapped mapped ranges
+		unsigned long long BytesUploaded = 0;
+		// Binds and fixed function state changes
+		unsigned long long StateChanges = 0;
+		unsigned long long UniformUploads = 0;
+	};
+
+	/**
+	 *	Resets all objects and counters and reports the given version, as if a context was made current.
+	 *	Extensions are all reported as unsupported.
+	 */
+	static void Install(int majorVersion = 3, int minorVersion = 3);
+
+	static const Stats& GetStats();
+
+	static void ResetStats();
+
+	/**
+	 *	@return how often each GL function was called since the last ResetStats, keyed by name
+	 */
+	static const std::map<std::string, unsigned long long>& GetCallCounts();
+
+	/**
+	 *	@return how often one GL function was called since the last ResetStats, e.g. "glBindBuffer"
+	 */
+	static unsigned long long GetCallCount(const std::string& function);
+};
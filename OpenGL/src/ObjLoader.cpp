@@ -0,0 +1,579 @@
+#include "ObjLoader.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+
+// Files are not split into chunks smaller than this, the tasks would cost more than they save
+static const size_t MinChunkSize = 64 * 1024;
+// A face corner without that index, e.g. the texture coordinate of "f 1//1"
+static const int MissingIndex = INT_MIN;
+static const unsigned int NoIndex = 0xFFFFFFFF;
+
+static const double s_PowersOfTen[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ *	A face corner as a chunk reads it, before the chunks in front of it are counted
+ */
+struct RawCorner
+{
+	// 0-based position, texture coordinate and normal indices, relative to the start of the chunk if
+	// the matching bit of Relative is set
+	int Index[3];
+	unsigned char Relative;
+};
+
+/**
+ *	A face corner with indices into the whole file's positions, texture coordinates and normals
+ */
+struct Corner
+{
+	unsigned int Index[3];
+};
+
+/**
+ *	The lines of one part of the file
+ */
+struct ObjChunk
+{
+	const char* Begin = nullptr;
+	const char* End = nullptr;
+	std::vector<float> Positions;
+	std::vector<float> TexCoords;
+	std::vector<float> Normals;
+	std::vector<RawCorner> Corners;
+	// Where this chunk's data starts in the whole file's
+	unsigned int FirstPosition = 0;
+	unsigned int FirstTexCoord = 0;
+	unsigned int FirstNormal = 0;
+	unsigned int FirstCorner = 0;
+	bool Valid = true;
+	bool HasTexCoords = false;
+	bool HasNormals = false;
+};
+
+static inline bool IsBlank(char c)
+{
+	return c == ' ' || c == '\t';
+}
+
+static inline bool IsDigit(char c)
+{
+	return (unsigned char)(c - '0') < 10;
+}
+
+/**
+ *	Reads a decimal number like strtof, without its locale lookups and error handling.
+ *	Digits past the 19th significant one are dropped, far beyond what a float keeps.
+ */
+static float ParseFloat(const char*& p, const char* end)
+{
+	while (p < end && IsBlank(*p))
+	{
+		p++;
+	}
+
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = *p == '-';
+		p++;
+	}
+
+	unsigned long long mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	while (p < end && IsDigit(*p))
+	{
+		if (digits < 19)
+		{
+			mantissa = mantissa * 10 + (*p - '0');
+			// Leading zeros are not significant
+			digits += mantissa != 0;
+		}
+		else
+		{
+			exponent++;
+		}
+		p++;
+	}
+	if (p < end && *p == '.')
+	{
+		p++;
+		while (p < end && IsDigit(*p))
+		{
+			if (digits < 19)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				digits += mantissa != 0;
+				exponent--;
+			}
+			p++;
+		}
+	}
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		p++;
+		bool negativeExponent = false;
+		if (p < end && (*p == '-' || *p == '+'))
+		{
+			negativeExponent = *p == '-';
+			p++;
+		}
+		int value = 0;
+		while (p < end && IsDigit(*p))
+		{
+			if (value < 10000)
+			{
+				value = value * 10 + (*p - '0');
+			}
+			p++;
+		}
+		exponent += negativeExponent ? -value : value;
+	}
+
+	// Powers of ten up to 22 are exact in a double, so dividing rounds only once
+	double result = (double)mantissa;
+	if (exponent < 0)
+	{
+		result = exponent >= -22 ? result / s_PowersOfTen[-exponent] : result * std::pow(10.0, exponent);
+	}
+	else if (exponent > 0)
+	{
+		result = exponent <= 22 ? result * s_PowersOfTen[exponent] : result * std::pow(10.0, exponent);
+	}
+	return (float)(negative ? -result : result);
+}
+
+/**
+ *	@return false if there was no number
+ */
+static bool ParseIndex(const char*& p, const char* end, int& value)
+{
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = *p == '-';
+		p++;
+	}
+	if (p >= end || !IsDigit(*p))
+	{
+		return false;
+	}
+
+	long long result = 0;
+	while (p < end && IsDigit(*p))
+	{
+		if (result <= INT_MAX)
+		{
+			result = result * 10 + (*p - '0');
+		}
+		p++;
+	}
+	// Too large to refer to anything, so it is rejected when resolved
+	if (result > INT_MAX)
+	{
+		result = INT_MAX;
+	}
+	value = (int)(negative ? -result : result);
+	return true;
+}
+
+/**
+ *	Reads the corners after "f" and splits the polygon into a triangle fan
+ */
+static void ParseFace(const char* p, const char* end, ObjChunk& chunk)
+{
+	unsigned int counts[3] =
+	{
+		(unsigned int)chunk.Positions.size() / 3,
+		(unsigned int)chunk.TexCoords.size() / 2,
+		(unsigned int)chunk.Normals.size() / 3
+	};
+
+	RawCorner first, previous;
+	unsigned int cornerCount = 0;
+	while (true)
+	{
+		while (p < end && IsBlank(*p))
+		{
+			p++;
+		}
+		if (p >= end || !(IsDigit(*p) || *p == '-' || *p == '+'))
+		{
+			break;
+		}
+
+		// v, v/vt, v//vn or v/vt/vn
+		RawCorner corner = { { MissingIndex, MissingIndex, MissingIndex }, 0 };
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			int value;
+			if (ParseIndex(p, end, value))
+			{
+				if (value > 0)
+				{
+					corner.Index[i] = value - 1;
+				}
+				else if (value < 0)
+				{
+					corner.Index[i] = (int)counts[i] + value;
+					corner.Relative |= 1 << i;
+				}
+			}
+			if (i == 2 || p >= end || *p != '/')
+			{
+				break;
+			}
+			p++;
+		}
+		while (p < end && !IsBlank(*p))
+		{
+			p++;
+		}
+
+		if (cornerCount == 0)
+		{
+			first = corner;
+		}
+		else if (cornerCount >= 2)
+		{
+			chunk.Corners.push_back(first);
+			chunk.Corners.push_back(previous);
+			chunk.Corners.push_back(corner);
+		}
+		previous = corner;
+		cornerCount++;
+	}
+}
+
+static void ParseChunk(ObjChunk& chunk)
+{
+	const char* p = chunk.Begin;
+	while (p < chunk.End)
+	{
+		const char* lineEnd = (const char*)std::memchr(p, '\n', chunk.End - p);
+		if (!lineEnd)
+		{
+			lineEnd = chunk.End;
+		}
+
+		while (p < lineEnd && IsBlank(*p))
+		{
+			p++;
+		}
+		if (lineEnd - p >= 2)
+		{
+			if (p[0] == 'v' && IsBlank(p[1]))
+			{
+				p += 2;
+				for (unsigned int i = 0; i < 3; i++)
+				{
+					chunk.Positions.push_back(ParseFloat(p, lineEnd));
+				}
+			}
+			else if (p[0] == 'v' && p[1] == 't' && (lineEnd - p == 2 || IsBlank(p[2])))
+			{
+				p += 2;
+				for (unsigned int i = 0; i < 2; i++)
+				{
+					chunk.TexCoords.push_back(ParseFloat(p, lineEnd));
+				}
+			}
+			else if (p[0] == 'v' && p[1] == 'n' && (lineEnd - p == 2 || IsBlank(p[2])))
+			{
+				p += 2;
+				for (unsigned int i = 0; i < 3; i++)
+				{
+					chunk.Normals.push_back(ParseFloat(p, lineEnd));
+				}
+			}
+			else if (p[0] == 'f' && IsBlank(p[1]))
+			{
+				ParseFace(p + 2, lineEnd, chunk);
+			}
+		}
+		p = lineEnd + 1;
+	}
+}
+
+static inline unsigned int HashCorner(const Corner& corner)
+{
+	unsigned int hash = corner.Index[0] * 0x9E3779B1u ^ corner.Index[1] * 0x85EBCA77u ^ corner.Index[2] * 0xC2B2AE3Du;
+	hash ^= hash >> 15;
+	hash *= 0x2C1B3C6Du;
+	hash ^= hash >> 12;
+	return hash;
+}
+
+/**
+ *	The shard a hash belongs to, from its top bits so the low bits stay spread over each shard's table
+ */
+static inline unsigned int GetShard(unsigned int hash, unsigned int shardCount)
+{
+	return (unsigned int)(((unsigned long long)hash * shardCount) >> 32);
+}
+
+/**
+ *	Runs body over [0, count) on the pool, or on the calling thread without one
+ */
+static void ForEach(ThreadPool* pool, unsigned int count, const std::function<void(unsigned int begin, unsigned int end)>& body)
+{
+	if (pool && count > 1)
+	{
+		pool->ParallelFor(count, body);
+	}
+	else
+	{
+		body(0, count);
+	}
+}
+
+bool ObjLoader::Load(const std::string & path, ObjMesh & mesh, ThreadPool * pool)
+{
+	PROFILE_SCOPE("ObjLoader::Load");
+
+	MappedFile file(path);
+	if (!file.IsOpen())
+	{
+		std::cout << "Could not open OBJ file '" << path << "'" << std::endl;
+		return false;
+	}
+	if (!Parse(file.GetData(), file.GetSize(), mesh, pool))
+	{
+		std::cout << "'" << path << "' refers to vertices it does not have" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool ObjLoader::Parse(const char * text, size_t size, ObjMesh & mesh, ThreadPool * pool)
+{
+	mesh = ObjMesh();
+
+	unsigned int chunkCount = 1;
+	if (pool)
+	{
+		chunkCount = pool->GetThreadCount();
+		if (chunkCount > size / MinChunkSize + 1)
+		{
+			chunkCount = (unsigned int)(size / MinChunkSize + 1);
+		}
+	}
+
+	// Every chunk starts at a line
+	std::vector<ObjChunk> chunks(chunkCount);
+	const char* begin = text;
+	const char* end = text + size;
+	for (unsigned int c = 0; c < chunkCount; c++)
+	{
+		const char* split = text + size / chunkCount * (c + 1);
+		if (c + 1 == chunkCount || split <= begin)
+		{
+			split = c + 1 == chunkCount ? end : begin;
+		}
+		const char* lineEnd = (const char*)std::memchr(split, '\n', end - split);
+		chunks[c].Begin = begin;
+		chunks[c].End = c + 1 == chunkCount || !lineEnd ? end : lineEnd + 1;
+		begin = chunks[c].End;
+	}
+
+	ForEach(pool, chunkCount, [&chunks](unsigned int first, unsigned int last)
+	{
+		for (unsigned int c = first; c < last; c++)
+		{
+			ParseChunk(chunks[c]);
+		}
+	});
+
+	unsigned int totals[3] = { 0, 0, 0 };
+	unsigned int cornerCount = 0;
+	for (ObjChunk& chunk : chunks)
+	{
+		chunk.FirstPosition = totals[0];
+		chunk.FirstTexCoord = totals[1];
+		chunk.FirstNormal = totals[2];
+		chunk.FirstCorner = cornerCount;
+		totals[0] += (unsigned int)chunk.Positions.size() / 3;
+		totals[1] += (unsigned int)chunk.TexCoords.size() / 2;
+		totals[2] += (unsigned int)chunk.Normals.size() / 3;
+		cornerCount += (unsigned int)chunk.Corners.size();
+	}
+
+	// Gather the chunks and turn relative indices into indices into the whole file
+	std::vector<float> positions((size_t)totals[0] * 3);
+	std::vector<float> texCoords((size_t)totals[1] * 2);
+	std::vector<float> normals((size_t)totals[2] * 3);
+	std::vector<Corner> corners(cornerCount);
+	std::vector<unsigned int> hashes(cornerCount);
+	ForEach(pool, chunkCount, [&](unsigned int first, unsigned int last)
+	{
+		for (unsigned int c = first; c < last; c++)
+		{
+			ObjChunk& chunk = chunks[c];
+			std::copy(chunk.Positions.begin(), chunk.Positions.end(), positions.begin() + (size_t)chunk.FirstPosition * 3);
+			std::copy(chunk.TexCoords.begin(), chunk.TexCoords.end(), texCoords.begin() + (size_t)chunk.FirstTexCoord * 2);
+			std::copy(chunk.Normals.begin(), chunk.Normals.end(), normals.begin() + (size_t)chunk.FirstNormal * 3);
+
+			unsigned int bases[3] = { chunk.FirstPosition, chunk.FirstTexCoord, chunk.FirstNormal };
+			for (size_t i = 0; i < chunk.Corners.size(); i++)
+			{
+				const RawCorner& raw = chunk.Corners[i];
+				Corner& corner = corners[chunk.FirstCorner + i];
+				for (unsigned int k = 0; k < 3; k++)
+				{
+					if (raw.Index[k] == MissingIndex)
+					{
+						corner.Index[k] = NoIndex;
+						continue;
+					}
+					long long index = (long long)raw.Index[k] + (raw.Relative & (1 << k) ? bases[k] : 0);
+					if (index < 0 || index >= totals[k])
+					{
+						chunk.Valid = false;
+						index = 0;
+					}
+					corner.Index[k] = (unsigned int)index;
+				}
+				chunk.Valid &= corner.Index[0] != NoIndex;
+				chunk.HasTexCoords |= corner.Index[1] != NoIndex;
+				chunk.HasNormals |= corner.Index[2] != NoIndex;
+				hashes[chunk.FirstCorner + i] = HashCorner(corner);
+			}
+		}
+	});
+
+	for (const ObjChunk& chunk : chunks)
+	{
+		if (!chunk.Valid)
+		{
+			return false;
+		}
+		mesh.HasTexCoords |= chunk.HasTexCoords;
+		mesh.HasNormals |= chunk.HasNormals;
+	}
+
+	// Each shard finds, for the corners whose hash falls into it, the first corner with the same indices.
+	// Corners are visited in file order, so the result does not depend on the number of shards.
+	unsigned int shardCount = chunkCount;
+	std::vector<unsigned int> firstCorners(cornerCount);
+	ForEach(pool, shardCount, [&](unsigned int first, unsigned int last)
+	{
+		for (unsigned int shard = first; shard < last; shard++)
+		{
+			size_t count = 0;
+			for (unsigned int i = 0; i < cornerCount; i++)
+			{
+				count += GetShard(hashes[i], shardCount) == shard;
+			}
+			size_t capacity = 16;
+			while (capacity < count * 2)
+			{
+				capacity *= 2;
+			}
+
+			// Open addressing with linear probing, holding the first corner of each vertex
+			std::vector<unsigned int> table(capacity, NoIndex);
+			unsigned int mask = (unsigned int)capacity - 1;
+			for (unsigned int i = 0; i < cornerCount; i++)
+			{
+				unsigned int hash = hashes[i];
+				if (GetShard(hash, shardCount) != shard)
+				{
+					continue;
+				}
+				for (unsigned int slot = hash & mask; ; slot = (slot + 1) & mask)
+				{
+					unsigned int other = table[slot];
+					if (other == NoIndex)
+					{
+						table[slot] = i;
+						firstCorners[i] = i;
+						break;
+					}
+					if (hashes[other] == hash && std::memcmp(&corners[other], &corners[i], sizeof(Corner)) == 0)
+					{
+						firstCorners[i] = other;
+						break;
+					}
+				}
+			}
+		}
+	});
+
+	// Number the vertices in the order they are first used
+	std::vector<unsigned int> vertexCorners;
+	mesh.Indices.resize(cornerCount);
+	for (unsigned int i = 0; i < cornerCount; i++)
+	{
+		if (firstCorners[i] == i)
+		{
+			mesh.Indices[i] = (unsigned int)vertexCorners.size();
+			vertexCorners.push_back(i);
+		}
+		else
+		{
+			mesh.Indices[i] = mesh.Indices[firstCorners[i]];
+		}
+	}
+	mesh.VertexCount = (unsigned int)vertexCorners.size();
+
+	mesh.Layout.Push<float>(3);
+	if (mesh.HasTexCoords)
+	{
+		mesh.Layout.Push<float>(2);
+	}
+	if (mesh.HasNormals)
+	{
+		mesh.Layout.Push<float>(3);
+	}
+
+	unsigned int stride = mesh.Layout.GetStride() / sizeof(float);
+	mesh.Vertices.resize((size_t)mesh.VertexCount * stride);
+	ForEach(pool, mesh.VertexCount, [&](unsigned int first, unsigned int last)
+	{
+		for (unsigned int v = first; v < last; v++)
+		{
+			const Corner& corner = corners[vertexCorners[v]];
+			float* vertex = &mesh.Vertices[(size_t)v * stride];
+			std::memcpy(vertex, &positions[(size_t)corner.Index[0] * 3], 3 * sizeof(float));
+			vertex += 3;
+			// Corners without a texture coordinate or normal in a mesh that has them get zeros
+			if (mesh.HasTexCoords)
+			{
+				if (corner.Index[1] != NoIndex)
+				{
+					std::memcpy(vertex, &texCoords[(size_t)corner.Index[1] * 2], 2 * sizeof(float));
+				}
+				else
+				{
+					vertex[0] = vertex[1] = 0.0f;
+				}
+				vertex += 2;
+			}
+			if (mesh.HasNormals)
+			{
+				if (corner.Index[2] != NoIndex)
+				{
+					std::memcpy(vertex, &normals[(size_t)corner.Index[2] * 3], 3 * sizeof(float));
+				}
+				else
+				{
+					vertex[0] = vertex[1] = vertex[2] = 0.0f;
+				}
+			}
+		}
+	});
+	return true;
+}
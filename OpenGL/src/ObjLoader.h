@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "VertexBufferLayout.h"
+
+class ThreadPool;
+
+/**
+ *	Interleaved vertices and triangle indices loaded from a file, ready for a VertexBuffer and IndexBuffer
+ */
+struct ObjMesh
+{
+	// Position x, y, z, then texture u, v and normal x, y, z if the file has them
+	std::vector<float> Vertices;
+	std::vector<unsigned int> Indices;
+	VertexBufferLayout Layout;
+	unsigned int VertexCount = 0;
+	bool HasTexCoords = false;
+	bool HasNormals = false;
+};
+
+/**
+ *	Loads Wavefront OBJ geometry: v, vt and vn lines and f lines with 1-based or negative relative indices.
+ *	Polygons are split into triangle fans, and everything else (objects, groups, materials) is ignored,
+ *	giving one mesh for the whole file.
+ *
+ *	With a ThreadPool the file is split into one chunk per worker at line breaks, the chunks are parsed at
+ *	the same time, and the vertices are deduplicated in shards by hash. The result is the same as loading
+ *	without one: vertices are numbered in the order they are first used.
+ */
+class ObjLoader
+{
+public:
+	/**
+	 *	Maps the file and parses it
+	 *	@param pool Workers to parse with, or null to parse on the calling thread. Not from one of its own tasks.
+	 *	@return false if the file could not be read or refers to vertices it does not have
+	 */
+	static bool Load(const std::string& path, ObjMesh& mesh, ThreadPool* pool = nullptr);
+
+	/**
+	 *	Parses OBJ text already in memory
+	 */
+	static bool Parse(const char* text, size_t size, ObjMesh& mesh, ThreadPool* pool = nullptr);
+};
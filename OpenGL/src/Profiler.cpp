@@ -0,0 +1,171 @@
+#include "Profiler.h"
+
+#include "Renderer.h"
+#include <GL/glew.h>
+#include <atomic>
+#include <fstream>
+
+// The trace shows GPU zones on their own row with this tid
+static const unsigned int s_GpuThreadID = 0;
+
+Profiler& Profiler::Get()
+{
+	static Profiler profiler;
+	return profiler;
+}
+
+Profiler::Profiler()
+	: m_Start(std::chrono::steady_clock::now()), m_Frame(0), m_GpuToCpuOffset(0)
+{
+}
+
+void Profiler::BeginFrame()
+{
+	// Line the GPU clock up with the CPU clock, they drift so this is redone every frame
+	int64_t gpuNow = 0;
+	GLCall(glGetInteger64v(GL_TIMESTAMP, &gpuNow));
+	int64_t cpuNow = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start).count();
+	m_GpuToCpuOffset = cpuNow - gpuNow;
+
+	// Read back zones old enough that their results should be ready, keep the rest for later
+	unsigned int kept = 0;
+	for (unsigned int i = 0; i < m_GpuZones.size(); i++)
+	{
+		GpuZone& zone = m_GpuZones[i];
+		bool ready = false;
+		if (zone.Ended && m_Frame - zone.Frame >= GpuLatency)
+		{
+			int available = 0;
+			GLCall(glGetQueryObjectiv(zone.EndQuery, GL_QUERY_RESULT_AVAILABLE, &available));
+			ready = available != 0;
+		}
+
+		if (!ready)
+		{
+			m_GpuZones[kept++] = zone;
+			continue;
+		}
+
+		GLuint64 begin = 0, end = 0;
+		GLCall(glGetQueryObjectui64v(zone.BeginQuery, GL_QUERY_RESULT, &begin));
+		GLCall(glGetQueryObjectui64v(zone.EndQuery, GL_QUERY_RESULT, &end));
+
+		Event event;
+		event.Name = zone.Name;
+		event.Start = ((int64_t)begin + m_GpuToCpuOffset) / 1000;
+		event.Duration = (int64_t)(end - begin) / 1000;
+		event.ThreadID = s_GpuThreadID;
+		AddEvent(event);
+
+		m_FreeQueries.push_back(zone.BeginQuery);
+		m_FreeQueries.push_back(zone.EndQuery);
+	}
+	m_GpuZones.resize(kept);
+}
+
+void Profiler::EndFrame()
+{
+	m_Frame++;
+}
+
+void Profiler::AddCpuZone(const char * name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+	Event event;
+	event.Name = name;
+	event.Start = std::chrono::duration_cast<std::chrono::microseconds>(start - m_Start).count();
+	event.Duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+	event.ThreadID = GetThreadID();
+	AddEvent(event);
+}
+
+unsigned int Profiler::BeginGpuZone(const char * name)
+{
+	GpuZone zone;
+	zone.Name = name;
+	zone.BeginQuery = AcquireQuery();
+	zone.EndQuery = AcquireQuery();
+	zone.Frame = m_Frame;
+	zone.Ended = false;
+	// Timestamps rather than GL_TIME_ELAPSED, as elapsed time queries cannot be nested
+	GLCall(glQueryCounter(zone.BeginQuery, GL_TIMESTAMP));
+
+	m_GpuZones.push_back(zone);
+	return (unsigned int)m_GpuZones.size() - 1;
+}
+
+void Profiler::EndGpuZone(unsigned int zone)
+{
+	GLCall(glQueryCounter(m_GpuZones[zone].EndQuery, GL_TIMESTAMP));
+	m_GpuZones[zone].Ended = true;
+}
+
+bool Profiler::WriteChromeTrace(const std::string & path) const
+{
+	std::ofstream stream(path);
+	if (!stream)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_EventMutex);
+
+	stream << "{\"traceEvents\":[\n";
+	for (unsigned int i = 0; i < m_Events.size(); i++)
+	{
+		const Event& event = m_Events[i];
+
+		std::string name;
+		for (const char* c = event.Name; *c; c++)
+		{
+			if (*c == '"' || *c == '\\')
+			{
+				name += '\\';
+			}
+			name += *c;
+		}
+
+		stream << "{\"name\":\"" << name << "\",\"cat\":\"" << (event.ThreadID == s_GpuThreadID ? "gpu" : "cpu")
+			<< "\",\"ph\":\"X\",\"ts\":" << event.Start << ",\"dur\":" << event.Duration
+			<< ",\"pid\":0,\"tid\":" << event.ThreadID << "}" << (i + 1 < m_Events.size() ? ",\n" : "\n");
+	}
+	stream << "],\n\"displayTimeUnit\":\"ms\"}\n";
+
+	return stream.good();
+}
+
+void Profiler::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_EventMutex);
+	m_Events.clear();
+}
+
+unsigned int Profiler::AcquireQuery()
+{
+	if (m_FreeQueries.empty())
+	{
+		// Generate in batches rather than one query per zone
+		unsigned int queries[64];
+		GLCall(glGenQueries(64, queries));
+		m_FreeQueries.assign(queries, queries + 64);
+	}
+	unsigned int query = m_FreeQueries.back();
+	m_FreeQueries.pop_back();
+	return query;
+}
+
+void Profiler::AddEvent(const Event & event)
+{
+	std::lock_guard<std::mutex> lock(m_EventMutex);
+	if (m_Events.size() < MaxEvents)
+	{
+		m_Events.push_back(event);
+	}
+}
+
+unsigned int Profiler::GetThreadID()
+{
+	// 0 is taken by the GPU row
+	static std::atomic<unsigned int> s_NextID(1);
+	thread_local unsigned int id = s_NextID++;
+	return id;
+}
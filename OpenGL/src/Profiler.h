@@ -0,0 +1,161 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ *	Records named CPU and GPU time zones and writes them out as a Chrome trace (chrome://tracing).
+ *
+ *	CPU zones can be recorded on any thread. GPU zones use GL_TIMESTAMP queries, so they must be
+ *	recorded on the thread owning the context; their results are read back a few frames later so
+ *	the CPU never waits for the GPU. Zone names are not copied and must be string literals.
+ *
+ *	Use the PROFILE_SCOPE / PROFILE_GPU_SCOPE macros, which are only compiled in when GL_PROFILE is defined.
+ */
+class Profiler
+{
+public:
+	/**
+	 *	Number of frames between issuing a GPU query and reading it back
+	 */
+	static const unsigned int GpuLatency = 3;
+
+	/**
+	 *	Recording stops once this many zones are held, to bound memory in long sessions
+	 */
+	static const unsigned int MaxEvents = 1 << 20;
+
+	static Profiler& Get();
+
+	/**
+	 *	Collects the GPU zones that have finished, call at the start of every frame
+	 */
+	void BeginFrame();
+
+	/**
+	 *	Marks the end of the frame, call after swapping buffers
+	 */
+	void EndFrame();
+
+	/**
+	 *	Records a finished CPU zone
+	 */
+	void AddCpuZone(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+	/**
+	 *	Starts a GPU zone, it must be ended before the next BeginFrame
+	 *	@return a handle to pass to EndGpuZone
+	 */
+	unsigned int BeginGpuZone(const char* name);
+
+	void EndGpuZone(unsigned int zone);
+
+	/**
+	 *	Writes every recorded zone as Chrome trace event JSON
+	 *	@return false if the file could not be written
+	 */
+	bool WriteChromeTrace(const std::string& path) const;
+
+	/**
+	 *	Removes every recorded zone
+	 */
+	void Clear();
+
+private:
+	/**
+	 *	A finished zone, times are in microseconds since the profiler was created
+	 */
+	struct Event
+	{
+		const char* Name;
+		int64_t Start;
+		int64_t Duration;
+		unsigned int ThreadID;
+	};
+
+	/**
+	 *	A GPU zone waiting for its queries
+	 */
+	struct GpuZone
+	{
+		const char* Name;
+		unsigned int BeginQuery;
+		unsigned int EndQuery;
+		unsigned int Frame;
+		bool Ended;
+	};
+
+	Profiler();
+
+	std::chrono::steady_clock::time_point m_Start;
+
+	std::vector<Event> m_Events;
+	mutable std::mutex m_EventMutex;
+
+	std::vector<GpuZone> m_GpuZones;
+	std::vector<unsigned int> m_FreeQueries;
+	unsigned int m_Frame;
+
+	// Added to a GPU timestamp to put it on the CPU timeline, in nanoseconds
+	int64_t m_GpuToCpuOffset;
+
+	/**
+	 *	@return a query name from the pool, generating a batch of them when it is empty
+	 */
+	unsigned int AcquireQuery();
+
+	void AddEvent(const Event& event);
+
+	/**
+	 *	@return a small id for the calling thread, used as the trace's tid
+	 */
+	static unsigned int GetThreadID();
+};
+
+/**
+ *	Records a CPU zone from construction to destruction
+ */
+class ProfileScope
+{
+public:
+	ProfileScope(const char* name)
+		: m_Name(name), m_Start(std::chrono::steady_clock::now()) {}
+
+	~ProfileScope()
+	{
+		Profiler::Get().AddCpuZone(m_Name, m_Start, std::chrono::steady_clock::now());
+	}
+
+private:
+	const char* m_Name;
+	std::chrono::steady_clock::time_point m_Start;
+};
+
+/**
+ *	Records a GPU zone from construction to destruction
+ */
+class GpuProfileScope
+{
+public:
+	GpuProfileScope(const char* name)
+		: m_Zone(Profiler::Get().BeginGpuZone(name)) {}
+
+	~GpuProfileScope()
+	{
+		Profiler::Get().EndGpuZone(m_Zone);
+	}
+
+private:
+	unsigned int m_Zone;
+};
+
+#ifdef GL_PROFILE
+	#define PROFILE_SCOPE(name) ProfileScope profileScope(name)
+	#define PROFILE_GPU_SCOPE(name) GpuProfileScope gpuProfileScope(name)
+#else
+	#define PROFILE_SCOPE(name)
+	#define PROFILE_GPU_SCOPE(name)
+#endif
@@ -0,0 +1,141 @@
+#include "RenderQueue.h"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "Texture.h"
+#include <GL/glew.h>
+
+void RenderQueue::Submit(const VertexArray & va, const IndexBuffer & ib, const Shader & shader, const Texture * texture, unsigned int layer, float depth)
+{
+	RenderCommand command;
+	command.Key = MakeKey(layer, shader.GetRendererID(), texture ? texture->GetRendererID() : 0, va.GetRendererID(), depth);
+	command.VA = &va;
+	command.IB = &ib;
+	command.Program = &shader;
+	command.Texture0 = texture;
+	m_Commands.push_back(command);
+}
+
+void RenderQueue::Flush()
+{
+	m_Stats = Stats();
+
+	const unsigned int count = (unsigned int)m_Commands.size();
+	m_Keys.resize(count);
+	m_Indices.resize(count);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		m_Keys[i] = m_Commands[i].Key;
+		m_Indices[i] = i;
+	}
+
+	RadixSort();
+
+	// Only rebind what differs from the previous command
+	const Shader* currentShader = nullptr;
+	const VertexArray* currentVA = nullptr;
+	const IndexBuffer* currentIB = nullptr;
+	const Texture* currentTexture = nullptr;
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const RenderCommand& command = m_Commands[m_Indices[i]];
+
+		if (command.Program != currentShader)
+		{
+			command.Program->Bind();
+			currentShader = command.Program;
+			m_Stats.StateChanges++;
+		}
+		if (command.Texture0 && command.Texture0 != currentTexture)
+		{
+			command.Texture0->Bind(0);
+			currentTexture = command.Texture0;
+			m_Stats.StateChanges++;
+		}
+		if (command.VA != currentVA)
+		{
+			command.VA->Bind();
+			currentVA = command.VA;
+			// The element buffer binding belongs to the vertex array, so it has to be bound again
+			currentIB = nullptr;
+			m_Stats.StateChanges++;
+		}
+		if (command.IB != currentIB)
+		{
+			command.IB->Bind();
+			currentIB = command.IB;
+			m_Stats.StateChanges++;
+		}
+
+		GLCall(glDrawElements(GL_TRIANGLES, command.IB->GetCount(), command.IB->GetType(), (const void*)(size_t)command.IB->GetOffset()));
+		m_Stats.DrawCount++;
+
+		// Renderer::Draw binds the shader, vertex array and index buffer for every draw
+		m_Stats.StateChangesSaved += command.Texture0 ? 4 : 3;
+	}
+	m_Stats.StateChangesSaved -= m_Stats.StateChanges;
+
+	m_Commands.clear();
+}
+
+uint64_t RenderQueue::MakeKey(unsigned int layer, unsigned int shaderID, unsigned int textureID, unsigned int vertexArrayID, float depth)
+{
+	if (depth < 0.0f) depth = 0.0f;
+	if (depth > 1.0f) depth = 1.0f;
+	const uint64_t quantisedDepth = (uint64_t)(depth * 0xFFFFF);
+
+	return ((uint64_t)(layer & 0xF) << 60)
+		| ((uint64_t)(shaderID & 0xFFF) << 48)
+		| ((uint64_t)(textureID & 0xFFFF) << 32)
+		| ((uint64_t)(vertexArrayID & 0xFFF) << 20)
+		| quantisedDepth;
+}
+
+void RenderQueue::RadixSort()
+{
+	const unsigned int count = (unsigned int)m_Keys.size();
+	if (count < 2)
+	{
+		return;
+	}
+
+	m_KeysScratch.resize(count);
+	m_IndicesScratch.resize(count);
+
+	for (unsigned int shift = 0; shift < 64; shift += 8)
+	{
+		unsigned int histogram[256] = {};
+		for (unsigned int i = 0; i < count; i++)
+		{
+			histogram[(m_Keys[i] >> shift) & 0xFF]++;
+		}
+
+		// If every key has the same byte here this pass would not move anything
+		if (histogram[(m_Keys[0] >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		// Turn the counts into the position each bucket starts at
+		unsigned int offset = 0;
+		for (unsigned int bucket = 0; bucket < 256; bucket++)
+		{
+			unsigned int bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			unsigned int destination = histogram[(m_Keys[i] >> shift) & 0xFF]++;
+			m_KeysScratch[destination] = m_Keys[i];
+			m_IndicesScratch[destination] = m_Indices[i];
+		}
+
+		m_Keys.swap(m_KeysScratch);
+		m_Indices.swap(m_IndicesScratch);
+	}
+}
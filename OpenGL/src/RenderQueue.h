@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class VertexArray;
+class IndexBuffer;
+class Shader;
+class Texture;
+
+/**
+ *	A draw recorded by the RenderQueue, executed when the queue is flushed
+ */
+struct RenderCommand
+{
+	uint64_t Key;
+	const VertexArray* VA;
+	const IndexBuffer* IB;
+	const Shader* Program;
+	const Texture* Texture0; // bound to slot 0, may be null
+};
+
+/**
+ *	Defers draws until the end of the frame and sorts them by a 64 bit key so that draws sharing
+ *	a shader, texture and vertex array run next to each other and rebinding is kept to a minimum.
+ *
+ *	Key layout, most significant bits first:
+ *	layer (4) | shader (12) | texture (16) | vertex array (12) | depth (20)
+ */
+class RenderQueue
+{
+public:
+	/**
+	 *	Counters for the most recent Flush
+	 */
+	struct Stats
+	{
+		unsigned int DrawCount = 0;
+		// Binds actually issued
+		unsigned int StateChanges = 0;
+		// Binds that drawing every command with Renderer::Draw would have issued on top of StateChanges
+		unsigned int StateChangesSaved = 0;
+	};
+
+	/**
+	 *	Records a draw
+	 *	@param va The VertexArray to draw
+	 *	@param ib The IndexBuffer to draw
+	 *	@param shader The shader to draw with, its uniforms must already be set
+	 *	@param texture Texture bound to slot 0, or null
+	 *	@param layer Coarse ordering, lower layers are always drawn first (0 - 15)
+	 *	@param depth Ordering within the same state, 0 is drawn first and 1 last
+	 */
+	void Submit(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const Texture* texture = nullptr, unsigned int layer = 0, float depth = 0.0f);
+
+	/**
+	 *	Sorts and draws every recorded command, then empties the queue
+	 */
+	void Flush();
+
+	inline const Stats& GetStats() const
+	{
+		return m_Stats;
+	}
+
+	/**
+	 *	Packs the sort criteria into a key, ids are truncated to the width of their field
+	 */
+	static uint64_t MakeKey(unsigned int layer, unsigned int shaderID, unsigned int textureID, unsigned int vertexArrayID, float depth);
+
+private:
+	std::vector<RenderCommand> m_Commands;
+
+	// (key, command index) pairs, sorted instead of the larger commands themselves
+	std::vector<uint64_t> m_Keys;
+	std::vector<uint32_t> m_Indices;
+	std::vector<uint64_t> m_KeysScratch;
+	std::vector<uint32_t> m_IndicesScratch;
+
+	Stats m_Stats;
+
+	/**
+	 *	Least significant digit radix sort of m_Keys/m_Indices, one pass per byte of the key.
+	 *	Passes where every key has the same byte are skipped.
+	 */
+	void RadixSort();
+};
@@ -4,7 +4,12 @@
 
 #include "VertexArray.h"
 #include "IndexBuffer.h"
-#include "Shader.h";
+#include "Shader.h"
+#include "IndirectBuffer.h"
+#include "CommandList.h"
+#include "Texture.h"
+#include "Profiler.h"
+#include "MeshSimplifier.h"
 
 void GLClearError()
 {
@@ -22,18 +27,254 @@ bool GLLogCall(const char * function, const char * file, int line)
 	return true;
 }
 
+/**
+ *	The most recent call made through GLCall, reported alongside debug messages
+ */
+struct GLCallSite
+{
+	const char* Function = "unknown";
+	const char* File = "unknown";
+	int Line = 0;
+};
+
+static GLCallSite s_LastCall;
+static bool s_DebugCallbackActive = false;
+
+#if GL_ERROR_CHECK == GL_ERROR_CHECK_CALLBACK
+static void GLAPIENTRY GLDebugMessageCallback(GLenum /*source*/, GLenum type, GLuint id, GLenum severity, GLsizei /*length*/,
+	const GLchar* message, const void* /*userParam*/)
+{
+	// Messages are delivered asynchronously, so the call site is the last GLCall made
+	// before the message arrived rather than necessarily the call that caused it
+	std::cout << "[OpenGL_" << (type == GL_DEBUG_TYPE_ERROR ? "Error" : "Debug") << "] (" << id << ")" << message
+		<< " near " << s_LastCall.Function << " " << s_LastCall.File << ":" << s_LastCall.Line << std::endl;
+
+	if (type == GL_DEBUG_TYPE_ERROR && severity == GL_DEBUG_SEVERITY_HIGH)
+	{
+		ASSERT(false);
+	}
+}
+#endif
+
+void GLInitErrorChecking()
+{
+#if GL_ERROR_CHECK == GL_ERROR_CHECK_CALLBACK
+	if (GLEW_VERSION_4_3 || GLEW_KHR_debug)
+	{
+		GLCall(glEnable(GL_DEBUG_OUTPUT));
+		GLCall(glDebugMessageCallback(GLDebugMessageCallback, nullptr));
+		// Notifications are informational only (e.g. where a buffer lives), skip them
+		GLCall(glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE));
+		s_DebugCallbackActive = true;
+	}
+	else if (GLEW_ARB_debug_output)
+	{
+		GLCall(glDebugMessageCallbackARB(GLDebugMessageCallback, nullptr));
+		s_DebugCallbackActive = true;
+	}
+	else
+	{
+		std::cout << "Debug output is not available, checking every GL call instead" << std::endl;
+	}
+#elif GL_ERROR_CHECK == GL_ERROR_CHECK_FRAME
+	// Errors raised before now would be blamed on the first frame
+	GLClearError();
+#endif
+}
+
+void GLCheckFrameErrors()
+{
+#if GL_ERROR_CHECK == GL_ERROR_CHECK_FRAME
+	while (GLenum error = glGetError())
+	{
+		std::cout << "[OpenGL_Error] (" << error << ") raised during the last frame" << std::endl;
+	}
+#endif
+}
+
+void GLBeginCall(const char * function, const char * file, int line)
+{
+	s_LastCall.Function = function;
+	s_LastCall.File = file;
+	s_LastCall.Line = line;
+
+	if (!s_DebugCallbackActive)
+	{
+		GLClearError();
+	}
+}
+
+bool GLEndCall()
+{
+	if (s_DebugCallbackActive)
+	{
+		return true;
+	}
+	return GLLogCall(s_LastCall.Function, s_LastCall.File, s_LastCall.Line);
+}
+
+Renderer::Renderer()
+{
+}
+
+Renderer::~Renderer()
+{
+}
+
 void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader)
 {
+	PROFILE_SCOPE("Renderer::Draw");
+	PROFILE_GPU_SCOPE("Renderer::Draw");
+
 	// Bind Shader, VertexArray and Index Buffer
 	shader.Bind();
 	va.Bind();
 	ib.Bind();
 
-	GLCall(glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr));
+	GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), ib.GetType(), (const void*)(size_t)ib.GetOffset()));
+
+}
+
+void Renderer::Draw(const VertexArray& va, const VertexBuffer& vb, const IndexBuffer& ib, const Shader& shader)
+{
+	shader.Bind();
+	va.Bind();
+	ib.Bind();
+
+	GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, ib.GetCount(), ib.GetType(), (void*)(size_t)ib.GetOffset(), vb.GetBaseVertex()));
+}
+
+void Renderer::DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount)
+{
+	shader.Bind();
+	va.Bind();
+	ib.Bind();
+
+	GLCall(glDrawElementsInstanced(GL_TRIANGLES, ib.GetCount(), ib.GetType(), (const void*)(size_t)ib.GetOffset(), instanceCount));
+}
+
+void Renderer::DrawIndirect(const VertexArray& va, const IndexBuffer& ib, const IndirectBuffer& commands, const Shader& shader)
+{
+	shader.Bind();
+	va.Bind();
+	ib.Bind();
+
+	if (IndirectBuffer::IsSupported())
+	{
+		// The whole list is read by the GPU, so the CPU cost no longer depends on the number of draws
+		commands.Bind();
+		GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, ib.GetType(), nullptr, commands.GetCount(), 0));
+		return;
+	}
 
+	for (const DrawElementsIndirectCommand& command : commands.GetCommands())
+	{
+		const void* firstIndex = (const void*)(size_t)(command.FirstIndex * ib.GetIndexSize());
+		GLCall(glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.Count, ib.GetType(), firstIndex, command.InstanceCount, command.BaseVertex));
+	}
+}
+
+void Renderer::DrawLod(const VertexArray& va, const IndexBuffer& ib, const MeshLod& lod, const Shader& shader)
+{
+	shader.Bind();
+	va.Bind();
+	ib.Bind();
+
+	size_t offset = ib.GetOffset() + (size_t)lod.FirstIndex * ib.GetIndexSize();
+	GLCall(glDrawElements(GL_TRIANGLES, lod.IndexCount, ib.GetType(), (const void*)offset));
+}
+
+unsigned int Renderer::SelectLod(const std::vector<MeshLod>& lods, float meshSize, float distance, float projectionScale, float maxPixels)
+{
+	// At or behind the camera, keep the full mesh
+	if (distance <= 0.0f)
+	{
+		return 0;
+	}
+
+	unsigned int selected = 0;
+	for (unsigned int i = 1; i < lods.size(); i++)
+	{
+		float pixels = lods[i].Error * meshSize / distance * projectionScale;
+		if (pixels > maxPixels)
+		{
+			break;
+		}
+		selected = i;
+	}
+	return selected;
+}
+
+void Renderer::DrawRanges(const VertexArray& va, const IndexBuffer& ib, const std::vector<DrawRange>& ranges, const Shader& shader)
+{
+	m_RangeScratch.resize(ranges.size());
+	for (unsigned int i = 0; i < ranges.size(); i++)
+	{
+		DrawElementsIndirectCommand& command = m_RangeScratch[i];
+		command.Count = ranges[i].IndexCount;
+		command.InstanceCount = ranges[i].InstanceCount;
+		// The commands index the whole GL buffer, a view's indices start further in
+		command.FirstIndex = ib.GetFirstIndex() + ranges[i].FirstIndex;
+		command.BaseVertex = ranges[i].BaseVertex;
+		command.BaseInstance = 0;
+	}
+
+	if (!m_RangeCommands)
+	{
+		m_RangeCommands = std::make_unique<IndirectBuffer>(m_RangeScratch.data(), (unsigned int)m_RangeScratch.size());
+	}
+	else
+	{
+		m_RangeCommands->SetData(m_RangeScratch.data(), (unsigned int)m_RangeScratch.size());
+	}
+
+	DrawIndirect(va, ib, *m_RangeCommands, shader);
+}
+
+void Renderer::Submit(const CommandList& commands)
+{
+	Shader* shader = nullptr;
+
+	for (const CommandList::Command& command : commands.m_Commands)
+	{
+		switch (command.Type)
+		{
+		case CommandList::CommandType::BindShader:
+			shader = (Shader*)command.Object;
+			shader->Bind();
+			break;
+
+		case CommandList::CommandType::BindTexture:
+			((const Texture*)command.Object)->Bind(command.Value);
+			break;
+
+		case CommandList::CommandType::SetUniform1i:
+			ASSERT(shader);
+			shader->SetUniform1i(&commands.m_Names[command.Name], command.IntValue);
+			break;
+
+		case CommandList::CommandType::SetUniform4f:
+			ASSERT(shader);
+			shader->SetUniform4f(&commands.m_Names[command.Name], command.Values[0], command.Values[1], command.Values[2], command.Values[3]);
+			break;
+
+		case CommandList::CommandType::Draw:
+			ASSERT(shader);
+			Draw(*(const VertexArray*)command.Object, *command.IB, *shader);
+			break;
+
+		case CommandList::CommandType::DrawInstanced:
+			ASSERT(shader);
+			DrawInstanced(*(const VertexArray*)command.Object, *command.IB, *shader, command.Value);
+			break;
+		}
+	}
 }
 
 void Renderer::Clear() const
 {
+	PROFILE_SCOPE("Renderer::Clear");
+	PROFILE_GPU_SCOPE("Renderer::Clear");
+
 	GLCall(glClear(GL_COLOR_BUFFER_BIT));
 }
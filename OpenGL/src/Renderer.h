@@ -1,11 +1,67 @@
 #pragma once
+#include <memory>
+#include <vector>
+#include "IndirectBuffer.h"
 
-#define ASSERT(x) if (!(x)) __debugbreak();
-#define GLCall(x) GLClearError(); x; ASSERT(GLLogCall(#x, __FILE__, __LINE__))
+// Stops in the debugger where the check failed
+#if defined(_MSC_VER)
+	#define DEBUG_BREAK() __debugbreak()
+#else
+	#define DEBUG_BREAK() __builtin_trap()
+#endif
+
+#define ASSERT(x) if (!(x)) DEBUG_BREAK();
+
+/**
+ *	How GLCall checks for OpenGL errors, GL_ERROR_CHECK can be defined by the build to pick one.
+ *	NONE     - GLCall is just the call, used for release builds
+ *	FRAME    - errors are only collected once per frame by GLCheckFrameErrors, used for profiling builds (GL_PROFILE)
+ *	CALLBACK - the driver reports errors to a debug message callback (KHR_debug / ARB_debug_output) and GLCall only
+ *	           remembers its file and line for the report, used for debug builds. Falls back to CALL without the extension.
+ *	CALL     - glGetError before and after every call. Exact, but stalls the driver.
+ */
+#define GL_ERROR_CHECK_NONE 0
+#define GL_ERROR_CHECK_FRAME 1
+#define GL_ERROR_CHECK_CALLBACK 2
+#define GL_ERROR_CHECK_CALL 3
+
+#ifndef GL_ERROR_CHECK
+	#if defined(GL_PROFILE)
+		#define GL_ERROR_CHECK GL_ERROR_CHECK_FRAME
+	#elif defined(_DEBUG)
+		#define GL_ERROR_CHECK GL_ERROR_CHECK_CALLBACK
+	#else
+		#define GL_ERROR_CHECK GL_ERROR_CHECK_NONE
+	#endif
+#endif
+
+#if GL_ERROR_CHECK == GL_ERROR_CHECK_CALL
+	#define GLCall(x) GLClearError(); x; ASSERT(GLLogCall(#x, __FILE__, __LINE__))
+#elif GL_ERROR_CHECK == GL_ERROR_CHECK_CALLBACK
+	#define GLCall(x) GLBeginCall(#x, __FILE__, __LINE__); x; ASSERT(GLEndCall())
+#else
+	#define GLCall(x) x
+#endif
 
 class Shader;
 class VertexArray;
 class IndexBuffer;
+class VertexBuffer;
+class CommandList;
+struct MeshLod;
+
+/**
+ *	A range of an index buffer drawn as part of a multi draw
+ */
+struct DrawRange
+{
+	unsigned int IndexCount;
+	unsigned int FirstIndex;
+	// Added to every index, so meshes packed into one vertex buffer can keep their own indices
+	int BaseVertex;
+	unsigned int InstanceCount = 1;
+};
+
 /**
  *	Clears all errors
  */
@@ -16,10 +72,37 @@ void GLClearError();
  */
 bool GLLogCall(const char* function, const char* file, int line);
 
+/**
+ *	Sets up the error checking picked by GL_ERROR_CHECK, call once after glewInit.
+ *	In CALLBACK mode the context should be created with GLFW_OPENGL_DEBUG_CONTEXT.
+ */
+void GLInitErrorChecking();
+
+/**
+ *	Reports every error raised since the last check, call once per frame.
+ *	Only does anything in FRAME mode.
+ */
+void GLCheckFrameErrors();
+
+/**
+ *	Remembers the call about to be made, so the debug callback can say where an error came from.
+ *	Clears old errors instead when the debug callback is not available.
+ */
+void GLBeginCall(const char* function, const char* file, int line);
+
+/**
+ *	@return false if the call since GLBeginCall raised an error, only checked when the debug callback is not available
+ */
+bool GLEndCall();
+
 class Renderer
 {
 
 public:
+	Renderer();
+
+	~Renderer();
+
 	/**
 	 * Drawn the specified Vertex Array, Index Buffer and Shader
 	 * @param va The VertexArray to draw
@@ -28,8 +111,75 @@ public:
 	 */
 	void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader);
 
+	/**
+	 * Draws a mesh whose buffers may be views into BufferArenas.
+	 * The index offset and base vertex come from the buffers, so meshes sharing arenas and a VertexArray
+	 * are drawn one after another without any binds in between.
+	 * @param va The VertexArray, its attributes set up from vb or another view of the same arena
+	 * @param vb The vertices of the mesh
+	 * @param ib The indices of the mesh
+	 * @param shader The shader object
+	 */
+	void Draw(const VertexArray& va, const VertexBuffer& vb, const IndexBuffer& ib, const Shader& shader);
+
+	/**
+	 * Draws many instances of the same mesh in one call.
+	 * Per-instance data comes from buffers added to the VertexArray with a non zero divisor.
+	 * @param va The VertexArray to draw
+	 * @param ib The IndexBuffer containing shape and material information
+	 * @param shader The shader object
+	 * @param instanceCount The number of instances to draw
+	 */
+	void DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount);
+
+	/**
+	 * Draws every command of an IndirectBuffer in one glMultiDrawElementsIndirect.
+	 * On contexts without it (e.g. 3.3) each command is drawn with glDrawElementsInstancedBaseVertex,
+	 * where BaseInstance is ignored.
+	 * The commands are read by the GPU as they are, so their FirstIndex counts from the start of the GL buffer
+	 * and commands for a view into a BufferArena must add ib.GetFirstIndex() themselves.
+	 * @param va The VertexArray shared by all the draws
+	 * @param ib The IndexBuffer shared by all the draws
+	 * @param commands The draws
+	 * @param shader The shader object
+	 */
+	void DrawIndirect(const VertexArray& va, const IndexBuffer& ib, const IndirectBuffer& commands, const Shader& shader);
+
+	/**
+	 * Draws one level of detail of a mesh whose levels are stored one after another in ib, as built by MeshSimplifier::BuildLods
+	 * @param lod The level to draw, usually picked by SelectLod
+	 */
+	void DrawLod(const VertexArray& va, const IndexBuffer& ib, const MeshLod& lod, const Shader& shader);
+
+	/**
+	 * Picks the coarsest level of detail whose error covers at most maxPixels on screen
+	 * @param lods The levels, finest first
+	 * @param meshSize The size of the mesh in world units, the largest side of its bounds times its scale
+	 * @param distance The distance from the camera to the mesh
+	 * @param projectionScale Pixels covered by one world unit at distance 1, viewport height / (2 * tan(fovY / 2))
+	 * @return the index of the level in lods
+	 */
+	static unsigned int SelectLod(const std::vector<MeshLod>& lods, float meshSize, float distance, float projectionScale, float maxPixels = 1.0f);
+
+	/**
+	 * Draws a list of ranges of a shared VertexArray and IndexBuffer with as few calls as the context allows.
+	 * The ranges are uploaded to an IndirectBuffer owned by the renderer.
+	 * Their FirstIndex counts from ib's first index, also when ib is a view into a BufferArena.
+	 */
+	void DrawRanges(const VertexArray& va, const IndexBuffer& ib, const std::vector<DrawRange>& ranges, const Shader& shader);
+
+	/**
+	 * Replays a CommandList recorded on any thread. Must be called on the thread owning the context.
+	 */
+	void Submit(const CommandList& commands);
+
 	/**
 	 * Clears the view.
 	 */
 	void Clear() const;
+
+private:
+	// Reused by DrawRanges so the buffer is only reallocated when the list grows
+	std::unique_ptr<IndirectBuffer> m_RangeCommands;
+	std::vector<DrawElementsIndirectCommand> m_RangeScratch;
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Shader.h"
 #include "Renderer.h"
+#include "GLState.h"
+#include "Profiler.h"
 #include <GL/glew.h>
 #include <iostream>
 #include <fstream>
@@ -7,8 +9,10 @@
 #include <sstream>
 
 Shader::Shader(const std::string & filepath)
-	: m_Filepath(filepath), m_RendererID(0)
+	: m_RendererID(0), m_Filepath(filepath)
 {
+	PROFILE_SCOPE("Shader::Shader");
+
 	ShaderProgramSource source = ParseShader(filepath);
 	m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
 	
@@ -16,17 +20,40 @@ Shader::Shader(const std::string & filepath)
 
 Shader::~Shader()
 {
-	GLCall(glDeleteProgram(m_RendererID));
+	if (m_RendererID)
+	{
+		GLState::OnDeleteProgram(m_RendererID);
+		GLCall(glDeleteProgram(m_RendererID));
+	}
+}
+
+Shader::Shader(Shader && other) noexcept
+	: m_RendererID(other.m_RendererID), m_Filepath(std::move(other.m_Filepath)),
+	m_UniformLocationCache(std::move(other.m_UniformLocationCache))
+{
+	other.m_RendererID = 0;
+}
+
+Shader & Shader::operator=(Shader && other) noexcept
+{
+	if (this != &other)
+	{
+		// The old program is deleted by other's destructor
+		std::swap(m_RendererID, other.m_RendererID);
+		std::swap(m_Filepath, other.m_Filepath);
+		std::swap(m_UniformLocationCache, other.m_UniformLocationCache);
+	}
+	return *this;
 }
 
 void Shader::Bind() const
 {
-	GLCall(glUseProgram(m_RendererID));
+	GLState::UseProgram(m_RendererID);
 }
 
 void Shader::UnBind() const
 {
-	GLCall(glUseProgram(0));
+	GLState::UseProgram(0);
 }
 
 void Shader::SetUniform4f(const std::string & name, float v0, float v1, float v2, float v3)
@@ -39,6 +66,11 @@ void Shader::SetUniform1i(const std::string & name, int slot)
 	GLCall(glUniform1i(GetUniformLocation(name), slot));
 }
 
+void Shader::SetUniform1iv(const std::string & name, int count, const int * slots)
+{
+	GLCall(glUniform1iv(GetUniformLocation(name), count, slots));
+}
+
 int Shader::GetUniformLocation(const std::string& name)
 {
 	if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
@@ -20,6 +20,15 @@ public:
 
 	~Shader();
 
+	Shader(const Shader&) = delete;
+	Shader& operator=(const Shader&) = delete;
+
+	/**
+	 * Moves the program to a new owner, leaving other empty
+	 */
+	Shader(Shader&& other) noexcept;
+	Shader& operator=(Shader&& other) noexcept;
+
 	/**
 	 * Binds this shader for use with the renderer
 	 */
@@ -40,6 +49,16 @@ public:
 	 */
 	void SetUniform1i(const std::string& name, int slot);
 
+	/**
+	 *	Sets an array of Texture slots for this shader, used for sampler arrays
+	 */
+	void SetUniform1iv(const std::string& name, int count, const int* slots);
+
+	inline unsigned int GetRendererID() const
+	{
+		return m_RendererID;
+	}
+
 private:
 	unsigned int m_RendererID;
 
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "VertexBufferLayout.h"
+
+/**
+ *	The GL type of a vertex component, and whether it is read normalised, matching VertexBufferLayout::Push
+ */
+template<typename T>
+struct VertexComponent
+{
+	static_assert(sizeof(T) == 0, "Type can not be used in a vertex");
+};
+
+template<>
+struct VertexComponent<float>
+{
+	static constexpr unsigned int Type = GL_FLOAT;
+	static constexpr unsigned char Normalized = GL_FALSE;
+	static constexpr unsigned int Components = 1;
+};
+
+template<>
+struct VertexComponent<unsigned int>
+{
+	static constexpr unsigned int Type = GL_UNSIGNED_INT;
+	static constexpr unsigned char Normalized = GL_FALSE;
+	static constexpr unsigned int Components = 1;
+};
+
+template<>
+struct VertexComponent<unsigned char>
+{
+	static constexpr unsigned int Type = GL_UNSIGNED_BYTE;
+	static constexpr unsigned char Normalized = GL_TRUE;
+	static constexpr unsigned int Components = 1;
+};
+
+template<>
+struct VertexComponent<short>
+{
+	static constexpr unsigned int Type = GL_SHORT;
+	static constexpr unsigned char Normalized = GL_TRUE;
+	static constexpr unsigned int Components = 1;
+};
+
+template<>
+struct VertexComponent<unsigned short>
+{
+	static constexpr unsigned int Type = GL_UNSIGNED_SHORT;
+	static constexpr unsigned char Normalized = GL_TRUE;
+	static constexpr unsigned int Components = 1;
+};
+
+template<>
+struct VertexComponent<Half>
+{
+	static constexpr unsigned int Type = GL_HALF_FLOAT;
+	static constexpr unsigned char Normalized = GL_FALSE;
+	static constexpr unsigned int Components = 1;
+};
+
+template<>
+struct VertexComponent<Packed2101010>
+{
+	static constexpr unsigned int Type = GL_INT_2_10_10_10_REV;
+	static constexpr unsigned char Normalized = GL_TRUE;
+	static constexpr unsigned int Components = 4;
+};
+
+/**
+ *	One member of a vertex struct, T is the member's type (e.g. float[3]) and Offset where it starts.
+ *	Use the VERTEX_ATTRIBUTE macro rather than naming it directly.
+ */
+template<typename T, unsigned int Offset>
+struct VertexAttribute
+{
+	using Component = typename std::remove_all_extents<T>::type;
+
+	static constexpr VertexBufferElement Element = {
+		VertexComponent<Component>::Type,
+		VertexComponent<Component>::Components * (unsigned int)(sizeof(T) / sizeof(Component)),
+		VertexComponent<Component>::Normalized,
+		Offset
+	};
+};
+
+template<typename T, unsigned int Offset>
+constexpr VertexBufferElement VertexAttribute<T, Offset>::Element;
+
+/**
+ *	The attribute for Member of the struct Vertex
+ */
+#define VERTEX_ATTRIBUTE(Vertex, Member) VertexAttribute<decltype(Vertex::Member), (unsigned int)offsetof(Vertex, Member)>
+
+/**
+ *	A vertex layout worked out at compile time from a vertex struct, so adding it to a VertexArray
+ *	copies and allocates nothing. Attributes are numbered in the order they are listed.
+ *
+ *	using QuadLayout = StaticVertexLayout<QuadVertex,
+ *		VERTEX_ATTRIBUTE(QuadVertex, Position),
+ *		VERTEX_ATTRIBUTE(QuadVertex, TexCoord)>;
+ *	va.AddBuffer<QuadLayout>(vb);
+ *
+ *	VertexBufferLayout is still there for layouts only known at run time.
+ */
+template<typename Vertex, typename... Attributes>
+struct StaticVertexLayout
+{
+	static_assert(sizeof...(Attributes) > 0, "A vertex layout needs at least one attribute");
+
+	static constexpr unsigned int Stride = sizeof(Vertex);
+	static constexpr unsigned int ElementCount = sizeof...(Attributes);
+	static constexpr VertexBufferElement Elements[sizeof...(Attributes)] = { Attributes::Element... };
+};
+
+template<typename Vertex, typename... Attributes>
+constexpr VertexBufferElement StaticVertexLayout<Vertex, Attributes...>::Elements[sizeof...(Attributes)];
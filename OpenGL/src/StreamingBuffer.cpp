@@ -0,0 +1,150 @@
+#include "StreamingBuffer.h"
+
+#include "Renderer.h"
+#include "GLState.h"
+
+// How long a single wait for a fence may block, in nanoseconds, before it is retried
+static const GLuint64 s_FenceTimeout = 1000000;
+
+StreamingBuffer::StreamingBuffer(GLenum target, unsigned int regionSize)
+	: m_Target(target), m_RegionSize(regionSize), m_Mapped(nullptr), m_Region(0), m_Head(0), m_AllocationOffset(0)
+{
+	for (unsigned int i = 0; i < RegionCount; i++)
+	{
+		m_Fences[i] = nullptr;
+	}
+
+	unsigned int size = regionSize * RegionCount;
+	GLCall(glGenBuffers(1, &m_RendererID));
+	Bind();
+	if (IsSupported())
+	{
+		// Immutable storage that stays mapped for its whole life, coherent so no flush is needed
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		GLCall(glBufferStorage(target, size, nullptr, flags));
+		GLCall(m_Mapped = (unsigned char*)glMapBufferRange(target, 0, size, flags));
+	}
+	else
+	{
+		GLCall(glBufferData(target, size, nullptr, GL_STREAM_DRAW));
+		m_Staging.resize(size);
+	}
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+	for (unsigned int i = 0; i < RegionCount; i++)
+	{
+		if (m_Fences[i])
+		{
+			GLCall(glDeleteSync(m_Fences[i]));
+		}
+	}
+
+	if (m_Mapped)
+	{
+		Bind();
+		GLCall(glUnmapBuffer(m_Target));
+	}
+	GLState::OnDeleteBuffer(m_RendererID);
+	GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void* StreamingBuffer::Allocate(unsigned int size, unsigned int alignment, unsigned int& offset)
+{
+	ASSERT(size <= m_RegionSize);
+
+	unsigned int regionEnd = (m_Region + 1) * m_RegionSize;
+	offset = (m_Head + alignment - 1) / alignment * alignment;
+	if (offset + size > regionEnd)
+	{
+		NextRegion();
+		offset = (m_Head + alignment - 1) / alignment * alignment;
+	}
+
+	m_AllocationOffset = offset;
+	return m_Mapped ? m_Mapped + offset : m_Staging.data() + offset;
+}
+
+void StreamingBuffer::Commit(unsigned int size)
+{
+	if (size == 0)
+	{
+		return;
+	}
+
+	if (!m_Mapped)
+	{
+		Bind();
+		GLCall(glBufferSubData(m_Target, m_AllocationOffset, size, m_Staging.data() + m_AllocationOffset));
+	}
+	m_Head = m_AllocationOffset + size;
+	m_Stats.BytesWritten += size;
+}
+
+void StreamingBuffer::EndFrame()
+{
+	// Nothing was written, so the region can be reused straight away
+	if (m_Head == m_Region * m_RegionSize)
+	{
+		return;
+	}
+	NextRegion();
+}
+
+void StreamingBuffer::Bind() const
+{
+	GLState::BindBuffer(m_Target, m_RendererID);
+}
+
+void StreamingBuffer::UnBind() const
+{
+	GLState::BindBuffer(m_Target, 0);
+}
+
+bool StreamingBuffer::IsSupported()
+{
+	return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+}
+
+void StreamingBuffer::NextRegion()
+{
+	if (m_Mapped)
+	{
+		// Everything drawn so far reads the current region, the fence tells when that is done
+		GLCall(m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	}
+
+	m_Region = (m_Region + 1) % RegionCount;
+	m_Head = m_Region * m_RegionSize;
+
+	if (m_Mapped)
+	{
+		GLsync fence = m_Fences[m_Region];
+		if (!fence)
+		{
+			return;
+		}
+
+		GLCall(GLenum result = glClientWaitSync(fence, 0, 0));
+		if (result == GL_TIMEOUT_EXPIRED)
+		{
+			// The GPU is more than RegionCount frames behind, so the CPU has to wait for it
+			m_Stats.Waits++;
+			do
+			{
+				GLCall(result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, s_FenceTimeout));
+			} while (result == GL_TIMEOUT_EXPIRED);
+		}
+		GLCall(glDeleteSync(fence));
+		m_Fences[m_Region] = nullptr;
+	}
+	else if (m_Region == 0)
+	{
+		// Give the old storage to the GPU and continue in fresh storage, instead of waiting for the
+		// draws that still read it
+		Bind();
+		GLCall(glBufferData(m_Target, m_RegionSize * RegionCount, nullptr, GL_STREAM_DRAW));
+		m_Stats.Orphans++;
+	}
+}
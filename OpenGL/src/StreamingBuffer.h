@@ -0,0 +1,135 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+/**
+ *	A buffer for data that is rewritten every frame, such as batched vertices or per-draw uniforms.
+ *
+ *	The buffer is split into RegionCount regions used in turn, one per frame, and each region is
+ *	guarded by a fence so it is only written once the GPU has finished reading it. When the context
+ *	has ARB_buffer_storage the whole buffer stays mapped (persistent and coherent), so writes go
+ *	straight to memory the GPU reads without any copy or synchronisation by the driver.
+ *	Otherwise writes go to a CPU copy which Commit uploads with glBufferSubData, and the storage is
+ *	orphaned every time the ring wraps around so the upload never waits for the GPU.
+ */
+class StreamingBuffer
+{
+public:
+	/**
+	 *	Number of frames the CPU can run ahead of the GPU before it has to wait
+	 */
+	static const unsigned int RegionCount = 3;
+
+	/**
+	 *	Counters for the work done since the last ResetStats
+	 */
+	struct Stats
+	{
+		// Bytes committed for the GPU to read
+		unsigned int BytesWritten = 0;
+		// Times a region was still in use by the GPU when it was needed again
+		unsigned int Waits = 0;
+		// Times the storage was orphaned, only without persistent mapping
+		unsigned int Orphans = 0;
+	};
+
+	/**
+	 *	Creates the buffer
+	 *	@param target The target the buffer is bound to, e.g. GL_ARRAY_BUFFER
+	 *	@param regionSize Size in bytes of the data written during one frame
+	 */
+	StreamingBuffer(GLenum target, unsigned int regionSize);
+
+	/**
+	 *	Unmaps and deletes the buffer and its fences
+	 */
+	~StreamingBuffer();
+
+	StreamingBuffer(const StreamingBuffer&) = delete;
+	StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+
+	/**
+	 *	Reserves space in the current region, moving to the next region if it does not fit
+	 *	@param size Size in bytes to reserve, at most the region size
+	 *	@param alignment The offset is a multiple of this, e.g. the vertex size to draw with a base vertex
+	 *	@param offset Set to the offset in bytes of the reserved space from the start of the buffer
+	 *	@return where the data is written, valid until Commit
+	 */
+	void* Allocate(unsigned int size, unsigned int alignment, unsigned int& offset);
+
+	/**
+	 *	Hands the data written since the last Allocate to GL.
+	 *	@param size Size in bytes actually written, at most the size that was allocated
+	 */
+	void Commit(unsigned int size);
+
+	/**
+	 *	Marks the end of the GPU commands that read the current region and moves to the next one
+	 */
+	void EndFrame();
+
+	/**
+	 *	Bind this buffer to its target
+	 */
+	void Bind() const;
+
+	/**
+	 *	Unbind this buffer from its target
+	 */
+	void UnBind() const;
+
+	inline unsigned int GetRendererID() const
+	{
+		return m_RendererID;
+	}
+
+	/**
+	 *	@return true if writes go straight to mapped GPU memory
+	 */
+	inline bool IsPersistent() const
+	{
+		return m_Mapped != nullptr;
+	}
+
+	inline const Stats& GetStats() const
+	{
+		return m_Stats;
+	}
+
+	inline void ResetStats()
+	{
+		m_Stats = Stats();
+	}
+
+	/**
+	 * @return true if the context supports persistent mapping (GL 4.4 or ARB_buffer_storage)
+	 */
+	static bool IsSupported();
+
+private:
+	unsigned int m_RendererID;
+	GLenum m_Target;
+	unsigned int m_RegionSize;
+
+	// The whole buffer when persistently mapped, otherwise null
+	unsigned char* m_Mapped;
+	// CPU copy written instead of the buffer when it cannot be mapped
+	std::vector<unsigned char> m_Staging;
+
+	unsigned int m_Region;
+	// Offset of the first free byte from the start of the buffer
+	unsigned int m_Head;
+	// Offset of the space handed out by the last Allocate
+	unsigned int m_AllocationOffset;
+
+	// Signalled once the GPU is done with the commands that read each region
+	GLsync m_Fences[RegionCount];
+
+	Stats m_Stats;
+
+	/**
+	 *	Moves to the next region, waiting for the GPU to finish reading it if needed
+	 */
+	void NextRegion();
+};
@@ -1,17 +1,65 @@
 #include "Texture.h"
 #include <GL/glew.h>
+#include "GLState.h"
+#include "GLNamePool.h"
+#include "Profiler.h"
 #include "vendor/stb_image/stb_image.h"
 
+#include <algorithm>
+
+/**
+ *	Swaps the rows of RGBA8 pixels top to bottom
+ */
+static void FlipRows(unsigned char* pixels, int width, int height)
+{
+	size_t rowSize = (size_t)width * 4;
+	for (int row = 0; row < height / 2; row++)
+	{
+		unsigned char* top = pixels + row * rowSize;
+		unsigned char* bottom = pixels + (height - 1 - row) * rowSize;
+		std::swap_ranges(top, top + rowSize, bottom);
+	}
+}
+
 Texture::Texture(const std::string & path)
 	: m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0)
 {
+	PROFILE_SCOPE("Texture::Texture");
+
+	{
+		PROFILE_SCOPE("Texture decode");
+		m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
+	}
+
 	// Flips texture vertically. This is necessary as bottom left in opengl is bottom left, not top left
-	// for a png, this works, but it depends on the image format
-	stbi_set_flip_vertically_on_load(1);
-	m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
+	// for a png. Done here rather than with stbi_set_flip_vertically_on_load, a global that would change
+	// how decodes running on other threads (TextureLoader, GltfLoader) come out.
+	if (m_LocalBuffer)
+	{
+		FlipRows(m_LocalBuffer, m_Width, m_Height);
+	}
+
+	Create(m_LocalBuffer);
+
+	if(m_LocalBuffer)
+	{
+		stbi_image_free(m_LocalBuffer);
+		m_LocalBuffer = nullptr;
+	}
+}
+
+Texture::Texture(const unsigned char * pixels, int width, int height)
+	: m_LocalBuffer(nullptr), m_Width(width), m_Height(height), m_BPP(4)
+{
+	PROFILE_SCOPE("Texture::Texture");
+
+	Create(pixels);
+}
 
-	GLCall(glGenTextures(1, &m_RendererID));
-	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+void Texture::Create(const unsigned char * pixels)
+{
+	m_RendererID = GLNamePool::GenTexture();
+	GLState::BindTexture(GLState::GetActiveTexture(), m_RendererID);
 
 	// These must be specified, basically setting parameter defaults
 	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
@@ -19,27 +67,62 @@ Texture::Texture(const std::string & path)
 	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
 	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
 
-	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
+	{
+		PROFILE_GPU_SCOPE("Texture upload");
+		GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+	}
 	GLCall(UnBind());
+}
 
-	if(m_LocalBuffer)
+Texture::~Texture()
+{
+	if (m_RendererID)
 	{
-		stbi_image_free(m_LocalBuffer);
+		GLNamePool::ReleaseTexture(m_RendererID);
 	}
 }
 
-Texture::~Texture()
+Texture::Texture(Texture && other) noexcept
+	: m_RendererID(other.m_RendererID), m_FilePath(std::move(other.m_FilePath)), m_LocalBuffer(nullptr),
+	m_Width(other.m_Width), m_Height(other.m_Height), m_BPP(other.m_BPP)
+{
+	other.m_RendererID = 0;
+}
+
+Texture & Texture::operator=(Texture && other) noexcept
 {
-	GLCall(glDeleteTextures(1, &m_RendererID));
+	if (this != &other)
+	{
+		// The old texture is released by other's destructor
+		std::swap(m_RendererID, other.m_RendererID);
+		std::swap(m_FilePath, other.m_FilePath);
+		std::swap(m_Width, other.m_Width);
+		std::swap(m_Height, other.m_Height);
+		std::swap(m_BPP, other.m_BPP);
+	}
+	return *this;
 }
 
 void Texture::Bind(unsigned int slot) const
 {
-	GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+	GLState::BindTexture(slot, m_RendererID);
 }
 
 void Texture::UnBind()
 {
-	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+	GLState::BindTexture(GLState::GetActiveTexture(), 0);
+}
+
+void Texture::SetWrap(unsigned int wrapS, unsigned int wrapT)
+{
+	GLState::BindTexture(GLState::GetActiveTexture(), m_RendererID);
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT));
+}
+
+void Texture::SetRows(int firstRow, int rowCount, const void * pixels)
+{
+	GLState::BindTexture(GLState::GetActiveTexture(), m_RendererID);
+	GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, m_Width, rowCount, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+	GLCall(UnBind());
 }
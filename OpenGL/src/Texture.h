@@ -7,11 +7,40 @@ class Texture
 {
 public:
 	Texture(const std::string& path);
+
+	/**
+	 * Uploads decoded pixels, e.g. from an image embedded in a model
+	 * @param pixels width * height RGBA8 pixels, the first row is at texture coordinate v = 0.
+	 * Null leaves the texture undefined, to be filled in later with SetRows.
+	 */
+	Texture(const unsigned char* pixels, int width, int height);
 	~Texture();
 
+	Texture(const Texture&) = delete;
+	Texture& operator=(const Texture&) = delete;
+
+	/**
+	 * Moves the texture to a new owner, leaving other empty
+	 */
+	Texture(Texture&& other) noexcept;
+	Texture& operator=(Texture&& other) noexcept;
+
 	void Bind(unsigned int slot = 0) const;
 	void UnBind();
 
+	/**
+	 * Replaces whole rows of the texture, e.g. to upload a large image a few rows per frame
+	 * @param firstRow The row at texture coordinate v = firstRow / height
+	 * @param pixels rowCount * width RGBA8 pixels, or an offset into the bound GL_PIXEL_UNPACK_BUFFER
+	 */
+	void SetRows(int firstRow, int rowCount, const void* pixels);
+
+	/**
+	 * Sets how texture coordinates outside 0 to 1 are handled, GL_CLAMP_TO_EDGE unless changed
+	 * @param wrapS, wrapT GL_REPEAT, GL_MIRRORED_REPEAT or GL_CLAMP_TO_EDGE
+	 */
+	void SetWrap(unsigned int wrapS, unsigned int wrapT);
+
 	inline int GetWidth() const
 	{
 		return m_Width;
@@ -22,9 +51,19 @@ public:
 		return m_Height; 
 	}
 
+	inline unsigned int GetRendererID() const
+	{
+		return m_RendererID;
+	}
+
 private:
 	unsigned int m_RendererID;
 	std::string m_FilePath;
 	unsigned char * m_LocalBuffer;
 	int m_Width, m_Height, m_BPP; // BPP = Bits per Pixel
+
+	/**
+	 * Creates the GL texture and uploads m_Width * m_Height RGBA8 pixels
+	 */
+	void Create(const unsigned char* pixels);
 };
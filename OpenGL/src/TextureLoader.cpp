@@ -0,0 +1,170 @@
+#include "TextureLoader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include "vendor/stb_image/stb_image.h"
+
+// Shown while a texture loads, one grey pixel
+static const unsigned char s_PlaceholderPixels[] = { 128, 128, 128, 255 };
+
+TextureLoader::TextureLoader(ThreadPool & pool, unsigned int uploadBudget)
+	: m_Pool(pool), m_UploadBudget(uploadBudget), m_Placeholder(s_PlaceholderPixels, 1, 1),
+	m_UploadBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBudget)
+{
+	// While a pixel unpack buffer is bound, every glTexImage2D reads from it rather than from memory
+	m_UploadBuffer.UnBind();
+}
+
+TextureLoader::~TextureLoader()
+{
+	for (unsigned int index : m_Decoding)
+	{
+		m_Entries[index]->Decoded.wait();
+	}
+	for (const std::unique_ptr<Entry>& entry : m_Entries)
+	{
+		if (entry->Pixels)
+		{
+			stbi_image_free(entry->Pixels);
+		}
+	}
+}
+
+unsigned int TextureLoader::Load(const std::string & path)
+{
+	unsigned int index = (unsigned int)m_Entries.size();
+	m_Entries.push_back(std::make_unique<Entry>());
+	Entry* entry = m_Entries.back().get();
+	entry->Path = path;
+
+	// The rows stay top first, UploadRows turns them around as it copies them
+	entry->Decoded = m_Pool.Enqueue([entry]()
+	{
+		int channels;
+		entry->Pixels = stbi_load(entry->Path.c_str(), &entry->Width, &entry->Height, &channels, 4);
+	});
+	m_Decoding.push_back(index);
+	return index;
+}
+
+void TextureLoader::Update()
+{
+	PROFILE_SCOPE("TextureLoader::Update");
+
+	// Decodes finish in any order, so every one is checked
+	for (auto it = m_Decoding.begin(); it != m_Decoding.end();)
+	{
+		Entry& entry = *m_Entries[*it];
+		if (entry.Decoded.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			++it;
+			continue;
+		}
+
+		entry.Decoded.get();
+		if (entry.Pixels)
+		{
+			// Only allocates the storage, the rows follow over the next frames
+			entry.Uploaded = std::make_unique<Texture>(nullptr, entry.Width, entry.Height);
+			m_Uploading.push_back(*it);
+		}
+		else
+		{
+			std::cout << "Could not load texture '" << entry.Path << "'" << std::endl;
+		}
+		it = m_Decoding.erase(it);
+	}
+
+	unsigned int budget = m_UploadBudget;
+	while (!m_Uploading.empty())
+	{
+		Entry& entry = *m_Entries[m_Uploading.front()];
+		if (!UploadRows(entry, budget))
+		{
+			break;
+		}
+
+		if (entry.RowsUploaded == entry.Height)
+		{
+			stbi_image_free(entry.Pixels);
+			entry.Pixels = nullptr;
+			entry.Resident = true;
+			m_Stats.TexturesCompleted++;
+			m_Uploading.pop_front();
+		}
+	}
+
+	m_UploadBuffer.UnBind();
+	m_UploadBuffer.EndFrame();
+}
+
+void TextureLoader::Bind(unsigned int texture, unsigned int slot) const
+{
+	const Entry& entry = *m_Entries[texture];
+	if (entry.Resident)
+	{
+		entry.Uploaded->Bind(slot);
+	}
+	else
+	{
+		m_Placeholder.Bind(slot);
+	}
+}
+
+bool TextureLoader::IsResident(unsigned int texture) const
+{
+	return m_Entries[texture]->Resident;
+}
+
+bool TextureLoader::UploadRows(Entry & entry, unsigned int & budget)
+{
+	unsigned int rowSize = (unsigned int)entry.Width * 4;
+	if (rowSize > m_UploadBudget)
+	{
+		// Not even one row fits into the upload buffer, so the texture is uploaded from memory in a frame of its own
+		if (budget < m_UploadBudget)
+		{
+			return false;
+		}
+		m_UploadBuffer.UnBind();
+		for (int row = 0; row < entry.Height; row++)
+		{
+			entry.Uploaded->SetRows(row, 1, entry.Pixels + (size_t)(entry.Height - 1 - row) * rowSize);
+		}
+		m_Stats.BytesUploaded += rowSize * entry.Height;
+		entry.RowsUploaded = entry.Height;
+		budget = 0;
+		return true;
+	}
+
+	int rows = std::min(entry.Height - entry.RowsUploaded, (int)(budget / rowSize));
+	if (rows == 0)
+	{
+		return false;
+	}
+
+	unsigned int size = rows * rowSize;
+	unsigned int offset;
+	unsigned char* data = (unsigned char*)m_UploadBuffer.Allocate(size, 4, offset);
+	// stb_image decodes the top row first, while the texture starts with the bottom row at v = 0
+	for (int row = 0; row < rows; row++)
+	{
+		const unsigned char* source = entry.Pixels + (size_t)(entry.Height - 1 - entry.RowsUploaded - row) * rowSize;
+		std::memcpy(data + (size_t)row * rowSize, source, rowSize);
+	}
+	m_UploadBuffer.Commit(size);
+
+	// The pixel pointer is an offset into the bound unpack buffer, so the copy to the texture is done by the driver
+	m_UploadBuffer.Bind();
+	entry.Uploaded->SetRows(entry.RowsUploaded, rows, (const void*)(size_t)offset);
+
+	entry.RowsUploaded += rows;
+	budget -= size;
+	m_Stats.BytesUploaded += size;
+	return true;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "StreamingBuffer.h"
+#include "Texture.h"
+
+class ThreadPool;
+
+/**
+ *	Loads textures without stalling the frame. Files are decoded on a ThreadPool, and Update, called once
+ *	per frame, uploads at most a fixed number of bytes of the decoded rows through a pixel unpack buffer,
+ *	so the cost per frame stays the same however many textures are queued. Until all of a texture's rows
+ *	are on the GPU, Bind binds a small grey placeholder instead.
+ *
+ *	The pixel unpack buffer is a StreamingBuffer, so with ARB_buffer_storage the rows are written straight
+ *	into persistently mapped memory and the driver copies them to the texture without blocking.
+ */
+class TextureLoader
+{
+public:
+	/**
+	 *	Counters for the work done since the last ResetStats
+	 */
+	struct Stats
+	{
+		unsigned int BytesUploaded = 0;
+		unsigned int TexturesCompleted = 0;
+	};
+
+	/**
+	 *	@param pool Workers that decode the files, it must outlive this loader
+	 *	@param uploadBudget Bytes of pixels Update uploads at most, e.g. 4 MB is one 1024 x 1024 texture per frame
+	 */
+	TextureLoader(ThreadPool& pool, unsigned int uploadBudget = 4 * 1024 * 1024);
+
+	/**
+	 *	Waits for the decodes still running, then deletes the textures
+	 */
+	~TextureLoader();
+
+	TextureLoader(const TextureLoader&) = delete;
+	TextureLoader& operator=(const TextureLoader&) = delete;
+
+	/**
+	 *	Starts decoding a file in the background
+	 *	@return the handle to Bind the texture with
+	 */
+	unsigned int Load(const std::string& path);
+
+	/**
+	 *	Creates textures for the files decoded since the last call and uploads up to the budget of their rows.
+	 *	Call once per frame, from the thread that owns the GL context.
+	 */
+	void Update();
+
+	/**
+	 *	Binds the texture, or the placeholder until it is resident or if its file could not be decoded
+	 */
+	void Bind(unsigned int texture, unsigned int slot = 0) const;
+
+	/**
+	 *	@return true once every row of the texture is uploaded
+	 */
+	bool IsResident(unsigned int texture) const;
+
+	/**
+	 *	@return the number of textures still decoding or uploading
+	 */
+	inline unsigned int GetPendingCount() const
+	{
+		return (unsigned int)(m_Decoding.size() + m_Uploading.size());
+	}
+
+	inline const Stats& GetStats() const
+	{
+		return m_Stats;
+	}
+
+	inline void ResetStats()
+	{
+		m_Stats = Stats();
+	}
+
+private:
+	/**
+	 *	One texture requested with Load
+	 */
+	struct Entry
+	{
+		std::string Path;
+		// Written by the decode task, read once its future is ready
+		unsigned char* Pixels = nullptr;
+		int Width = 0;
+		int Height = 0;
+		std::future<void> Decoded;
+
+		std::unique_ptr<Texture> Uploaded;
+		// Rows uploaded so far, counting from v = 0
+		int RowsUploaded = 0;
+		bool Resident = false;
+	};
+
+	ThreadPool& m_Pool;
+	unsigned int m_UploadBudget;
+	// Created before the upload buffer, which would otherwise be bound while it is filled
+	Texture m_Placeholder;
+	StreamingBuffer m_UploadBuffer;
+
+	// Entries are never moved once a decode task holds a pointer to them
+	std::vector<std::unique_ptr<Entry>> m_Entries;
+	// Indices into m_Entries, in the order they were loaded
+	std::deque<unsigned int> m_Decoding;
+	std::deque<unsigned int> m_Uploading;
+
+	Stats m_Stats;
+
+	/**
+	 *	Uploads as many of the texture's remaining rows as the budget allows
+	 *	@param budget Bytes that may still be uploaded this frame, reduced by what was uploaded
+	 *	@return false if not even one row fit
+	 */
+	bool UploadRows(Entry& entry, unsigned int& budget);
+};
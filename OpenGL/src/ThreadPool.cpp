@@ -0,0 +1,94 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+	: m_Stopping(false)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::thread::hardware_concurrency();
+		// hardware_concurrency may not be able to tell
+		if (threadCount == 0)
+		{
+			threadCount = 2;
+		}
+	}
+
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stopping = true;
+	}
+	m_Condition.notify_all();
+
+	for (std::thread& worker : m_Workers)
+	{
+		worker.join();
+	}
+}
+
+std::future<void> ThreadPool::Enqueue(std::function<void()> task)
+{
+	std::packaged_task<void()> packaged(std::move(task));
+	std::future<void> result = packaged.get_future();
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Tasks.push_back(std::move(packaged));
+	}
+	m_Condition.notify_one();
+	return result;
+}
+
+void ThreadPool::ParallelFor(unsigned int count, const std::function<void(unsigned int begin, unsigned int end)>& body)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	unsigned int chunks = GetThreadCount() < count ? GetThreadCount() : count;
+	unsigned int chunkSize = (count + chunks - 1) / chunks;
+
+	std::vector<std::future<void>> results;
+	results.reserve(chunks);
+	for (unsigned int begin = 0; begin < count; begin += chunkSize)
+	{
+		unsigned int end = begin + chunkSize < count ? begin + chunkSize : count;
+		results.push_back(Enqueue([&body, begin, end]() { body(begin, end); }));
+	}
+
+	// Every task must finish before body goes out of scope, only then is the first exception rethrown
+	for (std::future<void>& result : results)
+	{
+		result.wait();
+	}
+	for (std::future<void>& result : results)
+	{
+		result.get();
+	}
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::packaged_task<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this]() { return m_Stopping || !m_Tasks.empty(); });
+			if (m_Stopping && m_Tasks.empty())
+			{
+				return;
+			}
+			task = std::move(m_Tasks.front());
+			m_Tasks.pop_front();
+		}
+		task();
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ *	A fixed set of worker threads that run queued tasks.
+ *	Tasks must not call into OpenGL, the context only belongs to the thread that made it current.
+ */
+class ThreadPool
+{
+public:
+	/**
+	 *	Starts the worker threads
+	 *	@param threadCount Number of workers, 0 uses one per hardware thread
+	 */
+	ThreadPool(unsigned int threadCount = 0);
+
+	/**
+	 *	Finishes the queued tasks and joins the workers
+	 */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 *	Queues a task
+	 *	@return a future that becomes ready once the task has run
+	 */
+	std::future<void> Enqueue(std::function<void()> task);
+
+	/**
+	 *	Splits [0, count) into one contiguous range per worker and waits for all of them.
+	 *	Must not be called from a task of the same pool, as it would wait on itself.
+	 *	@param body Called with the begin and end of each range
+	 */
+	void ParallelFor(unsigned int count, const std::function<void(unsigned int begin, unsigned int end)>& body);
+
+	inline unsigned int GetThreadCount() const
+	{
+		return (unsigned int)m_Workers.size();
+	}
+
+private:
+	std::vector<std::thread> m_Workers;
+	std::deque<std::packaged_task<void()>> m_Tasks;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	bool m_Stopping;
+
+	/**
+	 *	Loop run by every worker, taking tasks until the pool is destroyed
+	 */
+	void WorkerLoop();
+};
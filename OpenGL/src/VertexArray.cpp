@@ -1,49 +1,135 @@
 #include "VertexArray.h"
 #include "Renderer.h"
+#include "GLState.h"
 #include "VertexBufferLayout.h"
-#include <iostream>
+#include "StreamingBuffer.h"
 
 VertexArray::VertexArray()
+	: m_AttribCount(0)
 {
 	GLCall(glGenVertexArrays(1, &m_RendererID)); // Generate one vertex array and store id in m_RendererID variable
 }
 
 VertexArray::~VertexArray()
 {
-	GLCall(glDeleteVertexArrays(1, &m_RendererID));
+	if (m_RendererID)
+	{
+		GLState::OnDeleteVertexArray(m_RendererID);
+		GLCall(glDeleteVertexArrays(1, &m_RendererID));
+	}
+}
+
+VertexArray::VertexArray(VertexArray && other) noexcept
+	: m_RendererID(other.m_RendererID), m_AttribCount(other.m_AttribCount)
+{
+	other.m_RendererID = 0;
+}
+
+VertexArray & VertexArray::operator=(VertexArray && other) noexcept
+{
+	if (this != &other)
+	{
+		std::swap(m_RendererID, other.m_RendererID);
+		std::swap(m_AttribCount, other.m_AttribCount);
+	}
+	return *this;
 }
 
 void VertexArray::AddBuffer(const VertexBuffer & vb, const VertexBufferLayout & layout)
+{
+	const auto& elements = layout.GetElements();
+	AddElements(vb, elements.data(), (unsigned int)elements.size(), layout.GetStride(), layout.GetDivisor());
+}
+
+void VertexArray::AddBuffer(const StreamingBuffer & sb, const VertexBufferLayout & layout)
+{
+	const auto& elements = layout.GetElements();
+	AddElements(sb, elements.data(), (unsigned int)elements.size(), layout.GetStride(), layout.GetDivisor());
+}
+
+void VertexArray::AddElements(const VertexBuffer & vb, const VertexBufferElement * elements, unsigned int count, unsigned int stride, unsigned int divisor)
 {
 	Bind();
 	vb.Bind();
-	const auto& elements = layout.GetElements();
-	unsigned int offset = 0;
-	for(unsigned int i = 0; i < elements.size(); i++)
+	AddAttributes(elements, count, stride, divisor);
+}
+
+void VertexArray::AddElements(const StreamingBuffer & sb, const VertexBufferElement * elements, unsigned int count, unsigned int stride, unsigned int divisor)
+{
+	Bind();
+	sb.Bind();
+	AddAttributes(elements, count, stride, divisor);
+}
+
+void VertexArray::Bind() const
+{
+	GLState::BindVertexArray(m_RendererID);
+}
+
+void VertexArray::UnBind() const
+{
+	GLState::BindVertexArray(0);
+}
+
+void VertexArray::AddAttributes(const VertexBufferElement * elements, unsigned int count, unsigned int stride, unsigned int divisor)
+{
+	for(unsigned int i = 0; i < count; i++)
 	{
 		const auto& element = elements[i];
-		
-		// Tell OpenGL The layout of our vertex buffer.
-		// Enable drawing of Vertex
-		GLCall(glEnableVertexAttribArray(i));
-		// Size = num points per vertex (two in this case).
-		// Stride = length in bytes from the start of one vertex to start of the next.
-		GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), (const void*) offset));
-
-		std::cout << "Elements Count " << element.count;
-
-		// increment offset, multiply increment amount by size in bytes of type
-		// The offset says where the first element starts
-		offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+		unsigned int typeSize = VertexBufferElement::GetSizeOfType(element.type);
+
+		// An attribute holds at most 4 components, so larger elements (e.g. a mat4 per instance)
+		// are spread over consecutive attributes
+		for (unsigned int component = 0; component < element.count; component += 4)
+		{
+			unsigned int size = element.count - component < 4 ? element.count - component : 4;
+
+			// Tell OpenGL The layout of our vertex buffer.
+			// Enable drawing of Vertex
+			GLCall(glEnableVertexAttribArray(m_AttribCount));
+			// Size = num points per vertex (two in this case).
+			// Stride = length in bytes from the start of one vertex to start of the next.
+			// The offset says where the first element starts
+			GLCall(glVertexAttribPointer(m_AttribCount, size, element.type, element.normalized, stride, (const void*)(size_t)(element.offset + component * typeSize)));
+			// A divisor of 0 advances per vertex, otherwise once every divisor instances
+			GLCall(glVertexAttribDivisor(m_AttribCount, divisor));
+
+			m_AttribCount++;
+		}
 	}
 }
 
-void VertexArray::Bind() const
+void VertexArray::AddFormat(unsigned int binding, const VertexBufferElement * elements, unsigned int count, unsigned int divisor)
 {
-	GLCall(glBindVertexArray(m_RendererID));
+	Bind();
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const auto& element = elements[i];
+		unsigned int typeSize = VertexBufferElement::GetSizeOfType(element.type);
+
+		for (unsigned int component = 0; component < element.count; component += 4)
+		{
+			unsigned int size = element.count - component < 4 ? element.count - component : 4;
+
+			GLCall(glEnableVertexAttribArray(m_AttribCount));
+			// Only the format and where the attribute is in a vertex, the stride belongs to the binding
+			GLCall(glVertexAttribFormat(m_AttribCount, size, element.type, element.normalized, element.offset + component * typeSize));
+			GLCall(glVertexAttribBinding(m_AttribCount, binding));
+
+			m_AttribCount++;
+		}
+	}
+	GLCall(glVertexBindingDivisor(binding, divisor));
 }
 
-void VertexArray::UnBind() const
+void VertexArray::BindVertexBuffer(unsigned int binding, unsigned int buffer, unsigned int stride)
+{
+	Bind();
+	// Views of an arena are reached by their base vertex, like with AddBuffer, so the buffer starts at 0
+	GLCall(glBindVertexBuffer(binding, buffer, 0, stride));
+}
+
+bool VertexArray::IsFormatSupported()
 {
-	GLCall(glBindVertexArray(0));
+	return GLEW_VERSION_4_3 || GLEW_ARB_vertex_attrib_binding;
 }
@@ -1,8 +1,10 @@
 #pragma once
 
-#include "VertexBuffer.h";
+#include "VertexBuffer.h"
 
 class VertexBufferLayout;
+class StreamingBuffer;
+struct VertexBufferElement;
 
 class VertexArray
 {
@@ -17,11 +19,66 @@ public:
 	 */
 	~VertexArray();
 
+	VertexArray(const VertexArray&) = delete;
+	VertexArray& operator=(const VertexArray&) = delete;
+
 	/**
-	 *	Adds a VertexBuffer and VertexBufferLayout and binds them to this VertexArray
+	 * Moves the GL object to a new owner, leaving other empty
+	 */
+	VertexArray(VertexArray&& other) noexcept;
+	VertexArray& operator=(VertexArray&& other) noexcept;
+
+	/**
+	 *	Adds a VertexBuffer and VertexBufferLayout and binds them to this VertexArray.
+	 *	Each call continues from the attribute index the previous call stopped at, so per-instance
+	 *	buffers can be added after the per-vertex buffer, and attributes can come from several buffers
+	 *	(see VertexStreams to split interleaved vertices).
 	 */
 	void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
 
+	/**
+	 *	Adds a StreamingBuffer the same way. Its attributes start at offset 0 of the buffer, so draws
+	 *	reach the data of a later allocation through their base vertex.
+	 */
+	void AddBuffer(const StreamingBuffer& sb, const VertexBufferLayout& layout);
+
+	/**
+	 *	Adds a VertexBuffer with a StaticVertexLayout, whose elements are known at compile time
+	 *	@param divisor Number of instances drawn before advancing to the next vertex, 0 for per-vertex data
+	 */
+	template<typename Layout>
+	void AddBuffer(const VertexBuffer& vb, unsigned int divisor = 0)
+	{
+		AddElements(vb, Layout::Elements, Layout::ElementCount, Layout::Stride, divisor);
+	}
+
+	/**
+	 *	Adds a StreamingBuffer with a StaticVertexLayout
+	 */
+	template<typename Layout>
+	void AddBuffer(const StreamingBuffer& sb, unsigned int divisor = 0)
+	{
+		AddElements(sb, Layout::Elements, Layout::ElementCount, Layout::Stride, divisor);
+	}
+
+	/**
+	 *	Sets the attribute index the next AddBuffer starts at, so a stream can be placed at the locations
+	 *	a shader declares, e.g. texture coordinates at 1 in a vertex array for a shader that also reads
+	 *	positions, or nothing but positions at 0 in one for depth-only passes.
+	 */
+	inline void SetNextAttribute(unsigned int index)
+	{
+		m_AttribCount = index;
+	}
+
+	/**
+	 * @return the attribute index the next AddBuffer starts at
+	 */
+	inline unsigned int GetNextAttribute() const
+	{
+		return m_AttribCount;
+	}
+
 	/**
 	 * Binds this VertexArray
 	 */
@@ -32,9 +89,47 @@ public:
 	 */
 	void UnBind() const;
 
+	inline unsigned int GetRendererID() const
+	{
+		return m_RendererID;
+	}
+
+	/**
+	 * @return true if attribute formats can be set apart from the buffers they read (GL 4.3 or ARB_vertex_attrib_binding)
+	 */
+	static bool IsFormatSupported();
+
 protected:
 
 private:
 	unsigned int m_RendererID;
 
+	// The next free vertex attribute index
+	unsigned int m_AttribCount;
+
+	/**
+	 *	Binds this and the buffer, then adds the elements as attributes
+	 */
+	void AddElements(const VertexBuffer& vb, const VertexBufferElement* elements, unsigned int count, unsigned int stride, unsigned int divisor);
+	void AddElements(const StreamingBuffer& sb, const VertexBufferElement* elements, unsigned int count, unsigned int stride, unsigned int divisor);
+
+	/**
+	 *	Points the next attributes at the buffer bound to GL_ARRAY_BUFFER
+	 */
+	void AddAttributes(const VertexBufferElement* elements, unsigned int count, unsigned int stride, unsigned int divisor);
+
+	/**
+	 *	Adds the elements as the next attributes, reading from a buffer binding point rather than a buffer,
+	 *	so the buffer can be changed later with BindVertexBuffer. Needs IsFormatSupported.
+	 */
+	void AddFormat(unsigned int binding, const VertexBufferElement* elements, unsigned int count, unsigned int divisor);
+
+	/**
+	 *	Attaches a buffer to a binding point set up by AddFormat
+	 */
+	void BindVertexBuffer(unsigned int binding, unsigned int buffer, unsigned int stride);
+
+	// Sets up its vertex arrays through the private functions above
+	friend class VertexArrayCache;
+
 };
@@ -0,0 +1,214 @@
+#include "VertexArrayCache.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "Renderer.h"
+#include "IndexBuffer.h"
+#include "GLState.h"
+
+// FNV-1a, the keys are a handful of small integers
+static void HashValue(unsigned long long& hash, unsigned int value)
+{
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		hash ^= (value >> (i * 8)) & 0xFF;
+		hash *= 1099511628211ULL;
+	}
+}
+
+VertexArrayCache::VertexArrayCache()
+	: m_SeparateFormat(VertexArray::IsFormatSupported()), m_BufferGeneration(GLState::GetBufferGeneration())
+{
+}
+
+const VertexArray & VertexArrayCache::Bind(const VertexStream * streams, unsigned int streamCount, const IndexBuffer * ib)
+{
+	if (m_BufferGeneration != GLState::GetBufferGeneration())
+	{
+		ForgetDeletedBuffers();
+	}
+
+	size_t hash = Hash(streams, streamCount, ib);
+
+	Entry* entry = nullptr;
+	auto range = m_Entries.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (Matches(it->second, streams, streamCount, ib))
+		{
+			entry = &it->second;
+			break;
+		}
+	}
+
+	if (entry)
+	{
+		m_Stats.Hits++;
+	}
+	else
+	{
+		m_Stats.Misses++;
+		entry = &Create(hash, streams, streamCount, ib);
+	}
+
+	entry->Array.Bind();
+	if (m_SeparateFormat)
+	{
+		for (unsigned int i = 0; i < streamCount; i++)
+		{
+			unsigned int buffer = streams[i].Buffer->GetRendererID();
+			if (entry->Streams[i].Buffer != buffer)
+			{
+				entry->Array.BindVertexBuffer(i, buffer, streams[i].Stride);
+				entry->Streams[i].Buffer = buffer;
+				m_Stats.BufferBinds++;
+			}
+		}
+	}
+	// Remembered per vertex array by GLState, so this only reaches GL when the index buffer changed
+	if (ib)
+	{
+		ib->Bind();
+	}
+	return entry->Array;
+}
+
+const VertexArray & VertexArrayCache::Bind(const VertexBuffer & vb, const VertexBufferLayout & layout, const IndexBuffer * ib)
+{
+	VertexStream stream(vb, layout);
+	return Bind(&stream, 1, ib);
+}
+
+void VertexArrayCache::Clear()
+{
+	m_Entries.clear();
+}
+
+void VertexArrayCache::ForgetDeletedBuffers()
+{
+	m_DeletedScratch.clear();
+	bool known = GLState::GetDeletedBuffers(m_BufferGeneration, m_DeletedScratch);
+	m_BufferGeneration = GLState::GetBufferGeneration();
+	std::sort(m_DeletedScratch.begin(), m_DeletedScratch.end());
+	// Some remembered names may now belong to a different buffer, or when too many were deleted any of them
+	auto deleted = [this, known](unsigned int buffer)
+	{
+		return !known || std::binary_search(m_DeletedScratch.begin(), m_DeletedScratch.end(), buffer);
+	};
+
+	for (auto it = m_Entries.begin(); it != m_Entries.end();)
+	{
+		Entry& entry = it->second;
+		if (m_SeparateFormat)
+		{
+			// Only the attachments refer to buffers, Bind attaches them again
+			for (StreamKey& stream : entry.Streams)
+			{
+				if (stream.Buffer && deleted(stream.Buffer))
+				{
+					stream.Buffer = 0;
+				}
+			}
+			++it;
+			continue;
+		}
+
+		bool stale = entry.IndexBufferID && deleted(entry.IndexBufferID);
+		for (const StreamKey& stream : entry.Streams)
+		{
+			stale = stale || deleted(stream.Buffer);
+		}
+		it = stale ? m_Entries.erase(it) : std::next(it);
+	}
+}
+
+size_t VertexArrayCache::Hash(const VertexStream * streams, unsigned int streamCount, const IndexBuffer * ib) const
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for (unsigned int i = 0; i < streamCount; i++)
+	{
+		const VertexStream& stream = streams[i];
+		HashValue(hash, stream.ElementCount);
+		HashValue(hash, stream.Stride);
+		HashValue(hash, stream.Divisor);
+		for (unsigned int e = 0; e < stream.ElementCount; e++)
+		{
+			const VertexBufferElement& element = stream.Elements[e];
+			HashValue(hash, element.type);
+			HashValue(hash, element.count | element.normalized << 16);
+			HashValue(hash, element.offset);
+		}
+		if (!m_SeparateFormat)
+		{
+			HashValue(hash, stream.Buffer->GetRendererID());
+		}
+	}
+	if (!m_SeparateFormat)
+	{
+		HashValue(hash, ib ? ib->GetRendererID() : 0);
+	}
+	return (size_t)hash;
+}
+
+bool VertexArrayCache::Matches(const Entry & entry, const VertexStream * streams, unsigned int streamCount, const IndexBuffer * ib) const
+{
+	if (entry.Streams.size() != streamCount)
+	{
+		return false;
+	}
+	if (!m_SeparateFormat && entry.IndexBufferID != (ib ? ib->GetRendererID() : 0))
+	{
+		return false;
+	}
+
+	unsigned int first = 0;
+	for (unsigned int i = 0; i < streamCount; i++)
+	{
+		const VertexStream& stream = streams[i];
+		const StreamKey& key = entry.Streams[i];
+		if (key.ElementCount != stream.ElementCount || key.Stride != stream.Stride || key.Divisor != stream.Divisor)
+		{
+			return false;
+		}
+		if (!m_SeparateFormat && key.Buffer != stream.Buffer->GetRendererID())
+		{
+			return false;
+		}
+		for (unsigned int e = 0; e < stream.ElementCount; e++)
+		{
+			const VertexBufferElement& a = entry.Elements[first + e];
+			const VertexBufferElement& b = stream.Elements[e];
+			if (a.type != b.type || a.count != b.count || a.normalized != b.normalized || a.offset != b.offset)
+			{
+				return false;
+			}
+		}
+		first += stream.ElementCount;
+	}
+	return true;
+}
+
+VertexArrayCache::Entry & VertexArrayCache::Create(size_t hash, const VertexStream * streams, unsigned int streamCount, const IndexBuffer * ib)
+{
+	Entry entry;
+	entry.IndexBufferID = ib ? ib->GetRendererID() : 0;
+	for (unsigned int i = 0; i < streamCount; i++)
+	{
+		const VertexStream& stream = streams[i];
+		entry.Elements.insert(entry.Elements.end(), stream.Elements, stream.Elements + stream.ElementCount);
+
+		if (m_SeparateFormat)
+		{
+			// The buffer is attached by Bind
+			entry.Array.AddFormat(i, stream.Elements, stream.ElementCount, stream.Divisor);
+			entry.Streams.push_back({ stream.ElementCount, stream.Stride, stream.Divisor, 0 });
+		}
+		else
+		{
+			entry.Array.AddElements(*stream.Buffer, stream.Elements, stream.ElementCount, stream.Stride, stream.Divisor);
+			entry.Streams.push_back({ stream.ElementCount, stream.Stride, stream.Divisor, stream.Buffer->GetRendererID() });
+		}
+	}
+	return m_Entries.emplace(hash, std::move(entry))->second;
+}
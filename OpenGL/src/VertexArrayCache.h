@@ -0,0 +1,159 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "VertexArray.h"
+#include "VertexBufferLayout.h"
+
+class IndexBuffer;
+
+/**
+ *	One vertex buffer and the layout of its vertices, as read by a vertex array
+ */
+struct VertexStream
+{
+	const VertexBuffer* Buffer;
+	const VertexBufferElement* Elements;
+	unsigned int ElementCount;
+	unsigned int Stride;
+	unsigned int Divisor;
+
+	VertexStream(const VertexBuffer& vb, const VertexBufferLayout& layout)
+		: Buffer(&vb), Elements(layout.GetElements().data()), ElementCount((unsigned int)layout.GetElements().size()),
+		Stride(layout.GetStride()), Divisor(layout.GetDivisor())
+	{
+	}
+
+	/**
+	 *	A stream with a StaticVertexLayout
+	 */
+	template<typename Layout>
+	static VertexStream FromLayout(const VertexBuffer& vb, unsigned int divisor = 0)
+	{
+		return VertexStream(vb, Layout::Elements, Layout::ElementCount, Layout::Stride, divisor);
+	}
+
+private:
+	VertexStream(const VertexBuffer& vb, const VertexBufferElement* elements, unsigned int elementCount, unsigned int stride, unsigned int divisor)
+		: Buffer(&vb), Elements(elements), ElementCount(elementCount), Stride(stride), Divisor(divisor)
+	{
+	}
+};
+
+/**
+ *	Hands out vertex arrays for sets of vertex buffers and layouts, so meshes loaded at run time do not
+ *	each need a VertexArray set up by hand, and meshes with the same inputs share one.
+ *
+ *	With GL 4.3 or ARB_vertex_attrib_binding a vertex array only stores the attribute formats, and the
+ *	buffers are attached when it is bound. One vertex array then serves every mesh with the same layouts,
+ *	and switching meshes only rebinds the buffers that changed. Otherwise a vertex array is made for each
+ *	set of buffers, layouts and index buffer.
+ *
+ *	Entries refer to buffers by GL name. A name recycled by GLNamePool keeps its GL object, so it still
+ *	matches a vertex array set up for it, but once a buffer is deleted GL may reuse its name for a new
+ *	object: then the entries referring to that name attach their buffer again, or without separate
+ *	formats are dropped. The rest are kept.
+ */
+class VertexArrayCache
+{
+public:
+	/**
+	 *	Counters for the work done since the last ResetStats
+	 */
+	struct Stats
+	{
+		// Bind calls that found a matching vertex array
+		unsigned int Hits = 0;
+		// Bind calls that had to make a new vertex array
+		unsigned int Misses = 0;
+		// Buffers attached to a binding point, only with separate attribute formats
+		unsigned int BufferBinds = 0;
+	};
+
+	VertexArrayCache();
+
+	VertexArrayCache(const VertexArrayCache&) = delete;
+	VertexArrayCache& operator=(const VertexArrayCache&) = delete;
+
+	/**
+	 *	Binds a vertex array that reads the streams, making it on first use
+	 *	@param streams The vertex buffers and their layouts, attributes are numbered in stream order
+	 *	@param ib The index buffer to bind with it, or null
+	 *	@return the bound vertex array, valid until Clear or until one of its buffers is deleted
+	 */
+	const VertexArray& Bind(const VertexStream* streams, unsigned int streamCount, const IndexBuffer* ib = nullptr);
+
+	/**
+	 *	Binds a vertex array that reads one vertex buffer
+	 */
+	const VertexArray& Bind(const VertexBuffer& vb, const VertexBufferLayout& layout, const IndexBuffer* ib = nullptr);
+
+	/**
+	 *	Deletes every vertex array
+	 */
+	void Clear();
+
+	/**
+	 *	@return true if vertex arrays are shared by every mesh with the same layouts
+	 */
+	inline bool IsSeparateFormat() const
+	{
+		return m_SeparateFormat;
+	}
+
+	/**
+	 *	@return the number of vertex arrays made
+	 */
+	inline unsigned int GetCount() const
+	{
+		return (unsigned int)m_Entries.size();
+	}
+
+	inline const Stats& GetStats() const
+	{
+		return m_Stats;
+	}
+
+	inline void ResetStats()
+	{
+		m_Stats = Stats();
+	}
+
+private:
+	struct StreamKey
+	{
+		unsigned int ElementCount;
+		unsigned int Stride;
+		unsigned int Divisor;
+		// The buffer read, with separate formats the one currently attached rather than part of the key
+		unsigned int Buffer;
+	};
+
+	struct Entry
+	{
+		VertexArray Array;
+		// The elements of every stream one after another
+		std::vector<VertexBufferElement> Elements;
+		std::vector<StreamKey> Streams;
+		// Not part of the key with separate formats
+		unsigned int IndexBufferID;
+	};
+
+	bool m_SeparateFormat;
+	// GLState::GetBufferGeneration when the entries were last known to refer to live buffers
+	unsigned int m_BufferGeneration;
+	std::unordered_multimap<size_t, Entry> m_Entries;
+	Stats m_Stats;
+	// Reused by ForgetDeletedBuffers
+	std::vector<unsigned int> m_DeletedScratch;
+
+	size_t Hash(const VertexStream* streams, unsigned int streamCount, const IndexBuffer* ib) const;
+	bool Matches(const Entry& entry, const VertexStream* streams, unsigned int streamCount, const IndexBuffer* ib) const;
+	Entry& Create(size_t hash, const VertexStream* streams, unsigned int streamCount, const IndexBuffer* ib);
+
+	/**
+	 *	Detaches or drops what refers to buffers deleted since m_BufferGeneration
+	 */
+	void ForgetDeletedBuffers();
+};
@@ -1,29 +1,168 @@
 #include "VertexBuffer.h"
 
+#include <cstring>
+
 #include "Renderer.h"
+#include "GLState.h"
+#include "BufferArena.h"
+#include "GLNamePool.h"
 #include <GL/glew.h>
 
-VertexBuffer::VertexBuffer(const void * data, unsigned int size)
+VertexBuffer::VertexBuffer(const void * data, unsigned int size, BufferUsage usage)
+	: m_Arena(nullptr), m_Allocation(0), m_Stride(1), m_Size(size), m_Usage(usage), m_ShadowComplete(false)
 {
-	// Generate a number (1) of buffers and bind their ID
-	GLCall(glGenBuffers(1, &m_RendererID));
-	// Bind this buffer, allowing us to draw on it
-	GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
-	// Initialize the buffer and pass it data
-	GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+	Create(data, size);
+}
+
+VertexBuffer::VertexBuffer(unsigned int size, BufferUsage usage)
+	: m_Arena(nullptr), m_Allocation(0), m_Stride(1), m_Size(size), m_Usage(usage), m_ShadowComplete(true)
+{
+	// Allocate the storage without any data, so there is nothing a CPU copy could miss
+	Create(nullptr, size);
+}
+
+VertexBuffer::VertexBuffer(BufferArena & arena, const void * data, unsigned int size, unsigned int stride)
+	: m_RendererID(arena.GetRendererID()), m_Arena(&arena), m_Stride(stride), m_Size(size), m_Usage(BufferUsage::Static),
+	m_ShadowComplete(false)
+{
+	m_Allocation = arena.Allocate(size, stride, data);
+	ASSERT(m_Allocation != BufferArena::InvalidAllocation);
 }
 
 VertexBuffer::~VertexBuffer()
 {
-	GLCall(glDeleteBuffers(1, &m_RendererID));
+	Release();
+}
+
+VertexBuffer::VertexBuffer(VertexBuffer && other) noexcept
+	: m_RendererID(other.m_RendererID), m_Arena(other.m_Arena), m_Allocation(other.m_Allocation), m_Stride(other.m_Stride),
+	m_Size(other.m_Size), m_Usage(other.m_Usage), m_Shadow(std::move(other.m_Shadow)), m_Dirty(std::move(other.m_Dirty)),
+	m_ShadowComplete(other.m_ShadowComplete)
+{
+	other.m_RendererID = 0;
+	other.m_Arena = nullptr;
+}
+
+VertexBuffer & VertexBuffer::operator=(VertexBuffer && other) noexcept
+{
+	if (this != &other)
+	{
+		Release();
+		m_RendererID = other.m_RendererID;
+		m_Arena = other.m_Arena;
+		m_Allocation = other.m_Allocation;
+		m_Stride = other.m_Stride;
+		m_Size = other.m_Size;
+		m_Usage = other.m_Usage;
+		m_Shadow = std::move(other.m_Shadow);
+		m_Dirty = std::move(other.m_Dirty);
+		m_ShadowComplete = other.m_ShadowComplete;
+		other.m_RendererID = 0;
+		other.m_Arena = nullptr;
+	}
+	return *this;
 }
 
 void VertexBuffer::Bind() const
 {
-	GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+	GLState::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 }
 
 void VertexBuffer::UnBind() const
 {
-	GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+	GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void VertexBuffer::SetData(const void * data, unsigned int size)
+{
+	if (m_Arena)
+	{
+		m_Arena->SetData(m_Allocation, data, size);
+		return;
+	}
+
+	m_Dirty.Clear();
+	// A CPU copy is only kept up to date once SetSubData has needed one
+	m_ShadowComplete = !m_Shadow.empty();
+	if (m_ShadowComplete)
+	{
+		m_Shadow.assign((const unsigned char*)data, (const unsigned char*)data + size);
+	}
+
+	Bind();
+	if (m_Usage == BufferUsage::Static && size == m_Size)
+	{
+		GLCall(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+	}
+	else
+	{
+		// New storage, the old one is released once the GPU is done with it
+		GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GetGLUsage(m_Usage)));
+		m_Size = size;
+	}
+}
+
+void VertexBuffer::SetSubData(const void * data, unsigned int size, unsigned int offset)
+{
+	ASSERT(offset + size <= m_Size);
+
+	if (m_Arena)
+	{
+		m_Arena->SetData(m_Allocation, data, size, offset);
+		return;
+	}
+
+	if (m_Usage == BufferUsage::Static)
+	{
+		Bind();
+		GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+		return;
+	}
+
+	// The CPU copy is made on first use
+	if (m_Shadow.size() != m_Size)
+	{
+		m_Shadow.resize(m_Size);
+	}
+	std::memcpy(m_Shadow.data() + offset, data, size);
+	m_Dirty.Add(offset, size);
+}
+
+unsigned int VertexBuffer::Flush()
+{
+	if (m_Dirty.IsEmpty())
+	{
+		return 0;
+	}
+	Bind();
+	return m_Dirty.Upload(GL_ARRAY_BUFFER, m_Shadow.data(), m_Size, GetGLUsage(m_Usage), m_ShadowComplete);
+}
+
+unsigned int VertexBuffer::GetOffset() const
+{
+	return m_Arena ? m_Arena->GetOffset(m_Allocation) : 0;
+}
+
+void VertexBuffer::Create(const void * data, unsigned int size)
+{
+	// Take a buffer name from the pool and bind it
+	m_RendererID = GLNamePool::GenBuffer();
+	// Bind this buffer, allowing us to draw on it
+	GLState::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+	// Initialize the buffer and pass it data
+	GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GetGLUsage(m_Usage)));
+}
+
+void VertexBuffer::Release()
+{
+	if (m_Arena)
+	{
+		m_Arena->Free(m_Allocation);
+	}
+	else if (m_RendererID)
+	{
+		GLNamePool::ReleaseBuffer(m_RendererID);
+	}
+	m_RendererID = 0;
+	m_Arena = nullptr;
 }
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <vector>
+
+#include "BufferUsage.h"
+#include "DirtyRanges.h"
+
+class BufferArena;
+
 class VertexBuffer
 {
 
@@ -8,14 +15,40 @@ public:
 	 *	Construct a Vertex Buffer
 	 *  @param data An array containing the vertex positions used in this buffer
 	 *  @param size The size in bytes of the data
+	 *  @param usage How often the data will change. Dynamic and Stream buffers make a CPU copy on their first SetSubData.
+	 */
+	VertexBuffer(const void* data, unsigned int size, BufferUsage usage = BufferUsage::Static);
+
+	/**
+	 *	Construct an empty Vertex Buffer whose contents will be updated later
+	 *  @param size The size in bytes to reserve for the buffer
+	 *  @param usage How often the data will change, Dynamic is the GL_DYNAMIC_DRAW hint these buffers always had
+	 */
+	VertexBuffer(unsigned int size, BufferUsage usage = BufferUsage::Dynamic);
+
+	/**
+	 *	Construct a Vertex Buffer that is a view into part of a BufferArena, sharing its GL buffer
+	 *  @param arena The arena to allocate from, must outlive this buffer
+	 *  @param data An array containing the vertex positions used in this buffer
+	 *  @param size The size in bytes of the data
+	 *  @param stride The size in bytes of one vertex, the data is placed at a multiple of it
 	 */
-	VertexBuffer(const void* data, unsigned int size);
+	VertexBuffer(BufferArena& arena, const void* data, unsigned int size, unsigned int stride);
 
 	/**
-	 * Instruct OpenGL to delete this buffer
+	 * Instruct OpenGL to delete this buffer, or give the space back to the arena for a view
 	 */
 	~VertexBuffer();
 
+	VertexBuffer(const VertexBuffer&) = delete;
+	VertexBuffer& operator=(const VertexBuffer&) = delete;
+
+	/**
+	 * Moves the GL object to a new owner, leaving other empty
+	 */
+	VertexBuffer(VertexBuffer&& other) noexcept;
+	VertexBuffer& operator=(VertexBuffer&& other) noexcept;
+
 	/**
 	 *	Bind this buffer, allowing it to be drawn
 	 */
@@ -26,6 +59,64 @@ public:
 	 */
 	void UnBind() const;
 
+	/**
+	 *	Replace the whole contents of this buffer, resizing it if needed.
+	 *	Dynamic and Stream buffers are orphaned, so the upload does not wait for draws still using the old data.
+	 *	Writes from SetSubData that were not flushed yet are dropped.
+	 *  @param data The vertex data to upload
+	 *  @param size The size in bytes of the data, for views it must not exceed the view's size
+	 */
+	void SetData(const void* data, unsigned int size);
+
+	/**
+	 *	Replace part of this buffer.
+	 *	For Dynamic and Stream buffers the write only goes to the CPU copy, and Flush uploads all writes
+	 *	since the last Flush together. Static buffers and views are updated straight away.
+	 *	The CPU copy is made by the first call, so buffers only ever replaced with SetData need none.
+	 *  @param data The vertex data to upload
+	 *  @param size The size in bytes of the data
+	 *  @param offset Where the data goes, in bytes from the start of the buffer
+	 */
+	void SetSubData(const void* data, unsigned int size, unsigned int offset);
+
+	/**
+	 *	Uploads the writes of SetSubData, merging nearby ones. Call once per frame before drawing.
+	 *	@return the number of bytes uploaded
+	 */
+	unsigned int Flush();
+
+	inline unsigned int GetSize() const
+	{
+		return m_Size;
+	}
+
+	inline BufferUsage GetUsage() const
+	{
+		return m_Usage;
+	}
+
+	/**
+	 * @return the GL buffer, shared with other views of the same arena
+	 */
+	inline unsigned int GetRendererID() const
+	{
+		return m_RendererID;
+	}
+
+	/**
+	 * @return the offset in bytes of this buffer's data in the GL buffer, only non zero for views
+	 */
+	unsigned int GetOffset() const;
+
+	/**
+	 * @return the base vertex that draws this view's vertices when the vertex array's attributes
+	 * start at the beginning of the arena
+	 */
+	inline unsigned int GetBaseVertex() const
+	{
+		return GetOffset() / m_Stride;
+	}
+
 protected:
 
 private:
@@ -34,4 +125,37 @@ private:
 	 */
 	unsigned int m_RendererID;
 
+	/**
+	 *	The arena and allocation this is a view of, null for buffers that own their GL buffer
+	 */
+	BufferArena* m_Arena;
+	unsigned int m_Allocation;
+
+	unsigned int m_Stride;
+
+	unsigned int m_Size;
+	BufferUsage m_Usage;
+
+	/**
+	 *	CPU copy of the contents of Dynamic and Stream buffers, made by the first SetSubData, which writes here
+	 */
+	std::vector<unsigned char> m_Shadow;
+	DirtyRanges m_Dirty;
+
+	/**
+	 *	True when m_Shadow, once made, holds every byte of the buffer. Contents uploaded before it was made
+	 *	are not in it, so until the next SetData, Flush only uploads the written ranges and never orphans.
+	 */
+	bool m_ShadowComplete;
+
+	/**
+	 *	Creates the GL buffer
+	 */
+	void Create(const void* data, unsigned int size);
+
+	/**
+	 *	Gives the GL buffer back to the pool, or the space back to the arena for a view
+	 */
+	void Release();
+
 };
\ No newline at end of file
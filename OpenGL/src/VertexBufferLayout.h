@@ -2,14 +2,17 @@
 #include <vector>
 #include <GL/glew.h>
 #include "Renderer.h"
+#include "VertexTypes.h"
 
 struct VertexBufferElement
 {
 	unsigned int type;
 	unsigned int count;
 	unsigned char normalized;
+	// Bytes from the start of a vertex to this element
+	unsigned int offset;
 
-	static unsigned int GetSizeOfType(unsigned int type)
+	static constexpr unsigned int GetSizeOfType(unsigned int type)
 	{
 		switch(type)
 		{
@@ -18,11 +21,34 @@ struct VertexBufferElement
 			case GL_UNSIGNED_INT: return sizeof(GLuint);
 
 			case GL_UNSIGNED_BYTE: return sizeof(GLbyte);
+
+			case GL_BYTE: return sizeof(GLbyte);
+
+			case GL_SHORT: return sizeof(GLshort);
+
+			case GL_UNSIGNED_SHORT: return sizeof(GLushort);
+
+			case GL_HALF_FLOAT: return sizeof(GLhalf);
+
+			// All four components share one value
+			case GL_INT_2_10_10_10_REV: return sizeof(GLuint);
 		}
 		// We don't support the type
 		ASSERT(false);
 		return 0;
 	}
+
+	/**
+	 * @return the size in bytes of this element in one vertex
+	 */
+	inline constexpr unsigned int GetSize() const
+	{
+		if (type == GL_INT_2_10_10_10_REV)
+		{
+			return GetSizeOfType(type);
+		}
+		return count * GetSizeOfType(type);
+	}
 };
 
 /**
@@ -38,51 +64,57 @@ public:
 	 *
 	 */
 	VertexBufferLayout()
-		: m_Stride(0) {};
+		: m_Stride(0), m_Divisor(0) {};
 
+	/**
+	 * Adds an element of type T to m_Elements, placed after the elements already added.
+	 * Increments m_Stride. Only the types specialised below this class are supported.
+	 */
 	template<typename T>
 	void Push(unsigned int count)
 	{
-		static_assert(false);
+		static_assert(sizeof(T) == 0, "VertexBufferLayout::Push does not support this type");
 	}
 
 	/**
-	 * Adds an element of type float to m_elements
+	 * Adds a copy of an element of another layout, placed after the elements already added
 	 * Increments m_Stride.
 	 */
-	template<>
-	void Push<float>(unsigned int count)
+	void PushElement(const VertexBufferElement& element)
 	{
-		m_Elements.push_back({ GL_FLOAT, count, GL_FALSE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+		m_Elements.push_back({ element.type, element.count, element.normalized, m_Stride });
+		m_Stride += element.GetSize();
 	}
 
 	/**
-	 * Adds an element of type unsigned int to m_elements
-	 * Increments m_Stride.
+	 * Adds a copy of an element at a given offset into each vertex, for vertices laid out by someone
+	 * else (e.g. a glTF accessor into an interleaved buffer view). m_Stride is left alone, see SetStride.
 	 */
-	template<>
-	void Push<unsigned int>(unsigned int count)
+	void PushElement(const VertexBufferElement& element, unsigned int offset)
 	{
-		m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
+		m_Elements.push_back({ element.type, element.count, element.normalized, offset });
 	}
 
 	/**
-	 * Adds an element of char float to m_elements
-	 * Increments m_Stride.
+	 * Sets the bytes from the start of one vertex to the next, for elements placed with PushElement(element, offset)
 	 */
-	template<>
-	void Push<unsigned char>(unsigned int count)
+	inline void SetStride(unsigned int stride)
 	{
-		m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+		m_Stride = stride;
+	}
+
+	/**
+	 * Pads m_Stride to a multiple of alignment, GPUs fetch vertices with 4 byte aligned strides faster
+	 */
+	inline void AlignStride(unsigned int alignment)
+	{
+		m_Stride = (m_Stride + alignment - 1) / alignment * alignment;
 	}
 
 	/**
 	 * returns elements vector
 	 */
-	inline std::vector<VertexBufferElement> GetElements() const
+	inline const std::vector<VertexBufferElement>& GetElements() const
 	{
 		return m_Elements;
 	}
@@ -95,9 +127,108 @@ public:
 		return m_Stride;
 	}
 
+	/**
+	 * Marks the buffer using this layout as per-instance data.
+	 * @param divisor Number of instances drawn before advancing to the next element, 0 means per-vertex
+	 */
+	inline void SetDivisor(unsigned int divisor)
+	{
+		m_Divisor = divisor;
+	}
+
+	/**
+	 * returns the attribute divisor, 0 for per-vertex data
+	 */
+	inline unsigned int GetDivisor() const
+	{
+		return m_Divisor;
+	}
+
 private:
 	std::vector<VertexBufferElement> m_Elements;
 
 	// Amount of bytes from the beginning of one element to the start of the next element
 	unsigned int m_Stride;
-};
\ No newline at end of file
+
+	// How many instances share one element, 0 means the buffer is read per vertex
+	unsigned int m_Divisor;
+};
+
+/**
+ * Adds an element of type float to m_elements
+ * Increments m_Stride.
+ */
+template<>
+inline void VertexBufferLayout::Push<float>(unsigned int count)
+{
+	m_Elements.push_back({ GL_FLOAT, count, GL_FALSE, m_Stride });
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+}
+
+/**
+ * Adds an element of type unsigned int to m_elements
+ * Increments m_Stride.
+ */
+template<>
+inline void VertexBufferLayout::Push<unsigned int>(unsigned int count)
+{
+	m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE, m_Stride });
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
+}
+
+/**
+ * Adds an element of char float to m_elements
+ * Increments m_Stride.
+ */
+template<>
+inline void VertexBufferLayout::Push<unsigned char>(unsigned int count)
+{
+	m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE, m_Stride });
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+}
+
+/**
+ * Adds an element of type short to m_elements, read as a float from -1 to 1
+ * Increments m_Stride.
+ */
+template<>
+inline void VertexBufferLayout::Push<short>(unsigned int count)
+{
+	m_Elements.push_back({ GL_SHORT, count, GL_TRUE, m_Stride });
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_SHORT);
+}
+
+/**
+ * Adds an element of type unsigned short to m_elements, read as a float from 0 to 1
+ * Increments m_Stride.
+ */
+template<>
+inline void VertexBufferLayout::Push<unsigned short>(unsigned int count)
+{
+	m_Elements.push_back({ GL_UNSIGNED_SHORT, count, GL_TRUE, m_Stride });
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_SHORT);
+}
+
+/**
+ * Adds an element of type half float to m_elements
+ * Increments m_Stride.
+ */
+template<>
+inline void VertexBufferLayout::Push<Half>(unsigned int count)
+{
+	m_Elements.push_back({ GL_HALF_FLOAT, count, GL_FALSE, m_Stride });
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_HALF_FLOAT);
+}
+
+/**
+ * Adds a GL_INT_2_10_10_10_REV element to m_elements, read as four floats from -1 to 1
+ * Increments m_Stride by 4 bytes for the whole element.
+ * @param count Must be 4, the w component only has -1, 0 and 1
+ */
+template<>
+inline void VertexBufferLayout::Push<Packed2101010>(unsigned int count)
+{
+	ASSERT(count == 4);
+	m_Elements.push_back({ GL_INT_2_10_10_10_REV, count, GL_TRUE, m_Stride });
+	m_Stride += VertexBufferElement::GetSizeOfType(GL_INT_2_10_10_10_REV);
+}
@@ -0,0 +1,314 @@
+#include "VertexQuantizer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "Renderer.h"
+#include "VertexBufferLayout.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define VERTEX_QUANTIZER_SSE2
+#include <emmintrin.h>
+#endif
+
+// Vertices converted per step of Quantize, so the temporary arrays stay in cache
+static const unsigned int s_ChunkVertices = 256;
+
+static unsigned int FloatBits(float value)
+{
+	unsigned int bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+static float BitsFloat(unsigned int bits)
+{
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/**
+ *	Float to half with round to nearest even. Subnormal halves are made by adding a float whose
+ *	exponent lines the mantissa up, so the float unit does the rounding.
+ */
+static unsigned short HalfBits(float value)
+{
+	unsigned int bits = FloatBits(value);
+	unsigned int sign = bits & 0x80000000;
+	bits ^= sign;
+
+	unsigned int half;
+	if (bits >= (143 << 23))
+	{
+		// Too large, or infinity or NaN
+		half = bits > 0x7F800000 ? 0x7E00 : 0x7C00;
+	}
+	else if (bits < (113 << 23))
+	{
+		half = FloatBits(BitsFloat(bits) + BitsFloat(126 << 23)) - (126 << 23);
+	}
+	else
+	{
+		unsigned int odd = (bits >> 13) & 1;
+		half = (bits + ((unsigned int)(15 - 127) << 23) + 0xFFF + odd) >> 13;
+	}
+	return (unsigned short)(half | (sign >> 16));
+}
+
+/**
+ *	Clamps to min..1, scales and rounds half away from zero
+ */
+static int Normalise(float value, float min, float scale)
+{
+	// Written so NaN becomes min, as with _mm_max_ps
+	value = value > min ? value : min;
+	value = value < 1.0f ? value : 1.0f;
+	value *= scale;
+	return (int)(value + (value < 0.0f ? -0.5f : 0.5f));
+}
+
+static unsigned int Pack2101010(int x, int y, int z, int w)
+{
+	return (x & 0x3FF) | (y & 0x3FF) << 10 | (z & 0x3FF) << 20 | (unsigned int)(w & 0x3) << 30;
+}
+
+#ifdef VERTEX_QUANTIZER_SSE2
+
+static __m128i Select(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/**
+ *	HalfBits for four floats, each result in the low 16 bits of its lane
+ */
+static __m128i HalfBits4(__m128 value)
+{
+	__m128i bits = _mm_castps_si128(value);
+	__m128i sign = _mm_and_si128(bits, _mm_set1_epi32((int)0x80000000));
+	bits = _mm_xor_si128(bits, sign);
+
+	__m128i odd = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+	__m128i normal = _mm_add_epi32(bits, _mm_set1_epi32((int)((unsigned int)(15 - 127) << 23) + 0xFFF));
+	normal = _mm_srli_epi32(_mm_add_epi32(normal, odd), 13);
+
+	__m128i magic = _mm_set1_epi32(126 << 23);
+	__m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(bits), _mm_castsi128_ps(magic))), magic);
+
+	__m128i isNan = _mm_cmpgt_epi32(bits, _mm_set1_epi32(0x7F800000));
+	__m128i special = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(isNan, _mm_set1_epi32(0x200)));
+
+	__m128i half = Select(_mm_cmplt_epi32(bits, _mm_set1_epi32(113 << 23)), subnormal, normal);
+	half = Select(_mm_cmpgt_epi32(bits, _mm_set1_epi32((143 << 23) - 1)), special, half);
+	return _mm_or_si128(half, _mm_srli_epi32(sign, 16));
+}
+
+/**
+ *	Normalise for four floats
+ */
+static __m128i Normalise4(__m128 value, __m128 min, __m128 scale)
+{
+	value = _mm_min_ps(_mm_max_ps(value, min), _mm_set1_ps(1.0f));
+	value = _mm_mul_ps(value, scale);
+	__m128 half = _mm_or_ps(_mm_set1_ps(0.5f), _mm_and_ps(value, _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000))));
+	return _mm_cvttps_epi32(_mm_add_ps(value, half));
+}
+
+/**
+ *	Packs eight values that fit in 16 bits, signed or not, keeping their low 16 bits
+ */
+static __m128i Pack16(__m128i low, __m128i high)
+{
+	low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+	high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+	return _mm_packs_epi32(low, high);
+}
+
+#endif
+
+void VertexQuantizer::ToHalf(Half * destination, const float * source, unsigned int count)
+{
+	unsigned int i = 0;
+#ifdef VERTEX_QUANTIZER_SSE2
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i low = HalfBits4(_mm_loadu_ps(source + i));
+		__m128i high = HalfBits4(_mm_loadu_ps(source + i + 4));
+		_mm_storeu_si128((__m128i*)(destination + i), Pack16(low, high));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		destination[i].Bits = HalfBits(source[i]);
+	}
+}
+
+void VertexQuantizer::ToSnorm16(short * destination, const float * source, unsigned int count)
+{
+	unsigned int i = 0;
+#ifdef VERTEX_QUANTIZER_SSE2
+	__m128 min = _mm_set1_ps(-1.0f);
+	__m128 scale = _mm_set1_ps(32767.0f);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i low = Normalise4(_mm_loadu_ps(source + i), min, scale);
+		__m128i high = Normalise4(_mm_loadu_ps(source + i + 4), min, scale);
+		_mm_storeu_si128((__m128i*)(destination + i), _mm_packs_epi32(low, high));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		destination[i] = (short)Normalise(source[i], -1.0f, 32767.0f);
+	}
+}
+
+void VertexQuantizer::ToUnorm16(unsigned short * destination, const float * source, unsigned int count)
+{
+	unsigned int i = 0;
+#ifdef VERTEX_QUANTIZER_SSE2
+	__m128 min = _mm_setzero_ps();
+	__m128 scale = _mm_set1_ps(65535.0f);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i low = Normalise4(_mm_loadu_ps(source + i), min, scale);
+		__m128i high = Normalise4(_mm_loadu_ps(source + i + 4), min, scale);
+		_mm_storeu_si128((__m128i*)(destination + i), Pack16(low, high));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		destination[i] = (unsigned short)Normalise(source[i], 0.0f, 65535.0f);
+	}
+}
+
+void VertexQuantizer::ToUnorm8(unsigned char * destination, const float * source, unsigned int count)
+{
+	unsigned int i = 0;
+#ifdef VERTEX_QUANTIZER_SSE2
+	__m128 min = _mm_setzero_ps();
+	__m128 scale = _mm_set1_ps(255.0f);
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i a = Normalise4(_mm_loadu_ps(source + i), min, scale);
+		__m128i b = Normalise4(_mm_loadu_ps(source + i + 4), min, scale);
+		__m128i c = Normalise4(_mm_loadu_ps(source + i + 8), min, scale);
+		__m128i d = Normalise4(_mm_loadu_ps(source + i + 12), min, scale);
+		__m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+		_mm_storeu_si128((__m128i*)(destination + i), packed);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		destination[i] = (unsigned char)Normalise(source[i], 0.0f, 255.0f);
+	}
+}
+
+void VertexQuantizer::ToPacked2101010(Packed2101010 * destination, const float * source, unsigned int count, unsigned int components)
+{
+	ASSERT(components == 3 || components == 4);
+
+#ifdef VERTEX_QUANTIZER_SSE2
+	__m128 min = _mm_set1_ps(-1.0f);
+	__m128 scale = _mm_setr_ps(511.0f, 511.0f, 511.0f, 1.0f);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const float* vector = source + i * components;
+		__m128 value = components == 4 ? _mm_loadu_ps(vector) : _mm_setr_ps(vector[0], vector[1], vector[2], 0.0f);
+		int packed[4];
+		_mm_storeu_si128((__m128i*)packed, Normalise4(value, min, scale));
+		destination[i].Bits = Pack2101010(packed[0], packed[1], packed[2], packed[3]);
+	}
+#else
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const float* vector = source + i * components;
+		int w = components == 4 ? Normalise(vector[3], -1.0f, 1.0f) : 0;
+		destination[i].Bits = Pack2101010(Normalise(vector[0], -1.0f, 511.0f), Normalise(vector[1], -1.0f, 511.0f),
+			Normalise(vector[2], -1.0f, 511.0f), w);
+	}
+#endif
+}
+
+float VertexQuantizer::ToFloat(Half value)
+{
+	unsigned int sign = (unsigned int)(value.Bits & 0x8000) << 16;
+	unsigned int exponent = (value.Bits >> 10) & 0x1F;
+	unsigned int mantissa = value.Bits & 0x3FF;
+
+	unsigned int bits;
+	if (exponent == 0x1F)
+	{
+		// Infinity or NaN
+		bits = 0x7F800000 | mantissa << 13;
+	}
+	else if (exponent == 0)
+	{
+		// Zero or subnormal, scaled by 2^-24 through the float unit
+		return BitsFloat(sign | FloatBits((float)mantissa * BitsFloat((127 - 24) << 23)));
+	}
+	else
+	{
+		bits = (exponent + 127 - 15) << 23 | mantissa << 13;
+	}
+	return BitsFloat(sign | bits);
+}
+
+void VertexQuantizer::Quantize(void * destination, const VertexBufferLayout & destinationLayout, const void * source,
+	const VertexBufferLayout & sourceLayout, unsigned int vertexCount)
+{
+	const auto& destinationElements = destinationLayout.GetElements();
+	const auto& sourceElements = sourceLayout.GetElements();
+	ASSERT(destinationElements.size() == sourceElements.size());
+
+	unsigned char* destinationBytes = (unsigned char*)destination;
+	const unsigned char* sourceBytes = (const unsigned char*)source;
+	unsigned int destinationStride = destinationLayout.GetStride();
+	unsigned int sourceStride = sourceLayout.GetStride();
+
+	// Each element is gathered into a tightly packed array, converted in one go and scattered back
+	std::vector<float> gathered;
+	std::vector<unsigned char> converted;
+	for (unsigned int e = 0; e < sourceElements.size(); e++)
+	{
+		const VertexBufferElement& from = sourceElements[e];
+		const VertexBufferElement& to = destinationElements[e];
+		ASSERT(from.type == GL_FLOAT);
+		ASSERT(from.count == to.count || to.type == GL_INT_2_10_10_10_REV);
+
+		unsigned int components = from.count;
+		unsigned int size = to.GetSize();
+		gathered.resize(s_ChunkVertices * components);
+		converted.resize(s_ChunkVertices * size);
+
+		for (unsigned int first = 0; first < vertexCount; first += s_ChunkVertices)
+		{
+			unsigned int count = std::min(s_ChunkVertices, vertexCount - first);
+			for (unsigned int v = 0; v < count; v++)
+			{
+				std::memcpy(&gathered[v * components], sourceBytes + (size_t)(first + v) * sourceStride + from.offset, components * sizeof(float));
+			}
+
+			unsigned int values = count * components;
+			switch (to.type)
+			{
+			case GL_FLOAT: std::memcpy(converted.data(), gathered.data(), values * sizeof(float)); break;
+			case GL_HALF_FLOAT: ToHalf((Half*)converted.data(), gathered.data(), values); break;
+			case GL_SHORT: ToSnorm16((short*)converted.data(), gathered.data(), values); break;
+			case GL_UNSIGNED_SHORT: ToUnorm16((unsigned short*)converted.data(), gathered.data(), values); break;
+			case GL_UNSIGNED_BYTE: ToUnorm8(converted.data(), gathered.data(), values); break;
+			case GL_INT_2_10_10_10_REV: ToPacked2101010((Packed2101010*)converted.data(), gathered.data(), count, components); break;
+			default:
+				// Not a format floats are quantised to
+				ASSERT(false);
+				return;
+			}
+
+			for (unsigned int v = 0; v < count; v++)
+			{
+				std::memcpy(destinationBytes + (size_t)(first + v) * destinationStride + to.offset, &converted[v * size], size);
+			}
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "VertexTypes.h"
+
+class VertexBufferLayout;
+
+/**
+ *	Converts float vertex data to the smaller formats VertexBufferLayout can Push, to save vertex
+ *	memory and bandwidth. Uses SSE2 on x86 and x64, converting four floats at a time.
+ *
+ *	Normalised formats clamp to their range first, -1 to 1 for signed and 0 to 1 for unsigned, and every
+ *	conversion rounds to nearest, so the SSE2 and plain C++ paths give the same result.
+ */
+class VertexQuantizer
+{
+public:
+	/**
+	 *	Converts to 16 bit floats. Values too large become infinity, too small ones become 0.
+	 */
+	static void ToHalf(Half* destination, const float* source, unsigned int count);
+
+	/**
+	 *	Converts to signed normalised 16 bit values, for Push<short>
+	 */
+	static void ToSnorm16(short* destination, const float* source, unsigned int count);
+
+	/**
+	 *	Converts to unsigned normalised 16 bit values, for Push<unsigned short>
+	 */
+	static void ToUnorm16(unsigned short* destination, const float* source, unsigned int count);
+
+	/**
+	 *	Converts to unsigned normalised 8 bit values, for Push<unsigned char>
+	 */
+	static void ToUnorm8(unsigned char* destination, const float* source, unsigned int count);
+
+	/**
+	 *	Packs vectors into GL_INT_2_10_10_10_REV
+	 *	@param source count vectors of components floats each
+	 *	@param components 3 to pack x, y, z with w = 0, or 4
+	 */
+	static void ToPacked2101010(Packed2101010* destination, const float* source, unsigned int count, unsigned int components);
+
+	/**
+	 *	@return the float a 16 bit float stands for
+	 */
+	static float ToFloat(Half value);
+
+	/**
+	 *	Converts whole vertices from a layout of floats to a layout with the same elements in smaller types,
+	 *	e.g. a float position, normal and UV to half position, packed normal and unsigned short UV.
+	 *	A Packed2101010 element may come from 3 or 4 floats, every other element needs the same count.
+	 *	@param destination vertexCount vertices of destinationLayout.GetStride() bytes
+	 *	@param source vertexCount vertices of sourceLayout.GetStride() bytes, every element GL_FLOAT
+	 */
+	static void Quantize(void* destination, const VertexBufferLayout& destinationLayout, const void* source,
+		const VertexBufferLayout& sourceLayout, unsigned int vertexCount);
+};
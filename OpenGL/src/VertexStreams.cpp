@@ -0,0 +1,47 @@
+#include "VertexStreams.h"
+
+#include <cstring>
+
+#include "Renderer.h"
+
+VertexStreamData VertexStreams::Extract(const void * vertices, unsigned int vertexCount, const VertexBufferLayout & layout,
+	unsigned int firstElement, unsigned int elementCount)
+{
+	const auto& elements = layout.GetElements();
+	ASSERT(elementCount > 0 && firstElement + elementCount <= elements.size());
+
+	VertexStreamData stream;
+	for (unsigned int i = firstElement; i < firstElement + elementCount; i++)
+	{
+		stream.Layout.PushElement(elements[i]);
+	}
+	stream.Layout.AlignStride(4);
+	stream.Layout.SetDivisor(layout.GetDivisor());
+
+	// Each element is copied from its own offset, the source may have padding between them or place
+	// them out of order (e.g. PushElement with an offset)
+	unsigned int stride = stream.Layout.GetStride();
+	const auto& streamElements = stream.Layout.GetElements();
+	stream.Data.resize((size_t)vertexCount * stride);
+	for (unsigned int v = 0; v < vertexCount; v++)
+	{
+		const unsigned char* source = (const unsigned char*)vertices + (size_t)v * layout.GetStride();
+		unsigned char* destination = &stream.Data[(size_t)v * stride];
+		for (unsigned int i = 0; i < elementCount; i++)
+		{
+			const VertexBufferElement& element = elements[firstElement + i];
+			std::memcpy(destination + streamElements[i].offset, source + element.offset, element.GetSize());
+		}
+	}
+	return stream;
+}
+
+std::vector<VertexStreamData> VertexStreams::Deinterleave(const void * vertices, unsigned int vertexCount, const VertexBufferLayout & layout)
+{
+	std::vector<VertexStreamData> streams;
+	for (unsigned int i = 0; i < layout.GetElements().size(); i++)
+	{
+		streams.push_back(Extract(vertices, vertexCount, layout, i, 1));
+	}
+	return streams;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "VertexBufferLayout.h"
+
+/**
+ *	Vertex data taken out of interleaved vertices, and the layout to read it with
+ */
+struct VertexStreamData
+{
+	std::vector<unsigned char> Data;
+	VertexBufferLayout Layout;
+};
+
+/**
+ *	Splits interleaved vertices into separate streams, each uploaded to a VertexBuffer of its own and
+ *	added to a VertexArray with its own AddBuffer call.
+ *
+ *	Attributes read by every pass, usually positions, are best kept in a tightly packed stream: depth and
+ *	shadow passes then use a vertex array with only that stream and fetch a fraction of the bytes.
+ */
+class VertexStreams
+{
+public:
+	/**
+	 *	Copies some consecutive elements of the layout into a stream of their own, wherever they are in each vertex
+	 *	@param vertices vertexCount vertices laid out as layout
+	 *	@param firstElement The index in layout of the first element to copy
+	 *	@param elementCount The number of elements to copy
+	 *	@return the elements packed together, the stride padded to 4 bytes
+	 */
+	static VertexStreamData Extract(const void* vertices, unsigned int vertexCount, const VertexBufferLayout& layout,
+		unsigned int firstElement, unsigned int elementCount);
+
+	/**
+	 *	Splits vertices into one stream per element
+	 */
+	static std::vector<VertexStreamData> Deinterleave(const void* vertices, unsigned int vertexCount, const VertexBufferLayout& layout);
+};
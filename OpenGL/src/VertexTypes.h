@@ -0,0 +1,18 @@
+#pragma once
+
+/**
+ *	A 16 bit float as stored in a vertex buffer, see VertexQuantizer to convert floats
+ */
+struct Half
+{
+	unsigned short Bits;
+};
+
+/**
+ *	Four signed normalised components packed into 32 bits as GL_INT_2_10_10_10_REV: x, y and z in
+ *	10 bits from the least significant end, and w in the top 2 bits. Precise enough for normals and tangents.
+ */
+struct Packed2101010
+{
+	unsigned int Bits;
+};